@@ -1,8 +1,172 @@
 #include "util/util.hpp"
+#include "archive_output.hpp"
 #include "dir.hpp"
+#include "model_export.hpp"
+#include "query_server.hpp"
+#include "search_index.hpp"
+#include "scheduler.hpp"
+#include "parse_cache.hpp"
 
+#include <atomic>
 #include <iostream>
+#include <fstream>
 #include <chrono>
+#include <cwchar>
+#include <thread>
+
+namespace {
+
+	// Everything given on the command line that applies to each project
+	struct options {
+		bool use_godot_cache = false;
+		std::size_t jobs = 0;
+		bool expand_instances = false;
+		bool reachability = false;
+		bool streaming = false;
+		bool search_index = true;
+		std::vector<std::wstring> entries;
+		std::vector<std::wstring> ignored_folders;
+		docs_gen_core::pipeline_config pipeline;
+		std::wstring socket_path;
+		std::wstring parse_cache_path;
+		std::size_t parallel_projects = 4;
+		docs_gen_core::output_format output = docs_gen_core::output_format::folder;
+		std::wstring export_path;
+		docs_gen_core::export_format export_format = docs_gen_core::export_format::jsonl;
+
+		void apply(docs_gen_core::dir& p) const {
+			p.set_use_godot_cache(use_godot_cache);
+			p.set_jobs(jobs);
+			p.set_expand_instances(expand_instances);
+			p.set_reachability(reachability);
+			p.set_streaming(streaming);
+			for (const auto& entry : entries) {
+				p.push_entry(entry);
+			}
+			p.set_ignored_folders(ignored_folders);
+			p.set_pipeline_config(pipeline);
+			p.set_output_format(output);
+			p.set_search_index(search_index);
+		}
+	};
+
+	void print_pipeline_stats(const docs_gen_core::dir& p) {
+		for (const auto& stage : p.get_pipeline_stats()) {
+			std::cout << "[INFO] stage " << stage.name << ": " << stage.workers << " workers, " << stage.items << " files, queue peak "
+				<< stage.queue_peak << ", starved " << std::chrono::duration<float>(stage.starved).count() << "s, blocked "
+				<< std::chrono::duration<float>(stage.blocked).count() << "s\n";
+		}
+	}
+
+	// One project root per line, relative roots are relative to the manifest, "-" reads stdin
+	bool read_manifest(const std::string& manifest, std::vector<std::filesystem::path>& roots) {
+		std::ifstream file;
+		if (manifest != "-") {
+			file.open(manifest);
+			if (!file) {
+				std::cerr << "[ERROR] could not read manifest: " << manifest << '\n';
+				return false;
+			}
+		}
+		auto& in = manifest == "-" ? std::cin : static_cast<std::istream&>(file);
+		const auto base = manifest == "-" ? std::filesystem::path{} : std::filesystem::path{ manifest }.parent_path();
+
+		std::string line;
+		while (std::getline(in, line)) {
+			while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) line.pop_back();
+			const auto first = line.find_first_not_of(" \t");
+			if (first == std::string::npos || line[first] == '#')
+				continue;
+			const std::filesystem::path root{ docs_gen_core::util::to_wstring(std::string_view{ line }.substr(first)) };
+			roots.push_back(root.is_absolute() ? root : base / root);
+		}
+		return true;
+	}
+
+	// Unpacks docs.bundle into a docs folder, next to the bundle unless a destination is given
+	int run_extract(const std::filesystem::path& bundle, std::filesystem::path destination) {
+		const docs_gen_core::bundle_reader reader{ bundle };
+		if (!reader.is_open()) {
+			std::cerr << "[ERROR] not a docs bundle: " << bundle << '\n';
+			return -1;
+		}
+		if (destination.empty()) {
+			destination = bundle;
+			destination.replace_extension();
+		}
+		const auto written = reader.extract(destination);
+		std::cout << "[INFO] Extracted " << written << " of " << reader.size() << " docs to " << destination << '\n';
+		return written == reader.size() ? 0 : -1;
+	}
+
+	// Looks terms up in search_index.json, given or found in a docs folder, and prints every
+	// doc matching all of them with the fields they matched in
+	int run_search(std::filesystem::path index, const std::vector<std::string>& terms) {
+		if (std::filesystem::is_directory(index)) {
+			index /= "search_index.json";
+		}
+		const docs_gen_core::search_index_reader reader{ index };
+		if (!reader.is_open()) {
+			std::cerr << "[ERROR] not a search index: " << index << '\n';
+			return -1;
+		}
+		for (const auto& hit : reader.find(terms)) {
+			std::cout << *hit.path << '\t' << docs_gen_core::search_index_reader::field_names(hit.fields) << '\n';
+		}
+		return 0;
+	}
+
+	// Documents every project in one process. A few projects run at a time and share one
+	// worker pool, so one project's serial steps overlap with the others' parsing, and one
+	// parse cache, so vendored scripts that are identical across projects are parsed once
+	int run_batch(const std::string& manifest, const options& opts) {
+		std::vector<std::filesystem::path> roots;
+		if (!read_manifest(manifest, roots))
+			return -1;
+
+		docs_gen_core::worker_pool pool{ opts.jobs };
+		docs_gen_core::parse_cache cache;
+		if (!opts.parse_cache_path.empty()) {
+			cache.set_directory(opts.parse_cache_path);
+		}
+		std::atomic<std::size_t> next{ 0 };
+		std::atomic<std::size_t> failed{ 0 };
+		const auto work = [&] {
+			for (auto i = next++; i < roots.size(); i = next++) {
+				const auto start = std::chrono::high_resolution_clock::now();
+				docs_gen_core::dir p;
+				opts.apply(p);
+				p.set_worker_pool(&pool);
+				p.set_parse_cache(&cache);
+				if (!p.set_path(roots[i].wstring())) {
+					std::cerr << "[ERROR] invalid path: " << roots[i] << '\n';
+					++failed;
+					continue;
+				}
+
+				p.construct_file_tree();
+				p.gen_docs();
+				const auto took = std::chrono::high_resolution_clock::now() - start;
+				std::cout << "[INFO] Documented " << roots[i] << " in " << std::chrono::duration<float>(took).count() << " seconds\n";
+			}
+		};
+
+		std::vector<std::thread> threads;
+		const auto count = std::max<std::size_t>(1, std::min(opts.parallel_projects, roots.size()));
+		for (std::size_t i = 1; i < count; ++i) {
+			threads.emplace_back(work);
+		}
+		work();
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		std::cout << "[INFO] Batch of " << roots.size() << " projects, " << failed << " failed, " << cache.get_hits()
+			<< " files taken from the parse cache, " << cache.get_misses() << " parsed\n";
+		return failed == 0 ? 0 : -1;
+	}
+
+} // anonymous
 
 int main(int argc, char** argv) {
 	const auto start = std::chrono::high_resolution_clock::now();
@@ -10,28 +174,189 @@ int main(int argc, char** argv) {
 
 	const auto path = docs_gen_core::util::next_arg(&argc, &argv);
 	if (path == nullptr) {
-		std::cerr << "[USAGE] <program> <root of the project>\n";
+		std::cerr << "[USAGE] <program> <root of the project | --batch=manifest> [--godot-cache] [--jobs=n] [--expand-instances] [--entry=res://path...] [--reachability] [--serve=socket] [--stream] [--workers=read,parse,render,write] [--queue-depth=n] [--parallel-projects=n] [--parse-cache=dir] [--output=folder|bundle|tar] [--export=file] [--export-format=jsonl|binary] [--no-search-index] [ignored folders...]\n"
+			<< "[USAGE] <program> --extract=docs.bundle [destination]\n"
+			<< "[USAGE] <program> --search=<docs folder | search_index.json> [field:]term[*]...\n";
 		return -1;
 	}
 
-	docs_gen_core::dir p;
+	if (std::string_view{ path }.rfind("--search=", 0) == 0) {
+		std::vector<std::string> terms;
+		for (char* term; (term = docs_gen_core::util::next_arg(&argc, &argv)) != nullptr;) {
+			terms.emplace_back(term);
+		}
+		return run_search(docs_gen_core::util::to_wstring(path + 9), terms);
+	}
+
+	if (std::string_view{ path }.rfind("--extract=", 0) == 0) {
+		const auto destination = docs_gen_core::util::next_arg(&argc, &argv);
+		return run_extract(docs_gen_core::util::to_wstring(path + 10),
+			destination != nullptr ? std::filesystem::path{ docs_gen_core::util::to_wstring(destination) } : std::filesystem::path{});
+	}
+
+	options opts;
 	char* arg;
 	while ((arg = docs_gen_core::util::next_arg(&argc, &argv)) != nullptr) {
 		auto str = docs_gen_core::util::to_wstring(arg);
+		if (str == L"--godot-cache") {
+			opts.use_godot_cache = true;
+			continue;
+		}
+
+		if (str.rfind(L"--jobs=", 0) == 0) {
+			opts.jobs = std::wcstoul(str.c_str() + 7, nullptr, 10);
+			continue;
+		}
+
+		if (str == L"--expand-instances") {
+			opts.expand_instances = true;
+			continue;
+		}
+
+		if (str.rfind(L"--entry=", 0) == 0) {
+			opts.entries.push_back(str.substr(8));
+			continue;
+		}
+
+		if (str == L"--entry") {
+			if (const auto entry = docs_gen_core::util::next_arg(&argc, &argv); entry != nullptr) {
+				opts.entries.push_back(docs_gen_core::util::to_wstring(entry));
+			}
+			continue;
+		}
+
+		if (str.rfind(L"--serve=", 0) == 0) {
+			opts.socket_path = str.substr(8);
+			continue;
+		}
+
+		if (str == L"--reachability") {
+			opts.reachability = true;
+			continue;
+		}
+
+		if (str == L"--no-search-index") {
+			opts.search_index = false;
+			continue;
+		}
+
+		if (str == L"--stream") {
+			opts.streaming = true;
+			continue;
+		}
+
+		if (str.rfind(L"--workers=", 0) == 0) {
+			std::vector<std::wstring> counts;
+			docs_gen_core::util::split_by(str.substr(10), ',', counts);
+			std::size_t* stages[] = { &opts.pipeline.read_workers, &opts.pipeline.parse_workers, &opts.pipeline.render_workers, &opts.pipeline.write_workers };
+			for (std::size_t i = 0; i < counts.size() && i < 4; ++i) {
+				*stages[i] = std::wcstoul(counts[i].c_str(), nullptr, 10);
+			}
+			continue;
+		}
+
+		if (str.rfind(L"--queue-depth=", 0) == 0) {
+			opts.pipeline.queue_depth = std::wcstoul(str.c_str() + 14, nullptr, 10);
+			continue;
+		}
+
+		if (str.rfind(L"--parallel-projects=", 0) == 0) {
+			opts.parallel_projects = std::wcstoul(str.c_str() + 20, nullptr, 10);
+			continue;
+		}
+
+		if (str.rfind(L"--parse-cache=", 0) == 0) {
+			opts.parse_cache_path = str.substr(14);
+			continue;
+		}
+
+		if (str.rfind(L"--output=", 0) == 0) {
+			const auto format = str.substr(9);
+			if (format == L"folder") {
+				opts.output = docs_gen_core::output_format::folder;
+			}
+			else if (format == L"bundle") {
+				opts.output = docs_gen_core::output_format::bundle;
+			}
+			else if (format == L"tar") {
+				opts.output = docs_gen_core::output_format::tar;
+			}
+			else {
+				std::cerr << "[ERROR] unknown output format: " << docs_gen_core::util::to_string(format) << '\n';
+				return -1;
+			}
+			continue;
+		}
+
+		if (str.rfind(L"--export=", 0) == 0) {
+			opts.export_path = str.substr(9);
+			continue;
+		}
+
+		if (str.rfind(L"--export-format=", 0) == 0) {
+			const auto format = str.substr(16);
+			if (format == L"jsonl") {
+				opts.export_format = docs_gen_core::export_format::jsonl;
+			}
+			else if (format == L"binary") {
+				opts.export_format = docs_gen_core::export_format::binary;
+			}
+			else {
+				std::cerr << "[ERROR] unknown export format: " << docs_gen_core::util::to_string(format) << '\n';
+				return -1;
+			}
+			continue;
+		}
+
 		if (str.front() == '"' && str.back() == '"') {
 			str = str.substr(1, str.size() - 2);
 		}
-		p.push_ignored_folder(str);
+		opts.ignored_folders.push_back(str);
 	}
 
+	if (std::string_view{ path }.rfind("--batch=", 0) == 0) {
+		if (!opts.socket_path.empty() || !opts.export_path.empty()) {
+			std::cerr << "[ERROR] " << (opts.socket_path.empty() ? "--export" : "--serve") << " needs a single project\n";
+			return -1;
+		}
+		const auto result = run_batch(path + 8, opts);
+		const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - start);
+		std::cout << "Time took " << static_cast<float>(duration.count()) / 1000000000.0f << " seconds\n";
+		return result;
+	}
+
+	docs_gen_core::dir p;
+	docs_gen_core::parse_cache cache;
+	opts.apply(p);
+	if (!opts.parse_cache_path.empty() && cache.set_directory(opts.parse_cache_path)) {
+		p.set_parse_cache(&cache);
+	}
 	if (!p.set_path(docs_gen_core::util::to_wstring(path))) {
-		std::cerr << "[ERROR] invalid path: " << arg << '\n';
+		std::cerr << "[ERROR] invalid path: " << path << '\n';
 		return -1;
 	}
 
+	if (!opts.socket_path.empty() || !opts.export_path.empty()) {
+		// the model has to stay in memory, so streaming does not apply
+		p.set_streaming(false);
+	}
 	p.construct_file_tree();
+	if (!opts.socket_path.empty()) {
+		p.build_index();
+		docs_gen_core::query_server server{ p, opts.socket_path };
+		return server.run() ? 0 : -1;
+	}
 	p.gen_docs();
-	
+	print_pipeline_stats(p);
+	if (!opts.export_path.empty()) {
+		const auto view = p.view();
+		if (!docs_gen_core::model_exporter{ view }.write(opts.export_path, opts.export_format))
+			return -1;
+	}
+	if (cache.on_disk()) {
+		std::cout << "[INFO] Parse cache: " << cache.get_hits() << " files reused, " << cache.get_misses() << " parsed\n";
+	}
+
 	auto stop = std::chrono::high_resolution_clock::now();
 	auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start);
 	std::cout << "Time took " << static_cast<float>(duration.count()) / 1000000000.0f << " seconds\n";
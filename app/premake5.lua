@@ -20,6 +20,10 @@ project "App"
         defines { "WIN" }
     filter {}
 
+    filter { "system:linux" }
+        links { "pthread" }
+    filter {}
+
     filter { "configurations:Debug" }
         defines { "DEBUG" }
         symbols "On"
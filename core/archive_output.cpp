@@ -0,0 +1,400 @@
+#include "archive_output.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+namespace docs_gen_core {
+
+	namespace {
+
+		constexpr std::string_view bundle_magic = "GDDB";
+		// magic and index offset
+		constexpr std::size_t bundle_footer_size = 8 + 4;
+		constexpr std::size_t tar_block = 512;
+		constexpr std::size_t write_buffer_size = 1 << 20;
+
+		void put_u32(std::ostream& out, std::uint32_t v) {
+			char b[4];
+			for (int i = 0; i < 4; ++i) b[i] = static_cast<char>(v >> (i * 8));
+			out.write(b, 4);
+		}
+
+		void put_u64(std::ostream& out, std::uint64_t v) {
+			char b[8];
+			for (int i = 0; i < 8; ++i) b[i] = static_cast<char>(v >> (i * 8));
+			out.write(b, 8);
+		}
+
+		bool get_u32(std::string_view in, std::size_t& pos, std::uint32_t& v) {
+			if (pos > in.size() || in.size() - pos < 4) return false;
+			v = 0;
+			for (int i = 0; i < 4; ++i) v |= static_cast<std::uint32_t>(static_cast<unsigned char>(in[pos + i])) << (i * 8);
+			pos += 4;
+			return true;
+		}
+
+		bool get_u64(std::string_view in, std::size_t& pos, std::uint64_t& v) {
+			if (pos > in.size() || in.size() - pos < 8) return false;
+			v = 0;
+			for (int i = 0; i < 8; ++i) v |= static_cast<std::uint64_t>(static_cast<unsigned char>(in[pos + i])) << (i * 8);
+			pos += 8;
+			return true;
+		}
+
+		std::filesystem::path sibling(const std::filesystem::path& root, const char* extension) {
+			auto path = root;
+			path += extension;
+			return path;
+		}
+
+		// Opens temp with a large buffer, so docs reach the disk in few big writes
+		bool open_buffered(std::ofstream& out, std::vector<char>& buffer, const std::filesystem::path& path) {
+			buffer.resize(write_buffer_size);
+			out.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			out.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (out)
+				return true;
+
+			std::cerr << "[ERROR] could not open " << path << " for writing\n";
+			return false;
+		}
+
+		bool close_and_rename(std::ofstream& out, const std::filesystem::path& temp, const std::filesystem::path& path) {
+			out.close();
+			std::error_code ec;
+			if (out) {
+				std::filesystem::rename(temp, path, ec);
+				if (!ec)
+					return true;
+			}
+
+			std::cerr << "[ERROR] could not write " << path << '\n';
+			std::filesystem::remove(temp, ec);
+			return false;
+		}
+
+	} // anonymous
+
+	bundle_output::bundle_output(const std::filesystem::path& root)
+		: doc_output(root), path_(sibling(root, ".bundle")) {
+	}
+
+	bool bundle_output::begin() {
+		if (!open_buffered(out_, buffer_, sibling(path_, ".tmp")))
+			return false;
+
+		out_.write(bundle_magic.data(), bundle_magic.size());
+		put_u32(out_, format_version);
+		size_ = bundle_magic.size() + 4;
+		return true;
+	}
+
+	void bundle_output::write(const std::filesystem::path& path, std::string_view body, std::string_view tail) {
+		auto key = key_of(path);
+		std::lock_guard lock{ mutex_ };
+		const entry e{ append(body), body.size(), append(tail), tail.size() };
+		if (const auto [it, inserted] = index_of_.try_emplace(key, static_cast<std::uint32_t>(entries_.size())); !inserted) {
+			entries_[it->second].second = e;
+			return;
+		}
+		entries_.emplace_back(std::move(key), e);
+	}
+
+	void bundle_output::write_body(const std::filesystem::path& path, std::string_view body) {
+		write(path, body);
+	}
+
+	void bundle_output::append_tail(const std::filesystem::path& path, std::string_view tail) {
+		const auto key = key_of(path);
+		std::lock_guard lock{ mutex_ };
+		const auto it = index_of_.find(key);
+		if (it == index_of_.end())
+			return;
+
+		auto& e = entries_[it->second].second;
+		e.tail_offset = append(tail);
+		e.tail_size = tail.size();
+	}
+
+	void bundle_output::finish() {
+		const auto index_offset = size_;
+		put_u32(out_, static_cast<std::uint32_t>(entries_.size()));
+		for (const auto& [key, e] : entries_) {
+			put_u32(out_, static_cast<std::uint32_t>(key.size()));
+			out_.write(key.data(), static_cast<std::streamsize>(key.size()));
+			put_u64(out_, e.body_offset);
+			put_u64(out_, e.body_size);
+			put_u64(out_, e.tail_offset);
+			put_u64(out_, e.tail_size);
+		}
+		put_u64(out_, index_offset);
+		out_.write(bundle_magic.data(), bundle_magic.size());
+
+		if (close_and_rename(out_, sibling(path_, ".tmp"), path_)) {
+			std::cout << "[INFO] Wrote " << entries_.size() << " docs to " << path_ << '\n';
+		}
+	}
+
+	std::uint64_t bundle_output::append(std::string_view s) {
+		const auto offset = size_;
+		out_.write(s.data(), static_cast<std::streamsize>(s.size()));
+		size_ += s.size();
+		return offset;
+	}
+
+	tar_output::tar_output(const std::filesystem::path& root)
+		: doc_output(root), path_(sibling(root, ".tar")) {
+	}
+
+	bool tar_output::begin() {
+		time_ = static_cast<std::int64_t>(std::time(nullptr));
+		return open_buffered(out_, buffer_, sibling(path_, ".tmp"));
+	}
+
+	void tar_output::write(const std::filesystem::path& path, std::string_view body, std::string_view tail) {
+		const auto key = key_of(path);
+		std::lock_guard lock{ mutex_ };
+		write_entry(key, body, tail);
+	}
+
+	void tar_output::write_body(const std::filesystem::path& path, std::string_view body) {
+		const auto key = key_of(path);
+		std::lock_guard lock{ mutex_ };
+		if (!spill(key, body)) {
+			// without a spill file the doc goes out without its tail
+			write_entry(key, body, {});
+		}
+	}
+
+	void tar_output::append_tail(const std::filesystem::path& path, std::string_view tail) {
+		const auto key = key_of(path);
+		std::lock_guard lock{ mutex_ };
+		const auto it = pending_.find(key);
+		if (it == pending_.end())
+			return;
+
+		if (unspill(it->second)) {
+			write_entry(key, scratch_, tail);
+		}
+		pending_.erase(key);
+	}
+
+	void tar_output::finish() {
+		for (const auto& [key, s] : pending_) {
+			if (unspill(s)) {
+				write_entry(key, scratch_, {});
+			}
+		}
+		pending_ = {};
+		scratch_ = {};
+		if (spill_.is_open()) {
+			spill_.close();
+			std::error_code ec;
+			std::filesystem::remove(sibling(path_, ".bodies"), ec);
+		}
+
+		// the end of the archive is two empty blocks
+		const char zeros[tar_block * 2] = {};
+		out_.write(zeros, sizeof(zeros));
+		if (close_and_rename(out_, sibling(path_, ".tmp"), path_)) {
+			std::cout << "[INFO] Wrote " << count_ << " docs to " << path_ << '\n';
+		}
+	}
+
+	void tar_output::write_entry(const std::string& name, std::string_view body, std::string_view tail) {
+		const auto size = body.size() + tail.size();
+		write_header(name, size, '0');
+		out_.write(body.data(), static_cast<std::streamsize>(body.size()));
+		out_.write(tail.data(), static_cast<std::streamsize>(tail.size()));
+		const char zeros[tar_block] = {};
+		out_.write(zeros, static_cast<std::streamsize>((tar_block - size % tar_block) % tar_block));
+		++count_;
+	}
+
+	bool tar_output::spill(const std::string& name, std::string_view body) {
+		if (!spill_.is_open()) {
+			spill_.open(sibling(path_, ".bodies"), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!spill_) {
+				std::cerr << "[ERROR] could not open " << sibling(path_, ".bodies") << " for writing\n";
+				return false;
+			}
+		}
+
+		// reads move the shared file position, writes always go to the end
+		spill_.seekp(static_cast<std::streamoff>(spill_size_));
+		spill_.write(body.data(), static_cast<std::streamsize>(body.size()));
+		if (!spill_) {
+			std::cerr << "[ERROR] could not write " << sibling(path_, ".bodies") << '\n';
+			spill_.clear();
+			return false;
+		}
+
+		pending_[name] = spilled{ spill_size_, body.size() };
+		spill_size_ += body.size();
+		return true;
+	}
+
+	bool tar_output::unspill(const spilled& s) {
+		scratch_.resize(s.size);
+		spill_.seekg(static_cast<std::streamoff>(s.offset));
+		spill_.read(scratch_.data(), static_cast<std::streamsize>(s.size));
+		if (spill_)
+			return true;
+
+		std::cerr << "[ERROR] could not read back " << sibling(path_, ".bodies") << '\n';
+		spill_.clear();
+		return false;
+	}
+
+	void tar_output::write_header(std::string_view name, std::uint64_t size, char type) {
+		// a name longer than 100 bytes is split into prefix and name at a '/', one that cannot be
+		// split goes into a pax record ahead of the entry
+		std::string_view prefix;
+		if (name.size() > 100) {
+			const auto slash = name.rfind('/', 155);
+			if (slash != std::string_view::npos && slash > 0 && name.size() - slash - 1 <= 100 && name.size() - slash - 1 > 0) {
+				prefix = name.substr(0, slash);
+				name.remove_prefix(slash + 1);
+			}
+			else if (type != 'x') {
+				// "<length> path=<name>\n", where the length counts its own digits
+				const auto body = " path=" + std::string{ name } + '\n';
+				auto length = body.size() + 1;
+				while (std::to_string(length).size() + body.size() != length) ++length;
+				const auto record = std::to_string(length) + body;
+				write_header("././@PaxHeader", record.size(), 'x');
+				out_.write(record.data(), static_cast<std::streamsize>(record.size()));
+				const char zeros[tar_block] = {};
+				out_.write(zeros, static_cast<std::streamsize>((tar_block - record.size() % tar_block) % tar_block));
+				name = name.substr(0, 100);
+			}
+		}
+
+		char h[tar_block] = {};
+		std::memcpy(h, name.data(), std::min<std::size_t>(name.size(), 100));
+		std::snprintf(h + 100, 8, "%07o", 0644u);
+		std::snprintf(h + 108, 8, "%07o", 0u);
+		std::snprintf(h + 116, 8, "%07o", 0u);
+		std::snprintf(h + 124, 12, "%011llo", static_cast<unsigned long long>(size));
+		std::snprintf(h + 136, 12, "%011llo", static_cast<unsigned long long>(time_));
+		std::memset(h + 148, ' ', 8);
+		h[156] = type;
+		std::memcpy(h + 257, "ustar", 6);
+		std::memcpy(h + 263, "00", 2);
+		std::memcpy(h + 345, prefix.data(), std::min<std::size_t>(prefix.size(), 155));
+
+		unsigned checksum = 0;
+		for (const auto c : h) checksum += static_cast<unsigned char>(c);
+		std::snprintf(h + 148, 7, "%06o", checksum);
+		h[155] = ' ';
+		out_.write(h, tar_block);
+	}
+
+	bundle_reader::bundle_reader(const std::filesystem::path& path)
+		: mapping_(path) {
+		if (!mapping_.is_open())
+			return;
+
+		const auto data = mapping_.view();
+		const auto header_size = bundle_magic.size() + 4;
+		if (data.size() < header_size + 4 + bundle_footer_size || data.substr(0, 4) != bundle_magic
+			|| data.substr(data.size() - 4) != bundle_magic)
+			return;
+
+		std::size_t pos = 4;
+		std::uint32_t version;
+		std::uint64_t index_offset;
+		get_u32(data, pos, version);
+		pos = data.size() - bundle_footer_size;
+		get_u64(data, pos, index_offset);
+		if (version != bundle_output::format_version || index_offset < header_size || index_offset > data.size() - bundle_footer_size)
+			return;
+
+		// every range is checked once here, reads trust them afterwards
+		const auto index = data.substr(0, data.size() - bundle_footer_size);
+		pos = static_cast<std::size_t>(index_offset);
+		std::uint32_t count;
+		if (!get_u32(index, pos, count))
+			return;
+		for (std::uint32_t i = 0; i < count; ++i) {
+			std::uint32_t length;
+			entry e;
+			if (!get_u32(index, pos, length) || index.size() - pos < length)
+				return;
+			std::string key{ index.substr(pos, length) };
+			pos += length;
+			if (!get_u64(index, pos, e.body_offset) || !get_u64(index, pos, e.body_size)
+				|| !get_u64(index, pos, e.tail_offset) || !get_u64(index, pos, e.tail_size)
+				|| e.body_offset > index_offset || e.body_size > index_offset - e.body_offset
+				|| e.tail_offset > index_offset || e.tail_size > index_offset - e.tail_offset)
+				return;
+			index_of_[key] = static_cast<std::uint32_t>(entries_.size());
+			entries_.emplace_back(std::move(key), e);
+		}
+		valid_ = pos == index.size();
+	}
+
+	bool bundle_reader::read(std::string_view path, std::string& out) const {
+		const auto it = index_of_.find(std::string{ path });
+		if (!valid_ || it == index_of_.end())
+			return false;
+
+		read(entries_[it->second].second, out);
+		return true;
+	}
+
+	std::size_t bundle_reader::extract(const std::filesystem::path& destination) const {
+		if (!valid_)
+			return 0;
+
+		// keys come from the file, a forged one must not reach outside destination
+		std::vector<std::filesystem::path> paths;
+		std::vector<const entry*> docs;
+		paths.reserve(entries_.size());
+		docs.reserve(entries_.size());
+		for (const auto& [key, e] : entries_) {
+			const auto relative = std::filesystem::u8path(key).lexically_normal();
+			bool unsafe = relative.empty() || relative.is_absolute() || relative.has_root_name() || relative.has_root_directory();
+			for (auto it = relative.begin(); !unsafe && it != relative.end(); ++it) {
+				unsafe = *it == "..";
+			}
+			if (unsafe) {
+				std::cerr << "[ERROR] skipping doc outside the destination: " << key << '\n';
+				continue;
+			}
+			paths.push_back(destination / relative);
+			docs.push_back(&e);
+		}
+		std::error_code ec;
+		std::filesystem::create_directories(destination, ec);
+		create_folders(destination, paths);
+
+		std::size_t count = 0;
+		std::string doc;
+		for (std::size_t i = 0; i < paths.size(); ++i) {
+			const auto& path = paths[i];
+			read(*docs[i], doc);
+			std::ofstream out{ path, std::ios::out | std::ios::binary };
+			out.write(doc.data(), static_cast<std::streamsize>(doc.size()));
+			if (out) {
+				++count;
+			}
+#ifndef RELEASE
+			else {
+				std::cerr << "[WARNING] could not write " << path << '\n';
+			}
+#endif
+		}
+		return count;
+	}
+
+	void bundle_reader::read(const entry& e, std::string& out) const {
+		const auto data = mapping_.view();
+		out.assign(data.substr(e.body_offset, e.body_size));
+		out.append(data.substr(e.tail_offset, e.tail_size));
+	}
+
+} // docs_gen_core
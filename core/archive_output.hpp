@@ -0,0 +1,138 @@
+#ifndef DOCS_GEN_ARCHIVE_OUTPUT_H
+#define DOCS_GEN_ARCHIVE_OUTPUT_H
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "doc_output.hpp"
+#include "vfs.hpp"
+#include "util/flat_map.hpp"
+
+namespace docs_gen_core {
+
+	// Every doc appended to one file, docs.bundle next to the docs folder, so a run does a few
+	// large sequential writes instead of a folder walk, an open and a close per doc.
+	//
+	// Layout: "GDDB", format version (u32), the docs' bytes, then the index: doc count (u32) and
+	// per doc its path length (u32), path (UTF-8, relative to the docs folder), body offset and
+	// size and tail offset and size (u64 each), closed by the index offset (u64) and "GDDB".
+	// Integers are little endian. A doc's body and tail may be apart, docs are the two joined.
+	// The bundle is written under a temporary name and renamed when done
+	class bundle_output final : public doc_output {
+		struct entry {
+			std::uint64_t body_offset;
+			std::uint64_t body_size;
+			std::uint64_t tail_offset;
+			std::uint64_t tail_size;
+		};
+
+		std::filesystem::path path_;
+		std::mutex mutex_;
+		std::vector<char> buffer_;
+		std::ofstream out_;
+		std::uint64_t size_ = 0;
+		util::flat_map<std::string, std::uint32_t> index_of_;
+		std::vector<std::pair<std::string, entry>> entries_;
+
+	public:
+		static constexpr std::uint32_t format_version = 1;
+
+		explicit bundle_output(const std::filesystem::path& root);
+
+		bool begin() override;
+		void write(const std::filesystem::path& path, std::string_view body, std::string_view tail = {}) override;
+		void write_body(const std::filesystem::path& path, std::string_view body) override;
+		void append_tail(const std::filesystem::path& path, std::string_view tail) override;
+		void finish() override;
+
+	private:
+		// mutex_ must be held, returns the offset of s
+		std::uint64_t append(std::string_view s);
+	};
+
+	// Every doc in one POSIX (ustar) tar archive, docs.tar next to the docs folder, readable by
+	// any tar. Paths that do not fit the ustar header get a pax header. A tar entry cannot grow
+	// once the next one follows, so in streaming mode bodies are spilled to docs.tar.bodies and
+	// copied into the archive once their tails arrive, keeping only their offsets in memory
+	class tar_output final : public doc_output {
+		struct spilled {
+			std::uint64_t offset;
+			std::uint64_t size;
+		};
+
+		std::filesystem::path path_;
+		std::mutex mutex_;
+		std::vector<char> buffer_;
+		std::ofstream out_;
+		std::int64_t time_ = 0;
+		std::fstream spill_;
+		std::uint64_t spill_size_ = 0;
+		std::string scratch_;
+		util::flat_map<std::string, spilled> pending_;
+		std::size_t count_ = 0;
+
+	public:
+		explicit tar_output(const std::filesystem::path& root);
+
+		bool begin() override;
+		void write(const std::filesystem::path& path, std::string_view body, std::string_view tail = {}) override;
+		void write_body(const std::filesystem::path& path, std::string_view body) override;
+		void append_tail(const std::filesystem::path& path, std::string_view tail) override;
+		void finish() override;
+
+	private:
+		// mutex_ must be held
+		void write_entry(const std::string& name, std::string_view body, std::string_view tail);
+		// mutex_ must be held, false if the spill file cannot be opened or written
+		bool spill(const std::string& name, std::string_view body);
+		// mutex_ must be held, reads a spilled body into scratch_
+		bool unspill(const spilled& s);
+		void write_header(std::string_view name, std::uint64_t size, char type);
+	};
+
+	// Reads docs back out of a bundle written by bundle_output
+	class bundle_reader {
+		struct entry {
+			std::uint64_t body_offset;
+			std::uint64_t body_size;
+			std::uint64_t tail_offset;
+			std::uint64_t tail_size;
+		};
+
+		mapped_file mapping_;
+		bool valid_ = false;
+		util::flat_map<std::string, std::uint32_t> index_of_;
+		std::vector<std::pair<std::string, entry>> entries_;
+
+	public:
+		explicit bundle_reader(const std::filesystem::path& path);
+		bundle_reader(const bundle_reader& other) = delete;
+		bundle_reader(bundle_reader&& other) = delete;
+		~bundle_reader() = default;
+
+		bundle_reader& operator=(const bundle_reader& other) = delete;
+		bundle_reader& operator=(bundle_reader&& other) = delete;
+
+		[[nodiscard]] bool is_open() const { return valid_; }
+		[[nodiscard]] std::size_t size() const { return entries_.size(); }
+		// Relative path of the i-th doc, in the order they were written
+		[[nodiscard]] const std::string& path_at(std::size_t i) const { return entries_[i].first; }
+
+		// false if the bundle has no doc at that path (relative, with '/')
+		bool read(std::string_view path, std::string& out) const;
+		// Writes every doc below destination, returns how many were written
+		std::size_t extract(const std::filesystem::path& destination) const;
+
+	private:
+		void read(const entry& e, std::string& out) const;
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_ARCHIVE_OUTPUT_H
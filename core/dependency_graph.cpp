@@ -0,0 +1,81 @@
+#include "dependency_graph.hpp"
+
+#include <algorithm>
+
+namespace docs_gen_core {
+
+	void dependency_graph::build(const project& project) {
+		reset(project);
+		const auto n = static_cast<std::uint32_t>(size());
+		build_([&](auto&& emit) {
+			for (std::uint32_t source = 0; source < n; ++source) {
+				for_each_dependency(project, ref_of(source), [&](file_ref target) {
+					if (const auto t = id_of(target); t < n && t != source) emit(source, t);
+				});
+			}
+		});
+	}
+
+	void dependency_graph::build(const project& project, const std::vector<std::vector<file_ref>>& dependencies) {
+		reset(project);
+		const auto n = static_cast<std::uint32_t>(std::min<std::size_t>(size(), dependencies.size()));
+		build_([&](auto&& emit) {
+			for (std::uint32_t source = 0; source < n; ++source) {
+				for (const auto target : dependencies[source]) {
+					if (const auto t = id_of(target); t < size() && t != source) emit(source, t);
+				}
+			}
+		});
+	}
+
+	std::uint32_t dependency_graph::id_of(file_ref ref) const {
+		switch (ref.kind) {
+		case file_kind::scene:
+			return ref.index < scene_count_ ? ref.index : handle<file>::invalid;
+		case file_kind::resource:
+			return ref.index < resource_count_ ? scene_count_ + ref.index : handle<file>::invalid;
+		case file_kind::script:
+			return ref.index < script_count_ ? scene_count_ + resource_count_ + ref.index : handle<file>::invalid;
+		default:
+			return handle<file>::invalid;
+		}
+	}
+
+	std::uint32_t dependency_graph::id_of(const project& project, file_ref ref) {
+		dependency_graph g;
+		g.scene_count_ = static_cast<std::uint32_t>(project.get_scenes().size());
+		g.resource_count_ = static_cast<std::uint32_t>(project.get_resources().size());
+		g.script_count_ = static_cast<std::uint32_t>(project.get_scripts().size());
+		return g.id_of(ref);
+	}
+
+	file_ref dependency_graph::ref_of(std::uint32_t id) const {
+		if (id < scene_count_)
+			return scene_handle{ id };
+		id -= scene_count_;
+		if (id < resource_count_)
+			return resource_handle{ id };
+		id -= resource_count_;
+		if (id < script_count_)
+			return script_handle{ id };
+		return {};
+	}
+
+	dependency_graph::users dependency_graph::users_of(file_ref ref) const {
+		const auto id = id_of(ref);
+		if (id >= size())
+			return { nullptr, nullptr };
+		return { sources_.data() + offsets_[id], sources_.data() + offsets_[id + 1] };
+	}
+
+	void dependency_graph::reset(const project& project) {
+		scene_count_ = static_cast<std::uint32_t>(project.get_scenes().size());
+		resource_count_ = static_cast<std::uint32_t>(project.get_resources().size());
+		script_count_ = static_cast<std::uint32_t>(project.get_scripts().size());
+		offsets_.assign(static_cast<std::size_t>(scene_count_) + resource_count_ + script_count_ + 1, 0);
+		sources_.clear();
+		target_offsets_.assign(offsets_.size(), 0);
+		targets_.clear();
+	}
+
+} // docs_gen_core
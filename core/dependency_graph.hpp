@@ -0,0 +1,157 @@
+#ifndef DOCS_GEN_DEPENDENCY_GRAPH_H
+#define DOCS_GEN_DEPENDENCY_GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "handle.hpp"
+#include "project.hpp"
+
+namespace docs_gen_core {
+
+	// Reverse dependencies of every file in a project ("which files use this one") as a
+	// compressed sparse row graph. Files get dense ids, scenes first, then resources, then
+	// scripts; the users of id i are sources_[offsets_[i], offsets_[i + 1]), sorted by id and
+	// without duplicates. The forward links are kept the same way for traversals from a file.
+	// Building is two passes over the forward edges plus one over the result, so it is linear in
+	// the number of edges
+	class dependency_graph {
+		std::uint32_t scene_count_ = 0;
+		std::uint32_t resource_count_ = 0;
+		std::uint32_t script_count_ = 0;
+		std::vector<std::uint32_t> offsets_;
+		std::vector<std::uint32_t> sources_;
+		// forward links of id i are targets_[target_offsets_[i], target_offsets_[i + 1])
+		std::vector<std::uint32_t> target_offsets_;
+		std::vector<std::uint32_t> targets_;
+
+	public:
+		// ids of the files using or used by one file
+		class users {
+			const std::uint32_t* begin_;
+			const std::uint32_t* end_;
+
+		public:
+			users(const std::uint32_t* begin, const std::uint32_t* end) : begin_(begin), end_(end) {}
+
+			[[nodiscard]] const std::uint32_t* begin() const { return begin_; }
+			[[nodiscard]] const std::uint32_t* end() const { return end_; }
+			[[nodiscard]] std::size_t size() const { return static_cast<std::size_t>(end_ - begin_); }
+			[[nodiscard]] bool empty() const { return begin_ == end_; }
+		};
+
+		dependency_graph() = default;
+
+		// Builds from the files' own links, every file of the project must still have its contents
+		void build(const project& project);
+		// Builds from links saved per file id beforehand, for when the models are already released
+		void build(const project& project, const std::vector<std::vector<file_ref>>& dependencies);
+
+		// Calls fn(file_ref) for every file the given one links to: instanced scenes, scripts and
+		// resources of scenes and resources, and the parent class of a script. May repeat targets
+		template <typename Fn>
+		static void for_each_dependency(const project& project, file_ref source, Fn&& fn);
+
+		[[nodiscard]] std::size_t size() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+		[[nodiscard]] std::size_t edge_count() const { return sources_.size(); }
+
+		[[nodiscard]] std::uint32_t id_of(file_ref ref) const;
+		// The id ref gets in a graph built over project, usable before building
+		[[nodiscard]] static std::uint32_t id_of(const project& project, file_ref ref);
+		[[nodiscard]] file_ref ref_of(std::uint32_t id) const;
+		// empty for files the graph does not know
+		[[nodiscard]] users users_of(file_ref ref) const;
+		// ids of the files id links to, may repeat targets
+		[[nodiscard]] users dependencies_of(std::uint32_t id) const {
+			return { targets_.data() + target_offsets_[id], targets_.data() + target_offsets_[id + 1] };
+		}
+
+	private:
+		void reset(const project& project);
+		template <typename Forward>
+		void build_(Forward&& forward);
+	};
+
+	template <typename Fn>
+	void dependency_graph::for_each_dependency(const project& project, file_ref source, Fn&& fn) {
+		const auto links = [&fn](const dott_file& f) {
+			for (const auto& [_, h] : f.get_packed_scenes()) fn(file_ref{ h });
+			for (const auto& [_, h] : f.get_scripts()) fn(file_ref{ h });
+			for (const auto& [_, h] : f.get_ext_resources()) fn(file_ref{ h });
+		};
+		const auto resource_fields = [&fn](const resource_file::resource& r) {
+			for (const auto& field : r.res_file_fields) fn(field.target);
+		};
+
+		switch (source.kind) {
+		case file_kind::scene: {
+			const auto& f = project.get(scene_handle{ source.index });
+			links(f);
+			for (const auto& node : f.get_node_tree()) {
+				for (const auto& [_, ref] : node->ext_resource_fields) fn(ref);
+			}
+			break;
+		}
+		case file_kind::resource: {
+			const auto& f = project.get(resource_handle{ source.index });
+			links(f);
+			resource_fields(f.get_resource());
+			for (const auto& sub : f.get_sub_resources()) resource_fields(sub);
+			break;
+		}
+		case file_kind::script: {
+			const auto& parent = project.get(script_handle{ source.index }).get_script_class().parent;
+			if (const auto h = project.find_script_class(parent); h.valid()) fn(file_ref{ h });
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	template <typename Forward>
+	void dependency_graph::build_(Forward&& forward) {
+		const auto n = static_cast<std::uint32_t>(offsets_.size() - 1);
+
+		// count users per target, shifted by one so the prefix sum leaves start offsets in place
+		forward([&](std::uint32_t, std::uint32_t target) { ++offsets_[target + 1]; });
+		for (std::uint32_t i = 0; i < n; ++i) {
+			offsets_[i + 1] += offsets_[i];
+		}
+
+		// sources come in ascending order, so every user list ends up sorted and the forward
+		// lists can simply be appended
+		sources_.resize(offsets_[n]);
+		targets_.resize(offsets_[n]);
+		std::vector<std::uint32_t> fill(offsets_.begin(), offsets_.end() - 1);
+		std::uint32_t edge = 0;
+		forward([&](std::uint32_t source, std::uint32_t target) {
+			sources_[fill[target]++] = source;
+			++target_offsets_[source + 1];
+			targets_[edge++] = target;
+		});
+		for (std::uint32_t i = 0; i < n; ++i) {
+			target_offsets_[i + 1] += target_offsets_[i];
+		}
+
+		// drop repeated users in place, the lists only shrink so writing never overtakes reading
+		std::uint32_t write = 0;
+		std::uint32_t begin = 0;
+		for (std::uint32_t i = 0; i < n; ++i) {
+			const auto end = offsets_[i + 1];
+			offsets_[i] = write;
+			for (auto j = begin; j < end; ++j) {
+				const auto source = sources_[j];
+				if (write == offsets_[i] || sources_[write - 1] != source) sources_[write++] = source;
+			}
+			begin = end;
+		}
+		offsets_[n] = write;
+		sources_.resize(write);
+		sources_.shrink_to_fit();
+	}
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_DEPENDENCY_GRAPH_H
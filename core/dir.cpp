@@ -1,8 +1,23 @@
 #include "dir.hpp"
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
+#include "doc_output.hpp"
+#include "godot_cache.hpp"
+#include "parse_cache.hpp"
 #include "parser.hpp"
+#include "project_settings.hpp"
+#include "reachability.hpp"
+#include "registry.hpp"
+#include "rsrc_parser.hpp"
+#include "scheduler.hpp"
+#include "search_index.hpp"
+#include "util/util.hpp"
 
 namespace docs_gen_core {
 	bool dir::set_path(const std::wstring& path) {
@@ -12,306 +27,1058 @@ namespace docs_gen_core {
 			return false;
 		}
 
+		auto source = open_file_source(temp);
+		if (!source) {
+			return false;
+		}
+
 		path_ = temp;
+		source_ = std::move(source);
+		std::error_code ec;
+		source_time_ = std::filesystem::last_write_time(path_, ec);
+		// archives get their docs next to them, e.g. build.pck -> build/docs
+		docs_path_ = source_->is_archive() ? std::filesystem::path(path_).replace_extension() / "docs" : path_ / "docs";
 		return true;
 	}
 
 	void dir::construct_file_tree() {
-		std::vector<std::shared_ptr<scene_file>> scene_files;
-		std::vector<std::shared_ptr<resource_file>> resource_files;
-
 		std::cout << "[INFO] Indexing all files in directory\n";
-		for (auto dir_entry = std::filesystem::recursive_directory_iterator(path_); dir_entry != std::filesystem::recursive_directory_iterator(); ++dir_entry) {
-			if (util::is_dir(*dir_entry) && util::is_dir_blacklisted(dir_entry->path().filename().wstring(), ignored_folders_)) {
-				dir_entry.disable_recursion_pending();
-				continue;
-			}
+		std::vector<file_source::entry> entries;
+		source_->list(ignored_folders_, entries);
+		// handles follow path order, so every tie-break on them is independent of the listing order
+		std::sort(entries.begin(), entries.end(), [](const file_source::entry& a, const file_source::entry& b) {
+			return a.path < b.path;
+		});
 
-			if (util::is_file(*dir_entry)) {
-				if (dir_entry->path().extension() == ".gd"/* || dir_entry->path().extension() == ".cs"*/) {
-					auto f = script_file(dir_entry->path());
-					script_files_[dir_entry->path().relative_path().wstring()] = std::make_shared<script_file>(f);
-				}
+		std::size_t scene_count = 0, resource_count = 0, script_count = 0;
+		for (const auto& entry : entries) {
+			const auto ext = entry.path.extension();
+			scene_count += ext == ".tscn" || ext == ".scn";
+			resource_count += ext == ".tres" || ext == ".res";
+			script_count += ext == ".gd";
+		}
+		project_.reserve(scene_count, resource_count, script_count);
 
-				if (dir_entry->path().extension() == ".tscn") {
-					auto f = scene_file(dir_entry->path());
-					scene_files.push_back(std::make_shared<scene_file>(f));
-				}
+		for (const auto& entry : entries) {
+			const auto ext = entry.path.extension();
+			if (ext == ".gd"/* || ext == ".cs"*/) {
+				file_stats_[entry.path.wstring()] = { entry.size, entry.time, project_.add_script(entry.path) };
+			}
 
-				if (dir_entry->path().extension() == ".tres") {
-					auto f = resource_file(dir_entry->path());
-					resource_files.push_back(std::make_shared<resource_file>(f));
-				}
+			if (ext == ".tscn" || ext == ".scn") {
+				file_stats_[entry.path.wstring()] = { entry.size, entry.time, project_.add_scene(entry.path) };
+			}
+
+			if (ext == ".tres" || ext == ".res") {
+				file_stats_[entry.path.wstring()] = { entry.size, entry.time, project_.add_resource(entry.path) };
 			}
 		}
 		std::cout << "[INFO] Finished indexing all files in directory\n";
 
-		std::cout << "[INFO] Parsing scene files\n";
-		for (auto& val : scene_files) {
-			dott_parser p{ val };
-			if (!p.parse_scene_header())
-				return;
-			file_tree_[val->get_uid()] = val;
+		const auto scenes = static_cast<std::uint32_t>(project_.get_scenes().size());
+		const auto resources = static_cast<std::uint32_t>(project_.get_resources().size());
+		const auto scripts = static_cast<std::uint32_t>(project_.get_scripts().size());
+
+		concurrent_registry<scene_handle> scene_registry;
+		concurrent_registry<resource_handle> resource_registry;
+		bool classes_seeded = false;
+		if (use_godot_cache_) {
+			godot_cache cache;
+			if (cache.load(*source_)) {
+				seed_registries(cache, scene_registry, resource_registry);
+				classes_seeded = !cache.class_scripts.empty();
+			}
 		}
 
-		for (auto& val : scene_files) {
-			dott_parser p{ val };
-			p.set_root_path(path_);
-			if (!p.parse_scene_file_contents(file_tree_, script_files_, resource_files_))
-				return;
+		const task_scheduler scheduler{ jobs_, pool_ };
+		std::vector<task_scheduler::task> tasks;
+
+		// headers of every scene and resource have to be known before any contents are resolved
+		std::cout << "[INFO] Parsing file headers\n";
+		std::atomic<bool> headers_ok{ true };
+		for (std::uint32_t i = 0; i < scenes; ++i) {
+			auto& val = project_.get(scene_handle{ i });
+			if (!val.get_uid().empty())
+				continue;
+			tasks.push_back({ size_of(val), [this, &headers_ok, &scene_registry, &val, i] {
+				if (!parse_header(val))
+					headers_ok = false;
+				else
+					scene_registry.insert(val.get_uid(), scene_handle{ i });
+			} });
+		}
+		for (std::uint32_t i = 0; i < resources; ++i) {
+			auto& val = project_.get(resource_handle{ i });
+			if (!val.get_uid().empty())
+				continue;
+			tasks.push_back({ size_of(val), [this, &headers_ok, &resource_registry, &val, i] {
+				if (!parse_header(val))
+					headers_ok = false;
+				else
+					resource_registry.insert(val.get_uid(), resource_handle{ i });
+			} });
 		}
-		std::cout << "[INFO] Finished parsing scene files\n";
+		scheduler.run(std::move(tasks));
+		tasks.clear();
 
-		std::cout << "[INFO] Parsing resource files\n";
-		for (auto& val : resource_files) {
-			dott_parser p{ val };
-			if (!p.parse_resource_header())
-				return;
-			resource_files_[val->get_uid()] = val;
+		freeze_registry(scene_registry, project_.get_scene_uids());
+		freeze_registry(resource_registry, project_.get_resource_uids());
+		if (!headers_ok)
+			return;
+		std::cout << "[INFO] Finished parsing file headers\n";
+
+		if (!entries_.empty()) {
+			// only what the entries lead to is parsed, the class index is all a script's parent needs
+#ifndef RELEASE
+			if (streaming_) {
+				std::cerr << "[WARNING] streaming is ignored when parsing from entries\n";
+			}
+#endif
+			if (!classes_seeded)
+				index_script_classes(scheduler);
+			load_entries(scheduler);
+			return;
 		}
 
-		for (auto& val : resource_files) {
-			dott_parser p{ val };
-			p.set_root_path(path_);
-			if (!p.parse_resource_file_contents(file_tree_, script_files_, resource_files_))
-				return;
+		if (streaming_) {
+			// contents are parsed in gen_docs right before each doc is written
+			index_script_classes(scheduler);
+			return;
 		}
-		std::cout << "[INFO] Finished parsing resource files\n";
 
-		std::cout << "[INFO] Parsing script files\n";
-		for (auto& [_, val] : script_files_) {
-			script_parser p{ val };
-			p.parse();
+		// the registries are only read from here on, so every file can be parsed on its own
+		std::cout << "[INFO] Parsing scene, resource and script files\n";
+		std::atomic<bool> ok{ true };
+		for (std::uint32_t i = 0; i < scenes; ++i) {
+			auto& val = project_.get(scene_handle{ i });
+			tasks.push_back({ size_of(val), [this, &ok, &val] {
+				if (!parse_contents(val))
+					ok = false;
+			} });
+		}
+		for (std::uint32_t i = 0; i < resources; ++i) {
+			auto& val = project_.get(resource_handle{ i });
+			tasks.push_back({ size_of(val), [this, &ok, &val] {
+				if (!parse_contents(val))
+					ok = false;
+			} });
 		}
-		std::cout << "[INFO] Finished parsing script files\n";
+		for (std::uint32_t i = 0; i < scripts; ++i) {
+			auto& val = project_.get(script_handle{ i });
+			tasks.push_back({ size_of(val), [this, &val] {
+				parse_script(val);
+			} });
+		}
+		scheduler.run(std::move(tasks));
+		if (!ok)
+			return;
+
+		register_script_classes();
+		std::cout << "[INFO] Finished parsing scene, resource and script files\n";
 	}
 
-	void dir::gen_docs() {
-		auto docs_dir = path_ / "docs";
-		if (std::filesystem::exists(docs_dir)) {
-			std::filesystem::remove_all(docs_dir);
+	void dir::index_script_classes(const task_scheduler& scheduler) {
+		std::cout << "[INFO] Indexing script classes\n";
+		std::vector<task_scheduler::task> tasks;
+		const auto scripts = static_cast<std::uint32_t>(project_.get_scripts().size());
+		for (std::uint32_t i = 0; i < scripts; ++i) {
+			auto& val = project_.get(script_handle{ i });
+			tasks.push_back({ size_of(val), [this, &val] {
+				file_data data;
+				if (!source_->read(val.get_path(), data))
+					return;
+				script_parser p{ val, std::move(data) };
+				p.parse_header();
+			} });
 		}
+		scheduler.run(std::move(tasks));
+		register_script_classes();
+		std::cout << "[INFO] Finished indexing script classes\n";
+	}
 
-		std::filesystem::create_directory(docs_dir);
+	void dir::load_entries(const task_scheduler& scheduler) {
+		const auto total = project_.get_scenes().size() + project_.get_resources().size() + project_.get_scripts().size();
+		loaded_.assign(total, 0);
 
-		std::cout << "[INFO] Writing scene files\n";
-		for (const auto& [_, file] : file_tree_) {
-			auto doc_path = file->get_path();
-			doc_path = std::filesystem::relative(doc_path, path_);
-			doc_path = docs_dir / doc_path;
-			std::filesystem::create_directories(doc_path.parent_path());
-			doc_path.replace_filename(doc_path.filename().wstring() + L".md");
-			std::wofstream out{ doc_path, std::ios::out | std::ios::binary };
+		// breadth first, a whole level of files is parsed in parallel before their links are followed
+		std::vector<file_ref> level;
+		const auto load = [this, &level](file_ref ref) {
+			const auto id = dependency_graph::id_of(project_, ref);
+			if (id >= loaded_.size() || loaded_[id])
+				return;
+			loaded_[id] = 1;
+			level.push_back(ref);
+		};
 
-			out.write(L"#scene\n", 7);
+		for (const auto& entry : entries_) {
+			const auto ref = view().find(entry);
+			if (dependency_graph::id_of(project_, ref) < loaded_.size()) {
+				load(ref);
+				continue;
+			}
+#ifndef RELEASE
+			std::cerr << "[ERROR] entry not found: ";
+			std::wcerr << entry << L'\n';
+#endif
+		}
 
-			out.write(L"# Node Tree\n", 12);
-			auto& nodes = file->get_node_tree();
-			for (auto it = nodes.begin(); it != nodes.end(); ++it) {
-				for (std::size_t i = 0; i < (*it)->depth - 1; ++i) {
-					out.put('\t');
+		std::cout << "[INFO] Parsing files reachable from the entries\n";
+		std::size_t count = 0;
+		std::atomic<bool> ok{ true };
+		std::vector<task_scheduler::task> tasks;
+		while (!level.empty()) {
+			for (const auto ref : level) {
+				switch (ref.kind) {
+				case file_kind::scene: {
+					auto& val = project_.get(scene_handle{ ref.index });
+					tasks.push_back({ size_of(val), [this, &ok, &val] {
+						if (!parse_contents(val))
+							ok = false;
+					} });
+					break;
 				}
-				out.write(L"- ", 2);
-				out.write((*it)->name.data(), (*it)->name.size());
-				out.put('\n');
-				
-				for (const auto& [f, s] : (*it)->ext_resource_fields) {
-					if (!s.expired()) {
-						for (std::size_t i = 0; i < (*it)->depth; ++i) {
-							out.put('\t');
-						}
-						out.write(L"  *", 3);
-						out.write(f.c_str(), f.size());
-						out.write(L"*: ", 3);
-						write_named_file_link(out, docs_dir, s.lock()->get_path());
-						out.put('\n');
-					}
+				case file_kind::resource: {
+					auto& val = project_.get(resource_handle{ ref.index });
+					tasks.push_back({ size_of(val), [this, &ok, &val] {
+						if (!parse_contents(val))
+							ok = false;
+					} });
+					break;
+				}
+				case file_kind::script: {
+					auto& val = project_.get(script_handle{ ref.index });
+					tasks.push_back({ size_of(val), [this, &val] {
+						parse_script(val);
+					} });
+					break;
+				}
+				default:
+					break;
 				}
 			}
+			scheduler.run(std::move(tasks));
+			tasks.clear();
+			if (!ok)
+				return;
 
-			out.write(L"# External Resources\n", 21);
-			out.write(L"## Scenes\n", 10);
-			for (const auto& [_, child] : file->get_packed_scenes()) {
-				out.write(L"- ", 2);
-				write_named_file_link(out, docs_dir, child->get_path());
-				out.put('\n');
+			count += level.size();
+			const auto parsed = std::move(level);
+			level.clear();
+			for (const auto ref : parsed) {
+				dependency_graph::for_each_dependency(project_, ref, load);
 			}
+		}
 
-			out.write(L"## Scripts\n", 11);
-			for (const auto& [_, script] : file->get_scripts()) {
-				out.write(L"- ", 2);
-				write_named_file_link(out, docs_dir, script->get_path());
-				out.put('\n');
+		register_script_classes();
+		std::cout << "[INFO] Parsed " << count << " of " << total << " files\n";
+	}
+
+	bool dir::is_loaded(file_ref ref) const {
+		return loaded_.empty() || loaded_[dependency_graph::id_of(project_, ref)];
+	}
+
+	template <typename Handle>
+	void dir::freeze_registry(concurrent_registry<Handle>& registry, util::flat_map<std::wstring, Handle>& table) const {
+		std::vector<typename concurrent_registry<Handle>::duplicate> duplicates;
+		registry.freeze(table, duplicates);
+#ifndef RELEASE
+		for (const auto& d : duplicates) {
+			std::cerr << "[WARNING] duplicate uid uid://";
+			std::wcerr << d.key;
+			std::cerr << ": keeping " << project_.get(d.kept).get_path() << ", ignoring " << project_.get(d.dropped).get_path() << '\n';
+		}
+#endif
+	}
+
+	void dir::register_script_classes() {
+		auto& classes = project_.get_script_classes();
+		const auto& scripts = project_.get_scripts();
+		for (std::uint32_t i = 0; i < scripts.size(); ++i) {
+			const auto& name = scripts[i].get_script_class().name;
+			if (!name.empty() && classes.find(name) == classes.end()) {
+				classes[name] = script_handle{ i };
 			}
-			
-			out.write(L"## Resources\n", 13);
-			for (const auto& [_, resource] : file->get_ext_resources()) {
-				out.write(L"- ", 2);
-				write_named_file_link(out, docs_dir, resource->get_path());
-				out.put('\n');
+		}
+	}
+
+	std::uint64_t dir::size_of(const file& file) const {
+		const auto it = file_stats_.find(file.get_path().wstring());
+		return it != file_stats_.end() ? it->second.size : 0;
+	}
+
+	void dir::seed_registries(const godot_cache& cache, concurrent_registry<scene_handle>& scene_registry,
+		concurrent_registry<resource_handle>& resource_registry) {
+		const auto& scenes = project_.get_scenes();
+		util::flat_map<std::wstring, scene_handle> scenes_by_path;
+		for (std::uint32_t i = 0; i < scenes.size(); ++i) {
+			scenes_by_path[scenes[i].get_path().lexically_relative(path_).generic_wstring()] = scene_handle{ i };
+		}
+
+		const auto& resources = project_.get_resources();
+		util::flat_map<std::wstring, resource_handle> resources_by_path;
+		for (std::uint32_t i = 0; i < resources.size(); ++i) {
+			resources_by_path[resources[i].get_path().lexically_relative(path_).generic_wstring()] = resource_handle{ i };
+		}
+
+		std::size_t uids = 0;
+		for (const auto& [uid, rel_path] : cache.uid_paths) {
+			if (const auto s = scenes_by_path.find(rel_path); s != scenes_by_path.end()) {
+				project_.get(s->second).set_uid(uid);
+				scene_registry.insert(uid, s->second);
+				++uids;
 			}
-			for (const auto& [_, resource] : file->get_ext_resource_other()) {
-				out.write(L"- ", 2);
-				out.write(resource.name.data(), resource.name.size());
-				out.write(L": ", 2);
-				out.write(resource.type.data(), resource.type.size());
-				out.put('\n');
+			else if (const auto r = resources_by_path.find(rel_path); r != resources_by_path.end()) {
+				project_.get(r->second).set_uid(uid);
+				resource_registry.insert(uid, r->second);
+				++uids;
 			}
+		}
 
-			out.close();
+		std::size_t classes = 0;
+		for (const auto& [name, rel_path] : cache.class_scripts) {
+			const auto script = project_.find_script(project::script_key(path_ / std::filesystem::path{ rel_path }));
+			if (script.valid()) {
+				project_.get_script_classes()[name] = script;
+				++classes;
+			}
 		}
 
-		std::cout << "[INFO] Writing resource files\n";
-		for (const auto& [_, file] : resource_files_) {
-			auto doc_path = file->get_path();
-			doc_path = std::filesystem::relative(doc_path, path_);
-			doc_path = docs_dir / doc_path;
-			std::filesystem::create_directories(doc_path.parent_path());
-			doc_path.replace_filename(doc_path.filename().wstring() + L".md");
-			std::wofstream out{ doc_path, std::ios::out | std::ios::binary };
+		std::cout << "[INFO] Seeded " << uids << " uids and " << classes << " script classes from .godot caches\n";
+	}
 
-			out.write(L"#resource\n", 10);
-			write_tres_resource(out, file, docs_dir);
+	void dir::gen_docs() {
+		const auto& docs_dir = docs_path_;
+		const auto out = open_doc_output(output_format_, docs_dir);
+		if (!out->begin())
+			return;
+		auto& output = *out;
+		output.prepare(doc_paths());
+		search_index index{ search_index_ ? project_.get_scenes().size() + project_.get_resources().size() + project_.get_scripts().size() : 0 };
 
-			out.write(L"# External Resources\n", 21);
-			out.write(L"## Scripts\n", 11);
-			for (const auto& [_, script] : file->get_scripts()) {
-				out.write(L"- ", 2);
-				write_named_file_link(out, docs_dir, script->get_path());
-				out.put('\n');
+		// with entries only a subset is parsed up front, there is nothing left to stream
+		if (streaming_ && entries_.empty()) {
+#ifndef RELEASE
+			if (expand_instances_) {
+				std::cerr << "[WARNING] instanced scenes are not expanded in streaming mode\n";
 			}
-			
-			out.write(L"## Scenes\n", 10);
-			for (const auto& [_, child] : file->get_packed_scenes()) {
-				out.write(L"- ", 2);
-				write_named_file_link(out, docs_dir, child->get_path());
-				out.put('\n');
+#endif
+			stream_docs(output, search_index_ ? &index : nullptr);
+		}
+		else {
+			if (expand_instances_) {
+				expander_ = std::make_unique<instance_expander>(project_);
+				const auto count = static_cast<std::uint32_t>(project_.get_scenes().size());
+				for (std::uint32_t i = 0; i < count; ++i) {
+					expander_->expand(scene_handle{ i });
+				}
 			}
-			
-			out.write(L"## Resources\n", 13);
-			for (const auto& [_, resource] : file->get_ext_resources()) {
-				out.write(L"- ", 2);
-				write_named_file_link(out, docs_dir, resource->get_path());
-				out.put('\n');
+
+			build_index();
+
+			std::cout << "[INFO] Writing scene, resource and script files\n";
+			// every doc is rendered whole so unchanged ones are never written
+			const auto emit = [this, &output, &index](const auto& file, file_ref ref, const auto& write_doc) {
+				std::wostringstream body;
+				write_doc(body);
+				std::wostringstream tail;
+				write_used_by(tail, ref);
+				const auto doc_path = doc_path_of(file);
+				if (search_index_) {
+					index.add(dependency_graph::id_of(project_, ref), doc_path.lexically_relative(docs_path_).generic_u8string(), file);
+				}
+				output.write(doc_path, util::to_string(std::move(body).str()), util::to_string(std::move(tail).str()));
+			};
+			std::vector<task_scheduler::task> tasks;
+			for (const auto& file : project_.get_scenes()) {
+				if (file.get_uid().empty() || !is_loaded(project_.handle_of(file)))
+					continue;
+				tasks.push_back({ size_of(file), [this, &file, &emit] {
+					emit(file, project_.handle_of(file), [&](std::wostream& out) { write_scene_doc(out, file); });
+				} });
 			}
-			for (const auto& [_, resource] : file->get_ext_resource_other()) {
-				out.write(L"- ", 2);
-				out.write(resource.name.data(), resource.name.size());
-				out.write(L": ", 2);
-				out.write(resource.type.data(), resource.type.size());
-				out.put('\n');
+			for (const auto& file : project_.get_resources()) {
+				if (file.get_uid().empty() || !is_loaded(project_.handle_of(file)))
+					continue;
+				tasks.push_back({ size_of(file), [this, &file, &emit] {
+					emit(file, project_.handle_of(file), [&](std::wostream& out) { write_resource_doc(out, file); });
+				} });
 			}
-			
-			out.close();
+			for (const auto& file : project_.get_scripts()) {
+				if (!is_loaded(project_.handle_of(file)))
+					continue;
+				tasks.push_back({ size_of(file), [this, &file, &emit] {
+					emit(file, project_.handle_of(file), [&](std::wostream& out) { write_script_doc(out, file); });
+				} });
+			}
+			task_scheduler{ jobs_, pool_ }.run(std::move(tasks));
 		}
 
-		std::cout << "[INFO] Writing script files\n";
-		for (const auto& [_, file] : script_files_) {
-			auto doc_path = file->get_path();
-			doc_path = std::filesystem::relative(doc_path, path_);
-			doc_path = docs_dir / doc_path;
-			std::filesystem::create_directories(doc_path.parent_path());
-			doc_path.replace_filename(doc_path.filename().string() + ".md");
-			std::wofstream out{ doc_path, std::ios::out | std::ios::binary };
-			
-			const auto& sc = file->get_script_class();
+		if (reachability_) {
+			report_reachability();
+		}
 
-			out.write(L"#script", 7);
-			for (const auto& tag : sc.tags) {
-				out.write(L" #", 2);
-				out.write(tag.data(), tag.size());
+		// TODO develop a proper way of item coloring in obsidian
+		auto obsidian_dir = docs_dir / ".obsidian";
+		
+		std::string temp =
+			R"({"colorGroups":[{"query":"tag:#scene","color":{"a":1,"rgb":14048348}},{"query":"tag:#script","color":{"a":1,"rgb":6577366}},{"query":"tag:#resource","color":{"a":1,"rgb":4521728}}]})";
+		output.write(obsidian_dir / "graph.json", temp);
+		if (search_index_) {
+			output.write(docs_dir / "search_index.json", index.to_json());
+		}
+		output.finish();
+	}
+
+	void dir::build_index() {
+		dependencies_.build(project_);
+	}
+
+	std::size_t dir::refresh() {
+		const auto rebuild = [this] {
+			reset_model();
+			construct_file_tree();
+			build_index();
+			return project_.get_scenes().size() + project_.get_resources().size() + project_.get_scripts().size();
+		};
+
+		// an archive is mapped as a whole, any change to it means mapping and indexing it again
+		if (source_->is_archive()) {
+			std::error_code ec;
+			const auto time = std::filesystem::last_write_time(path_, ec);
+			if (ec || time == source_time_)
+				return 0;
+
+			auto source = open_file_source(path_);
+			if (!source)
+				return 0;
+			source_ = std::move(source);
+			source_time_ = time;
+			std::cout << "[INFO] Archive changed, rebuilding\n";
+			return rebuild();
+		}
+
+		std::vector<file_source::entry> entries;
+		source_->list(ignored_folders_, entries);
+		std::vector<std::pair<file_stat*, const file_source::entry*>> changed;
+		std::size_t indexed = 0;
+		for (const auto& entry : entries) {
+			const auto ext = entry.path.extension();
+			if (ext != ".gd" && ext != ".tscn" && ext != ".scn" && ext != ".tres" && ext != ".res")
+				continue;
+
+			++indexed;
+			const auto it = file_stats_.find(entry.path.wstring());
+			if (it == file_stats_.end()) {
+				std::cout << "[INFO] Files were added, rebuilding\n";
+				return rebuild();
 			}
-			out.put('\n');
-			
-			out.write(L"## Extends ", 11);
-			out.write(sc.parent.data(), sc.parent.size());
-			out.put('\n');
+			if (it->second.size != entry.size || it->second.time != entry.time) {
+				changed.emplace_back(&it->second, &entry);
+			}
+		}
 
-			out.write(L"## Class ", 9);
-			out.write(sc.name.data(), sc.name.size());
-			out.put('\n');
+		if (indexed != file_stats_.size()) {
+			std::cout << "[INFO] Files were removed, rebuilding\n";
+			return rebuild();
+		}
+		if (changed.empty())
+			return 0;
+		// which files an entry leads to may have changed as well
+		if (!entries_.empty())
+			return rebuild();
 
-			if (!sc.short_desc.empty()) {
-				out.put('\t');
-				out.write(sc.short_desc.data(), sc.short_desc.size());
-				out.put('\n');
+		// files link by handle, so a file can be parsed again in place without touching the files
+		// linking to it, as long as the uid or class name they were resolved by stays the same
+		std::atomic<bool> ok{ true };
+		std::vector<task_scheduler::task> tasks;
+		for (const auto& [stat, entry] : changed) {
+			const auto ref = stat->ref;
+			tasks.push_back({ entry->size, [this, &ok, ref] {
+				switch (ref.kind) {
+				case file_kind::scene: {
+					auto& val = project_.get(scene_handle{ ref.index });
+					const auto uid = val.get_uid();
+					val.release_contents();
+					if (!parse_header(val) || val.get_uid() != uid || !parse_contents(val))
+						ok = false;
+					break;
+				}
+				case file_kind::resource: {
+					auto& val = project_.get(resource_handle{ ref.index });
+					const auto uid = val.get_uid();
+					val.release_contents();
+					if (!parse_header(val) || val.get_uid() != uid || !parse_contents(val))
+						ok = false;
+					break;
+				}
+				case file_kind::script: {
+					auto& val = project_.get(script_handle{ ref.index });
+					const auto name = val.get_script_class().name;
+					val.release_contents();
+					if (!parse_script(val) || val.get_script_class().name != name)
+						ok = false;
+					break;
+				}
+				default:
+					break;
+				}
+			} });
+		}
+		task_scheduler{ jobs_, pool_ }.run(std::move(tasks));
+		if (!ok) {
+			std::cout << "[INFO] A uid or class name changed, rebuilding\n";
+			return rebuild();
+		}
+
+		for (const auto& [stat, entry] : changed) {
+			stat->size = entry->size;
+			stat->time = entry->time;
+		}
+		build_index();
+		return changed.size();
+	}
+
+	void dir::reset_model() {
+		expander_.reset();
+		dependencies_ = {};
+		loaded_.clear();
+		file_stats_ = {};
+		project_.clear();
+	}
+
+	void dir::stream_docs(doc_output& output, search_index* index) {
+		struct pipeline_item {
+			file_ref target;
+			file_data data;
+			std::filesystem::path doc_path;
+			std::string doc;
+		};
+
+		const auto& scenes = project_.get_scenes();
+		const auto& resources = project_.get_resources();
+		const auto& scripts = project_.get_scripts();
+		std::vector<pipeline_item> jobs;
+		jobs.reserve(scenes.size() + resources.size() + scripts.size());
+		for (std::uint32_t i = 0; i < scenes.size(); ++i) {
+			if (!scenes[i].get_uid().empty()) jobs.push_back({ scene_handle{ i }, {}, {}, {} });
+		}
+		for (std::uint32_t i = 0; i < resources.size(); ++i) {
+			if (!resources[i].get_uid().empty()) jobs.push_back({ resource_handle{ i }, {}, {}, {} });
+		}
+		for (std::uint32_t i = 0; i < scripts.size(); ++i) {
+			jobs.push_back({ script_handle{ i }, {}, {}, {} });
+		}
+
+		const auto& config = pipeline_;
+		const std::size_t workers[] = {
+			std::max<std::size_t>(1, config.read_workers), std::max<std::size_t>(1, config.parse_workers),
+			std::max<std::size_t>(1, config.render_workers), std::max<std::size_t>(1, config.write_workers) };
+
+		// channel i feeds stage i + 1 and is closed once every worker of stage i is done
+		stage_channel<pipeline_item> to_parse{ config.queue_depth, workers[0] };
+		stage_channel<pipeline_item> to_render{ config.queue_depth, workers[1] };
+		stage_channel<pipeline_item> to_write{ config.queue_depth, workers[2] };
+
+		pipeline_stats_.assign(4, {});
+		const char* names[] = { "read", "parse", "render", "write" };
+		for (std::size_t i = 0; i < 4; ++i) {
+			pipeline_stats_[i].name = names[i];
+			pipeline_stats_[i].workers = workers[i];
+		}
+
+		std::mutex stats_mutex;
+		const auto finish = [this, &stats_mutex](std::size_t stage, std::size_t items,
+			std::chrono::nanoseconds starved, std::chrono::nanoseconds blocked) {
+			std::lock_guard lock{ stats_mutex };
+			auto& stats = pipeline_stats_[stage];
+			stats.items += items;
+			stats.starved += starved;
+			stats.blocked += blocked;
+		};
+
+		std::atomic<std::size_t> next_job{ 0 };
+		const auto read = [&] {
+			std::size_t items = 0;
+			std::chrono::nanoseconds blocked{ 0 };
+			for (auto i = next_job++; i < jobs.size(); i = next_job++) {
+				auto item = std::move(jobs[i]);
+				if (!source_->read(project_.get(item.target)->get_path(), item.data))
+					continue;
+				to_parse.push(std::move(item), blocked);
+				++items;
 			}
+			to_parse.producer_done();
+			finish(0, items, {}, blocked);
+		};
 
-			out.write(L"## Variables\n", 13);
-			for (const auto& cat : sc.categories) {
-				if (!cat.name.empty()) {
-					out.write(L"- ", 2);
-					out.write(L"### ", 4);
-					out.write(cat.name.data(), cat.name.size());
-					out.put('\n');
+		const auto parse = [&] {
+			std::size_t items = 0;
+			std::chrono::nanoseconds starved{ 0 };
+			std::chrono::nanoseconds blocked{ 0 };
+			pipeline_item item;
+			while (to_parse.pop(item, starved)) {
+				bool ok = true;
+				switch (item.target.kind) {
+				case file_kind::scene:
+					ok = parse_contents(
+						project_.get(scene_handle{ item.target.index }), std::move(item.data));
+					break;
+				case file_kind::resource:
+					ok = parse_contents(
+						project_.get(resource_handle{ item.target.index }), std::move(item.data));
+					break;
+				case file_kind::script: {
+					ok = parse_script(project_.get(script_handle{ item.target.index }), std::move(item.data));
+					break;
 				}
-				else {
-					out.write(L"- ", 2);
-					out.write(L"### Default Export Group\n", 25);
+				default:
+					break;
 				}
-				
-				for (const auto& var : cat.variables) {
-					out.put('\t');
-					out.write(L"- ", 2);
-					if (var.name[0] == '_') {
-						out.put('\\');
+				item.data = {};
+				if (!ok)
+					continue;
+				to_render.push(std::move(item), blocked);
+				++items;
+			}
+			to_render.producer_done();
+			finish(1, items, starved, blocked);
+		};
+
+		// links are saved before each model is released, "Used by" sections are appended once
+		// every file is through. Every render worker only touches the slot of its own file
+		std::vector<std::vector<file_ref>> forward(scenes.size() + resources.size() + scripts.size());
+
+		const auto render = [&] {
+			std::size_t items = 0;
+			std::chrono::nanoseconds starved{ 0 };
+			std::chrono::nanoseconds blocked{ 0 };
+			pipeline_item item;
+			while (to_render.pop(item, starved)) {
+				auto& links = forward[dependency_graph::id_of(project_, item.target)];
+				dependency_graph::for_each_dependency(project_, item.target, [&links](file_ref ref) { links.push_back(ref); });
+
+				std::wostringstream out;
+				item.doc_path = doc_path_of(*project_.get(item.target));
+				// the index has to see the model before it is released
+				const auto add_to_index = [&](const auto& f) {
+					if (index) {
+						index->add(dependency_graph::id_of(project_, item.target), item.doc_path.lexically_relative(docs_path_).generic_u8string(), f);
 					}
-					out.write(var.name.data(), var.name.size());
-					out.write(L" : ", 3);
-					out.write(var.type.data(), var.type.size());
-					out.put('\n');
+				};
+				switch (item.target.kind) {
+				case file_kind::scene: {
+					auto& f = project_.get(scene_handle{ item.target.index });
+					write_scene_doc(out, f);
+					add_to_index(f);
+					f.release_contents();
+					break;
+				}
+				case file_kind::resource: {
+					auto& f = project_.get(resource_handle{ item.target.index });
+					write_resource_doc(out, f);
+					add_to_index(f);
+					f.release_contents();
+					break;
+				}
+				case file_kind::script: {
+					auto& f = project_.get(script_handle{ item.target.index });
+					write_script_doc(out, f);
+					add_to_index(f);
+					f.release_contents();
+					break;
+				}
+				default:
+					break;
+				}
+				item.doc = util::to_string(std::move(out).str());
+				to_write.push(std::move(item), blocked);
+				++items;
+			}
+			to_write.producer_done();
+			finish(2, items, starved, blocked);
+		};
+
+		const auto write = [&] {
+			std::size_t items = 0;
+			std::chrono::nanoseconds starved{ 0 };
+			pipeline_item item;
+			while (to_write.pop(item, starved)) {
+				output.write_body(item.doc_path, item.doc);
+				++items;
+			}
+			finish(3, items, starved, {});
+		};
+
+		std::cout << "[INFO] Streaming scene, resource and script files\n";
+		std::vector<std::thread> threads;
+		for (std::size_t i = 0; i < workers[0]; ++i) threads.emplace_back(read);
+		for (std::size_t i = 0; i < workers[1]; ++i) threads.emplace_back(parse);
+		for (std::size_t i = 0; i < workers[2]; ++i) threads.emplace_back(render);
+		for (std::size_t i = 0; i < workers[3]; ++i) threads.emplace_back(write);
+		for (auto& t : threads) {
+			t.join();
+		}
+
+		pipeline_stats_[1].queue_peak = to_parse.peak();
+		pipeline_stats_[2].queue_peak = to_render.peak();
+		pipeline_stats_[3].queue_peak = to_write.peak();
+		std::cout << "[INFO] Finished streaming " << pipeline_stats_[3].items << " files\n";
+
+		dependencies_.build(project_, forward);
+		forward.clear();
+		forward.shrink_to_fit();
 
-					if (!var.short_desc.empty()) {
-						out.write(L"\t\t", 2);
-						out.write(var.short_desc.data(), var.short_desc.size());
-						out.put('\n');
+		std::vector<task_scheduler::task> tasks;
+		for (const auto& job : jobs) {
+			tasks.push_back({ 1, [this, &output, ref = job.target] {
+				std::wostringstream out;
+				write_used_by(out, ref);
+				output.append_tail(doc_path_of(*project_.get(ref)), util::to_string(std::move(out).str()));
+			} });
+		}
+		task_scheduler{ jobs_, pool_ }.run(std::move(tasks));
+	}
+
+	void dir::report_reachability() const {
+		project_settings settings;
+		if (!settings.load(*source_))
+			return;
+
+		std::vector<std::uint32_t> roots;
+		const auto add_root = [&](const std::wstring& path) {
+			const auto id = dependencies_.id_of(view().find(path));
+			if (id < dependencies_.size()) {
+				roots.push_back(id);
+				return;
+			}
+#ifndef RELEASE
+			std::cerr << "[WARNING] entry point not found: ";
+			std::wcerr << path << L'\n';
+#endif
+		};
+		if (!settings.main_scene.empty()) add_root(settings.main_scene);
+		for (const auto& autoload : settings.autoloads) add_root(autoload);
+
+		const auto start = std::chrono::high_resolution_clock::now();
+		reachability reach{ dependencies_ };
+		reach.run(roots);
+		const auto took = std::chrono::high_resolution_clock::now() - start;
+
+		std::cout << "[INFO] " << reach.get_reached_count() << " of " << dependencies_.size() << " files reachable from "
+			<< roots.size() << " entry points (" << std::chrono::duration<float, std::milli>(took).count() << "ms)\n";
+		reach.for_each_unreached([this](std::uint32_t id) {
+			std::cout << "[UNREACHABLE] res://"
+				<< project_.get(dependencies_.ref_of(id))->get_path().lexically_relative(source_->root()).generic_string() << '\n';
+		});
+	}
+
+	void dir::write_used_by(std::wostream& out, file_ref ref) const {
+		out.write(L"# Used by\n", 10);
+		for (const auto id : dependencies_.users_of(ref)) {
+			out.write(L"- ", 2);
+			write_named_file_link(out, docs_path_, project_.get(dependencies_.ref_of(id))->get_path());
+			out.put('\n');
+		}
+	}
+
+	std::filesystem::path dir::doc_path_of(const file& file) const {
+		auto doc_path = docs_path_ / file.get_path().lexically_relative(path_);
+		doc_path.replace_filename(doc_path.filename().wstring() + L".md");
+		return doc_path;
+	}
+
+	std::vector<std::filesystem::path> dir::doc_paths() const {
+		std::vector<std::filesystem::path> paths;
+		paths.reserve(project_.get_scenes().size() + project_.get_resources().size() + project_.get_scripts().size() + 1);
+		for (const auto& file : project_.get_scenes()) {
+			if (!file.get_uid().empty() && is_loaded(project_.handle_of(file))) paths.push_back(doc_path_of(file));
+		}
+		for (const auto& file : project_.get_resources()) {
+			if (!file.get_uid().empty() && is_loaded(project_.handle_of(file))) paths.push_back(doc_path_of(file));
+		}
+		for (const auto& file : project_.get_scripts()) {
+			if (is_loaded(project_.handle_of(file))) paths.push_back(doc_path_of(file));
+		}
+		paths.push_back(docs_path_ / ".obsidian" / "graph.json");
+		if (search_index_) {
+			paths.push_back(docs_path_ / "search_index.json");
+		}
+		return paths;
+	}
+
+	void dir::write_scene_doc(std::wostream& out, const scene_file& file) const {
+		const auto& docs_dir = docs_path_;
+
+		out.write(L"#scene\n", 7);
+
+		out.write(L"# Node Tree\n", 12);
+		const auto write_node = [&](const node_tree::tree_node& node, std::size_t depth) {
+			for (std::size_t i = 0; i < depth - 1; ++i) {
+				out.put('\t');
+			}
+			out.write(L"- ", 2);
+			out.write(node.name.data(), node.name.size());
+			out.put('\n');
+			
+			for (const auto& [f, s] : node.ext_resource_fields) {
+				if (s.valid()) {
+					for (std::size_t i = 0; i < depth; ++i) {
+						out.put('\t');
 					}
+					out.write(L"  *", 3);
+					out.write(f.c_str(), f.size());
+					out.write(L"*: ", 3);
+					write_named_file_link(out, docs_dir, project_.get(s)->get_path());
+					out.put('\n');
 				}
 			}
+		};
+
+		if (const auto* expanded = expander_ ? expander_->find(project_.handle_of(file)) : nullptr) {
+			instance_expander::visit(*expanded, write_node);
+		}
+		else {
+			for (const auto& node : file.get_node_tree()) {
+				write_node(*node, node->depth);
+			}
+		}
+
+		out.write(L"# External Resources\n", 21);
+		out.write(L"## Scenes\n", 10);
+		for (const auto& [_, child] : file.get_packed_scenes()) {
+			out.write(L"- ", 2);
+			write_named_file_link(out, docs_dir, project_.get(child).get_path());
+			out.put('\n');
+		}
+
+		out.write(L"## Scripts\n", 11);
+		for (const auto& [_, script] : file.get_scripts()) {
+			out.write(L"- ", 2);
+			write_named_file_link(out, docs_dir, project_.get(script).get_path());
+			out.put('\n');
+		}
+		
+		out.write(L"## Resources\n", 13);
+		for (const auto& [_, resource] : file.get_ext_resources()) {
+			out.write(L"- ", 2);
+			write_named_file_link(out, docs_dir, project_.get(resource).get_path());
+			out.put('\n');
+		}
+		for (const auto& [_, resource] : file.get_ext_resource_other()) {
+			out.write(L"- ", 2);
+			out.write(resource.name.data(), resource.name.size());
+			out.write(L": ", 2);
+			out.write(resource.type.data(), resource.type.size());
+			out.put('\n');
+		}
+	}
+
+	void dir::write_resource_doc(std::wostream& out, const resource_file& file) const {
+		const auto& docs_dir = docs_path_;
+
+		out.write(L"#resource\n", 10);
+		write_tres_resource(out, file, docs_dir);
+
+		out.write(L"# External Resources\n", 21);
+		out.write(L"## Scripts\n", 11);
+		for (const auto& [_, script] : file.get_scripts()) {
+			out.write(L"- ", 2);
+			write_named_file_link(out, docs_dir, project_.get(script).get_path());
+			out.put('\n');
+		}
+		
+		out.write(L"## Scenes\n", 10);
+		for (const auto& [_, child] : file.get_packed_scenes()) {
+			out.write(L"- ", 2);
+			write_named_file_link(out, docs_dir, project_.get(child).get_path());
+			out.put('\n');
+		}
+		
+		out.write(L"## Resources\n", 13);
+		for (const auto& [_, resource] : file.get_ext_resources()) {
+			out.write(L"- ", 2);
+			write_named_file_link(out, docs_dir, project_.get(resource).get_path());
+			out.put('\n');
+		}
+		for (const auto& [_, resource] : file.get_ext_resource_other()) {
+			out.write(L"- ", 2);
+			out.write(resource.name.data(), resource.name.size());
+			out.write(L": ", 2);
+			out.write(resource.type.data(), resource.type.size());
+			out.put('\n');
+		}
+	}
 
-			out.write(L"## Functions\n", 13);
-			for (const auto& func : sc.functions) {
+	void dir::write_script_doc(std::wostream& out, const script_file& file) const {
+		const auto& docs_dir = docs_path_;
+		
+		const auto& sc = file.get_script_class();
+
+		out.write(L"#script", 7);
+		for (const auto& tag : sc.tags) {
+			out.write(L" #", 2);
+			out.write(tag.data(), tag.size());
+		}
+		out.put('\n');
+		
+		out.write(L"## Extends ", 11);
+		if (const auto parent = project_.find_script_class(sc.parent); parent.valid()) {
+			write_named_file_link(out, docs_dir, project_.get(parent).get_path());
+		}
+		else {
+			out.write(sc.parent.data(), sc.parent.size());
+		}
+		out.put('\n');
+
+		out.write(L"## Class ", 9);
+		out.write(sc.name.data(), sc.name.size());
+		out.put('\n');
+
+		if (!sc.short_desc.empty()) {
+			out.put('\t');
+			out.write(sc.short_desc.data(), sc.short_desc.size());
+			out.put('\n');
+		}
+
+		out.write(L"## Variables\n", 13);
+		for (const auto& cat : sc.categories) {
+			if (!cat.name.empty()) {
+				out.write(L"- ", 2);
+				out.write(L"### ", 4);
+				out.write(cat.name.data(), cat.name.size());
+				out.put('\n');
+			}
+			else {
+				out.write(L"- ", 2);
+				out.write(L"### Default Export Group\n", 25);
+			}
+			
+			for (const auto& var : cat.variables) {
+				out.put('\t');
 				out.write(L"- ", 2);
-				if (func.name[0] == '_') {
+				if (var.name[0] == '_') {
 					out.put('\\');
 				}
-				out.write(func.name.data(), func.name.size());
+				out.write(var.name.data(), var.name.size());
+				out.write(L" : ", 3);
+				out.write(var.type.data(), var.type.size());
 				out.put('\n');
 
-				if (!func.short_desc.empty()) {
-					out.put('\t');
-					out.write(func.short_desc.data(), func.short_desc.size());
+				if (!var.short_desc.empty()) {
+					out.write(L"\t\t", 2);
+					out.write(var.short_desc.data(), var.short_desc.size());
 					out.put('\n');
 				}
-				
-				out.write(L"\tArguments\n", 11);
-				for (const auto& arg : func.arguments) {
-					out.write(L"\t- ", 3);
-					if (arg.name[0] == '_') {
-						out.put('\\');
-					}
-					out.write(arg.name.data(), arg.name.size());
-					out.write(L" : ", 3);
-					out.write(arg.type.data(), arg.type.size());
-					out.put('\n');
+			}
+		}
+
+		out.write(L"## Functions\n", 13);
+		for (const auto& func : sc.functions) {
+			out.write(L"- ", 2);
+			if (func.name[0] == '_') {
+				out.put('\\');
+			}
+			out.write(func.name.data(), func.name.size());
+			out.put('\n');
+
+			if (!func.short_desc.empty()) {
+				out.put('\t');
+				out.write(func.short_desc.data(), func.short_desc.size());
+				out.put('\n');
+			}
+			
+			out.write(L"\tArguments\n", 11);
+			for (const auto& arg : func.arguments) {
+				out.write(L"\t- ", 3);
+				if (arg.name[0] == '_') {
+					out.put('\\');
 				}
-				out.write(L"\tReturn type: ", 14);
-				out.write(func.return_type.data(), func.return_type.size());
+				out.write(arg.name.data(), arg.name.size());
+				out.write(L" : ", 3);
+				out.write(arg.type.data(), arg.type.size());
 				out.put('\n');
 			}
-			out.close();
+			out.write(L"\tReturn type: ", 14);
+			out.write(func.return_type.data(), func.return_type.size());
+			out.put('\n');
 		}
+	}
 
-		// TODO develop a proper way of item coloring in obsidian
-		auto obsidian_dir = docs_dir / ".obsidian";
-		std::filesystem::create_directory(obsidian_dir);
-		
-		std::ofstream out{ obsidian_dir / "graph.json", std::ios::out | std::ios::binary };
-		
-		std::string temp =
-			R"({"colorGroups":[{"query":"tag:#scene","color":{"a":1,"rgb":14048348}},{"query":"tag:#script","color":{"a":1,"rgb":6577366}},{"query":"tag:#resource","color":{"a":1,"rgb":4521728}}]})";
-		out.write(temp.data(), temp.size());
-		out.close();
+	template <typename File>
+	bool dir::parse_header(File& file) const {
+		file_data data;
+		if (!source_->read(file.get_path(), data))
+			return false;
+
+		if (rsrc_parser::is_binary_resource(file.get_path())) {
+			rsrc_parser p{ file, std::move(data) };
+			return p.parse_header(file);
+		}
+
+		dott_parser<File> p{ file, std::move(data) };
+		return p.parse_header();
+	}
+
+	template <typename File>
+	bool dir::parse_contents(File& file) const {
+		file_data data;
+		if (!source_->read(file.get_path(), data))
+			return false;
+
+		return parse_contents(file, std::move(data));
+	}
+
+	template <typename File>
+	bool dir::parse_contents(File& file, file_data data) const {
+		if (rsrc_parser::is_binary_resource(file.get_path())) {
+			rsrc_parser p{ file, std::move(data) };
+			p.set_root_path(path_);
+			return p.parse_contents(file, project_);
+		}
+
+		if (parse_cache_ && parse_cache_->on_disk()) {
+			const auto key = parse_cache::key_of(data.view());
+			auto entries = std::make_unique<dott_entries>();
+			if (!parse_cache_->find(key, *entries)) {
+				dott_lexer{ data.view() }.record(*entries);
+				parse_cache_->insert(key, *entries);
+			}
+
+			dott_parser<File> p{ file, std::move(entries) };
+			p.set_root_path(path_);
+			return p.parse_contents(project_);
+		}
+
+		dott_parser<File> p{ file, std::move(data) };
+		p.set_root_path(path_);
+		return p.parse_contents(project_);
+	}
+
+	bool dir::parse_script(script_file& file) const {
+		file_data data;
+		if (!source_->read(file.get_path(), data))
+			return false;
+
+		return parse_script(file, std::move(data));
+	}
+
+	bool dir::parse_script(script_file& file, file_data data) const {
+		if (!parse_cache_) {
+			script_parser p{ file, std::move(data) };
+			return p.parse();
+		}
+
+		const auto key = parse_cache::key_of(data.view());
+		if (const auto cached = parse_cache_->find(key)) {
+			file.set_script_class(*cached);
+			return true;
+		}
+
+		script_parser p{ file, std::move(data) };
+		if (!p.parse())
+			return false;
+		parse_cache_->insert(key, file.get_script_class());
+		return true;
 	}
 
 	bool dir::is_ignored(const std::filesystem::path& path) const {
@@ -332,9 +1099,9 @@ namespace docs_gen_core {
 		return false;
 	}
 
-	void dir::write_named_file_link(std::wofstream& out, const std::filesystem::path& docs_path,
+	void dir::write_named_file_link(std::wostream& out, const std::filesystem::path& docs_path,
 		const std::filesystem::path& file_path) const {
-		auto doc_path = std::filesystem::relative(file_path, path_);
+		auto doc_path = file_path.lexically_relative(path_);
 		doc_path = docs_path / doc_path;
 		doc_path.replace_filename(doc_path.filename().wstring() + L".md");
 		const auto file_name = doc_path.filename().wstring();
@@ -346,21 +1113,18 @@ namespace docs_gen_core {
 		out.put(')');
 	}
 
-	void dir::write_tres_resource(std::wofstream& out, const std::weak_ptr<resource_file>& file, const std::filesystem::path& docs_path) const {
-		if (file.expired()) return;
-		const auto& f = file.lock();
-		
+	void dir::write_tres_resource(std::wostream& out, const resource_file& file, const std::filesystem::path& docs_path) const {
 		out.write(L"# Using\n", 8);
-		write_tres_resource_(out, docs_path, f->get_resource());
+		write_tres_resource_(out, docs_path, file, file.get_resource());
 
 		out.write(L"## Sub_Resources\n", 17);
-		for (const auto& [_, res] : f->get_sub_resources()) {
-			write_tres_resource_(out, docs_path, *res.get(), true);
+		for (const auto& res : file.get_sub_resources()) {
+			write_tres_resource_(out, docs_path, file, res, true);
 		}
 	}
 
-	void dir::write_tres_resource_(std::wofstream& out, const std::filesystem::path& docs_path,
-		const resource_file::resource& res, bool sub_res) const {
+	void dir::write_tres_resource_(std::wostream& out, const std::filesystem::path& docs_path,
+		const resource_file& file, const resource_file::resource& res, bool sub_res) const {
 		if (sub_res) {
 			out.write(res.type.data(), res.type.size());
 			out.put('\n');
@@ -375,11 +1139,11 @@ namespace docs_gen_core {
 			out.write(name.data(), name.size());
 			out.write(L": ", 2);
 
-			if (ext_res.expired()) {
+			if (const auto* f = project_.get(ext_res); !f) {
 				out.write(L"Unknown file\n", 13);
 			}
 			else {
-				write_named_file_link(out, docs_path, ext_res.lock()->get_path());
+				write_named_file_link(out, docs_path, f->get_path());
 				out.put('\n');
 			}
 		}
@@ -397,7 +1161,7 @@ namespace docs_gen_core {
 			out.put('\n');
 		}
 
-		for (const auto& [name, ext_res] : res.sub_res_fields) {
+		for (const auto& [name, index] : res.sub_res_fields) {
 			if (sub_res) {
 				out.write(L"\t- ", 3);
 			}
@@ -407,12 +1171,12 @@ namespace docs_gen_core {
 			out.write(name.data(), name.size());
 			out.write(L": ", 2);
 
-			if (ext_res.expired()) {
+			if (index >= file.get_sub_resources().size()) {
 				out.write(L"Unknown sub_resource\n", 13);
 			}
 			else {
-				const auto& r = ext_res.lock();
-				out.write(r->type.data(), r->type.size());
+				const auto& r = file.get_sub_resources()[index];
+				out.write(r.type.data(), r.type.size());
 				out.put('\n');
 			}
 		}
@@ -1,23 +1,64 @@
 #ifndef DOCS_GEN_DIR_H
 #define DOCS_GEN_DIR_H
 
+#include <cstdint>
 #include <filesystem>
+#include <fstream>
 #include <vector>
 
 #include <memory>
-#include <unordered_map>
 
+#include "dependency_graph.hpp"
+#include "doc_output.hpp"
 #include "file.hpp"
+#include "instance_tree.hpp"
+#include "pipeline.hpp"
+#include "project.hpp"
+#include "project_view.hpp"
+#include "vfs.hpp"
 
 namespace docs_gen_core {
 
+	struct godot_cache;
+	class parse_cache;
+	class search_index;
+	class task_scheduler;
+	class worker_pool;
+	template <typename V>
+	class concurrent_registry;
+
 	class dir {
 		std::filesystem::path path_;
+		std::filesystem::path docs_path_;
+		std::shared_ptr<file_source> source_;
 		std::vector<std::wstring> ignored_folders_;
-
-		std::unordered_map<std::wstring, std::shared_ptr<scene_file>> file_tree_;
-		std::unordered_map<std::wstring, std::shared_ptr<script_file>> script_files_;
-		std::unordered_map<std::wstring, std::shared_ptr<resource_file>> resource_files_;
+		// "res://" paths or uids, empty parses the whole project
+		std::vector<std::wstring> entries_;
+		bool use_godot_cache_ = false;
+		bool streaming_ = false;
+		bool expand_instances_ = false;
+		bool reachability_ = false;
+		bool search_index_ = true;
+		output_format output_format_ = output_format::folder;
+		std::size_t jobs_ = 0;
+		worker_pool* pool_ = nullptr;
+		parse_cache* parse_cache_ = nullptr;
+		pipeline_config pipeline_;
+		std::vector<stage_stats> pipeline_stats_;
+
+		project project_;
+		std::unique_ptr<instance_expander> expander_;
+		// one flag per dependency_graph id, set for the files parsed from entries_
+		std::vector<std::uint8_t> loaded_;
+		dependency_graph dependencies_;
+		struct file_stat {
+			std::uint64_t size;
+			std::filesystem::file_time_type time;
+			file_ref ref;
+		};
+		// every indexed scene, resource and script by its full path
+		util::flat_map<std::wstring, file_stat> file_stats_;
+		std::filesystem::file_time_type source_time_;
 
 	public:
 		dir() = default;
@@ -29,21 +70,97 @@ namespace docs_gen_core {
 		dir& operator=(dir&& other) = delete;
 
 		[[nodiscard]] bool set_path(const std::wstring& path);
+		void set_docs_path(const std::wstring& path) { docs_path_ = path; }
 		void set_ignored_folders(const std::vector<std::wstring>& folders) { ignored_folders_ = folders; }
 		void push_ignored_folder(const std::wstring& folder) { ignored_folders_.push_back(folder); }
+		// Only parse and document this scene, resource or script and what it references, directly
+		// or not. Can be given several times
+		void push_entry(const std::wstring& path) { entries_.push_back(path); }
+		// Seed uid and class registries from .godot/uid_cache.bin and global_script_class_cache.cfg
+		void set_use_godot_cache(bool use) { use_godot_cache_ = use; }
+		// Only index the project up front, then read, parse, render and write files in overlapping
+		// stages, releasing each model once its doc is rendered
+		void set_streaming(bool streaming) { streaming_ = streaming; }
+		// Inline the node trees of instanced scenes into scene docs, needs every scene parsed up
+		// front so it is ignored in streaming mode
+		void set_expand_instances(bool expand) { expand_instances_ = expand; }
+		// After writing the docs, list every scene, resource and script that neither the main
+		// scene nor an autoload of project.godot leads to
+		void set_reachability(bool reachability) { reachability_ = reachability; }
+		void set_pipeline_config(const pipeline_config& config) { pipeline_ = config; }
+		// Also write search_index.json, tokens of names, classes, functions, exported variables,
+		// tags and node types mapped to the docs they appear in. On by default
+		void set_search_index(bool search_index) { search_index_ = search_index; }
+		// One file per doc (default), or every doc packed into docs.bundle or docs.tar next to the docs folder
+		void set_output_format(output_format format) { output_format_ = format; }
+		// Threads used for parsing and writing outside of streaming mode, 0 means one per core
+		void set_jobs(std::size_t jobs) { jobs_ = jobs; }
+		// Run parsing and writing on shared threads instead of starting new ones, overrides jobs.
+		// The pool has to outlive every call on this dir
+		void set_worker_pool(worker_pool* pool) { pool_ = pool; }
+		// Reuse parse results of files with the same contents, from other projects or earlier runs.
+		// The cache has to outlive every call on this dir
+		void set_parse_cache(parse_cache* cache) { parse_cache_ = cache; }
+		// Filled by gen_docs in streaming mode, one entry per stage
+		[[nodiscard]] const std::vector<stage_stats>& get_pipeline_stats() const { return pipeline_stats_; }
 
 		void construct_file_tree();
 		void gen_docs();
+		// Builds the dependency index without writing anything, for answering queries
+		void build_index();
+		// Reparses the files that changed on disk since they were last parsed and updates the
+		// index. Added, removed or renamed files, a changed uid or class name and a changed
+		// archive rebuild the whole model. Returns how many files were parsed again
+		std::size_t refresh();
+
+		[[nodiscard]] const project& get_project() const { return project_; }
+		[[nodiscard]] const dependency_graph& get_dependencies() const { return dependencies_; }
+		// Read-only view of the parsed project, valid until the next construct_file_tree or refresh
+		[[nodiscard]] project_view view() const { return { project_, dependencies_, source_->root() }; }
 
 	private:
+		void seed_registries(const godot_cache& cache, concurrent_registry<scene_handle>& scene_registry,
+			concurrent_registry<resource_handle>& resource_registry);
+		template <typename Handle>
+		void freeze_registry(concurrent_registry<Handle>& registry, util::flat_map<std::wstring, Handle>& table) const;
+
+		void reset_model();
+		void register_script_classes();
+		void index_script_classes(const task_scheduler& scheduler);
+		void load_entries(const task_scheduler& scheduler);
+		[[nodiscard]] bool is_loaded(file_ref ref) const;
+		[[nodiscard]] std::uint64_t size_of(const file& file) const;
 		[[nodiscard]] bool is_ignored(const std::filesystem::path& path) const;
-		
-		void write_named_file_link(std::wofstream& out, const std::filesystem::path& docs_path,
+
+		// File is scene_file or resource_file, text and binary files are told apart by extension
+		template <typename File>
+		bool parse_header(File& file) const;
+		template <typename File>
+		bool parse_contents(File& file) const;
+		template <typename File>
+		bool parse_contents(File& file, file_data data) const;
+		bool parse_script(script_file& file) const;
+		bool parse_script(script_file& file, file_data data) const;
+
+		// index is nullptr when no search index is written
+		void stream_docs(doc_output& output, search_index* index);
+		void report_reachability() const;
+
+		[[nodiscard]] std::filesystem::path doc_path_of(const file& file) const;
+		// Every doc gen_docs is going to write
+		[[nodiscard]] std::vector<std::filesystem::path> doc_paths() const;
+		void write_scene_doc(std::wostream& out, const scene_file& file) const;
+		void write_resource_doc(std::wostream& out, const resource_file& file) const;
+		void write_script_doc(std::wostream& out, const script_file& file) const;
+		// "Used by" section from the reverse dependency graph, the last section of every doc
+		void write_used_by(std::wostream& out, file_ref ref) const;
+
+		void write_named_file_link(std::wostream& out, const std::filesystem::path& docs_path,
 			const std::filesystem::path& file_path) const;
-		void write_tres_resource(std::wofstream& out, const std::weak_ptr<resource_file>& file,
+		void write_tres_resource(std::wostream& out, const resource_file& file,
 			const std::filesystem::path& docs_path) const;
-		void write_tres_resource_(std::wofstream& out, const std::filesystem::path& docs_path,
-			const resource_file::resource& res, bool sub_res = false) const;
+		void write_tres_resource_(std::wostream& out, const std::filesystem::path& docs_path,
+			const resource_file& file, const resource_file::resource& res, bool sub_res = false) const;
 	};
 
 	namespace util {
@@ -0,0 +1,298 @@
+#include "doc_output.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "archive_output.hpp"
+
+namespace docs_gen_core {
+
+	namespace {
+
+		std::uint64_t hash_of(std::string_view s) {
+			return util::string_hash::hash_bytes(s.data(), s.size());
+		}
+
+		std::filesystem::path state_dir(const std::filesystem::path& root) {
+			return root / ".docs_gen";
+		}
+
+		// Writes under a temporary name first so an interrupted run never leaves half a manifest
+		bool save(const std::filesystem::path& path, const std::string& contents) {
+			auto temp = path;
+			temp += ".tmp";
+			{
+				std::ofstream out{ temp, std::ios::out | std::ios::binary };
+				out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+				if (!out)
+					return false;
+			}
+			std::error_code ec;
+			std::filesystem::rename(temp, path, ec);
+			return !ec;
+		}
+
+	} // anonymous
+
+	std::string doc_output::key_of(const std::filesystem::path& path) const {
+		return path.lexically_relative(root_).generic_u8string();
+	}
+
+	folder_output::folder_output(const std::filesystem::path& root)
+		: doc_output(root) {
+	}
+
+	bool folder_output::begin() {
+		std::ifstream in{ state_dir(root_) / "manifest", std::ios::binary };
+		std::string line;
+		bool valid = static_cast<bool>(in);
+		// "<body hash>\t<body size>\t<tail hash>\t<tail size>\t<path>"
+		while (valid && std::getline(in, line)) {
+			entry e{};
+			unsigned long long body_hash, body_size, tail_hash, tail_size;
+			int consumed = 0;
+			if (std::sscanf(line.c_str(), "%llx\t%llu\t%llx\t%llu\t%n", &body_hash, &body_size, &tail_hash, &tail_size, &consumed) != 4
+				|| consumed == 0 || static_cast<std::size_t>(consumed) >= line.size()) {
+				valid = false;
+				break;
+			}
+			e.body_hash = body_hash;
+			e.body_size = body_size;
+			e.tail_hash = tail_hash;
+			e.tail_size = tail_size;
+			previous_[line.substr(consumed)] = e;
+		}
+
+		std::error_code ec;
+		if (!valid) {
+			previous_ = {};
+			std::filesystem::remove_all(root_, ec);
+		}
+		std::filesystem::create_directories(root_, ec);
+		if (!std::filesystem::is_directory(root_, ec)) {
+			std::cerr << "[ERROR] could not create docs folder: " << root_ << '\n';
+			return false;
+		}
+		return true;
+	}
+
+	void folder_output::prepare(const std::vector<std::filesystem::path>& paths) {
+		const auto failed = create_folders(root_, paths);
+#ifndef RELEASE
+		if (failed > 0) {
+			std::cerr << "[WARNING] " << failed << " docs folders could not be created\n";
+		}
+#endif
+	}
+
+	void folder_output::write(const std::filesystem::path& path, std::string_view body, std::string_view tail) {
+		auto key = key_of(path);
+		const entry e{ hash_of(body), body.size(), hash_of(tail), tail.size(), false };
+		if (const auto* prev = unchanged_on_disk(key, path); prev && prev->body_hash == e.body_hash && prev->body_size == e.body_size
+			&& prev->tail_hash == e.tail_hash && prev->tail_size == e.tail_size) {
+			record(std::move(key), e, false);
+			return;
+		}
+
+		if (store(path, body, tail, false)) {
+			record(std::move(key), e, true);
+		}
+	}
+
+	void folder_output::write_body(const std::filesystem::path& path, std::string_view body) {
+		auto key = key_of(path);
+		entry e{ hash_of(body), body.size(), 0, 0, false };
+		if (const auto* prev = unchanged_on_disk(key, path); !prev || prev->body_hash != e.body_hash || prev->body_size != e.body_size) {
+			if (!store(path, body, {}, false))
+				return;
+			e.written = true;
+		}
+
+		std::lock_guard lock{ mutex_ };
+		current_[std::move(key)] = e;
+	}
+
+	void folder_output::append_tail(const std::filesystem::path& path, std::string_view tail) {
+		auto key = key_of(path);
+		entry e;
+		{
+			std::lock_guard lock{ mutex_ };
+			const auto it = current_.find(key);
+			// the body could not be written
+			if (it == current_.end())
+				return;
+			e = it->second;
+		}
+
+		e.tail_hash = hash_of(tail);
+		e.tail_size = tail.size();
+		bool changed = e.written;
+		if (!e.written) {
+			// the body on disk is this run's, only the tail may differ from the last run
+			const auto& prev = previous_.find(key)->second;
+			if (prev.tail_hash != e.tail_hash || prev.tail_size != e.tail_size) {
+				std::error_code ec;
+				std::filesystem::resize_file(path, e.body_size, ec);
+				changed = true;
+			}
+		}
+		if (changed && !store(path, {}, tail, true)) {
+			std::lock_guard lock{ mutex_ };
+			current_.erase(key);
+			return;
+		}
+
+		e.written = false;
+		record(std::move(key), e, changed);
+	}
+
+	void folder_output::finish() {
+		for (const auto& [key, e] : previous_) {
+			if (current_.find(key) != current_.end())
+				continue;
+
+			auto path = root_ / std::filesystem::u8path(key);
+			std::error_code ec;
+			std::filesystem::remove(path, ec);
+			deleted_.push_back(key);
+			// folders left empty go too, remove fails on the first one that is not
+			for (path = path.parent_path(); path != root_ && std::filesystem::remove(path, ec); path = path.parent_path()) {
+			}
+		}
+		std::sort(changed_.begin(), changed_.end());
+		std::sort(deleted_.begin(), deleted_.end());
+
+		std::vector<std::pair<const std::string*, const entry*>> entries;
+		entries.reserve(current_.size());
+		for (const auto& [key, e] : current_) {
+			entries.emplace_back(&key, &e);
+		}
+		std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return *a.first < *b.first; });
+
+		std::string manifest;
+		char line[96];
+		for (const auto& [key, e] : entries) {
+			const auto n = std::snprintf(line, sizeof(line), "%016" PRIx64 "\t%" PRIu64 "\t%016" PRIx64 "\t%" PRIu64 "\t",
+				e->body_hash, e->body_size, e->tail_hash, e->tail_size);
+			manifest.append(line, static_cast<std::size_t>(n));
+			manifest.append(*key);
+			manifest.push_back('\n');
+		}
+
+		std::string changes;
+		for (const auto& key : changed_) {
+			changes.append("changed\t").append(key).push_back('\n');
+		}
+		for (const auto& key : deleted_) {
+			changes.append("deleted\t").append(key).push_back('\n');
+		}
+
+		std::error_code ec;
+		std::filesystem::create_directories(state_dir(root_), ec);
+		if (!save(state_dir(root_) / "manifest", manifest) || !save(state_dir(root_) / "changes", changes)) {
+			std::cerr << "[ERROR] could not save the docs manifest in " << state_dir(root_) << '\n';
+		}
+
+		std::cout << "[INFO] Docs: " << changed_.size() << " changed, " << deleted_.size() << " deleted, "
+			<< get_unchanged() << " unchanged\n";
+#ifndef RELEASE
+		if (failed_ > 0) {
+			std::cerr << "[WARNING] " << failed_ << " docs could not be written\n";
+		}
+#endif
+	}
+
+	const folder_output::entry* folder_output::unchanged_on_disk(const std::string& key, const std::filesystem::path& path) const {
+		const auto it = previous_.find(key);
+		if (it == previous_.end())
+			return nullptr;
+
+		std::error_code ec;
+		const auto size = std::filesystem::file_size(path, ec);
+		if (ec || size != it->second.body_size + it->second.tail_size)
+			return nullptr;
+		return &it->second;
+	}
+
+	bool folder_output::store(const std::filesystem::path& path, std::string_view body, std::string_view tail, bool append) {
+		const auto mode = std::ios::out | std::ios::binary | (append ? std::ios::app : std::ios::trunc);
+		std::ofstream out{ path, mode };
+		// the folder was not prepared, writers on other threads may be creating it too
+		if (!out.is_open()) {
+			std::error_code ec;
+			std::filesystem::create_directories(path.parent_path(), ec);
+			out.open(path, mode);
+		}
+		out.write(body.data(), static_cast<std::streamsize>(body.size()));
+		out.write(tail.data(), static_cast<std::streamsize>(tail.size()));
+		out.close();
+		if (out)
+			return true;
+
+		std::lock_guard lock{ mutex_ };
+		++failed_;
+		return false;
+	}
+
+	void folder_output::record(std::string key, const entry& e, bool changed) {
+		std::lock_guard lock{ mutex_ };
+		if (changed) {
+			changed_.push_back(key);
+		}
+		current_[std::move(key)] = e;
+	}
+
+	std::size_t create_folders(const std::filesystem::path& root, const std::vector<std::filesystem::path>& paths) {
+		// files of one folder mostly come together, so neighbours are folded before sorting
+		std::vector<std::filesystem::path> folders;
+		for (const auto& path : paths) {
+			auto folder = path.parent_path();
+			if (folders.empty() || folders.back() != folder) {
+				folders.push_back(std::move(folder));
+			}
+		}
+		std::sort(folders.begin(), folders.end());
+		folders.erase(std::unique(folders.begin(), folders.end()), folders.end());
+
+		// parents of nested folders that hold no file themselves
+		const auto count = folders.size();
+		for (std::size_t i = 0; i < count; ++i) {
+			for (auto parent = folders[i].parent_path(); parent != root && parent.native().size() > root.native().size();
+				parent = parent.parent_path()) {
+				folders.push_back(parent);
+			}
+		}
+		if (folders.size() > count) {
+			std::sort(folders.begin(), folders.end());
+			folders.erase(std::unique(folders.begin(), folders.end()), folders.end());
+		}
+
+		// a path sorts after its parent, so one mkdir per folder is enough
+		std::size_t failed = 0;
+		for (const auto& folder : folders) {
+			if (folder == root)
+				continue;
+			std::error_code ec;
+			std::filesystem::create_directory(folder, ec);
+			if (ec) {
+				++failed;
+			}
+		}
+		return failed;
+	}
+
+	std::unique_ptr<doc_output> open_doc_output(output_format format, const std::filesystem::path& docs_path) {
+		switch (format) {
+		case output_format::bundle:
+			return std::make_unique<bundle_output>(docs_path);
+		case output_format::tar:
+			return std::make_unique<tar_output>(docs_path);
+		default:
+			return std::make_unique<folder_output>(docs_path);
+		}
+	}
+
+} // docs_gen_core
@@ -0,0 +1,116 @@
+#ifndef DOCS_GEN_DOC_OUTPUT_H
+#define DOCS_GEN_DOC_OUTPUT_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "util/flat_map.hpp"
+
+namespace docs_gen_core {
+
+	enum class output_format {
+		folder,
+		bundle,
+		tar,
+	};
+
+	// Where rendered docs go. A doc is a body and a tail ("Used by"), the streaming pipeline
+	// writes the body as soon as it is rendered and appends the tail once the whole project is
+	// through. Paths are full paths below the docs folder. write, write_body and append_tail
+	// can be called from several threads
+	class doc_output {
+	protected:
+		std::filesystem::path root_;
+
+		explicit doc_output(const std::filesystem::path& root) : root_(root) {}
+
+	public:
+		doc_output(const doc_output& other) = delete;
+		doc_output(doc_output&& other) = delete;
+		virtual ~doc_output() = default;
+
+		doc_output& operator=(const doc_output& other) = delete;
+		doc_output& operator=(doc_output&& other) = delete;
+
+		// false if nothing can be written
+		virtual bool begin() = 0;
+		// Paths of the docs about to be written, so their folders can be set up once instead of per doc.
+		// Writing a doc that was not announced still works
+		virtual void prepare(const std::vector<std::filesystem::path>& /*paths*/) {}
+		virtual void write(const std::filesystem::path& path, std::string_view body, std::string_view tail = {}) = 0;
+		// Body now, tail later, for docs whose tail is only known at the end
+		virtual void write_body(const std::filesystem::path& path, std::string_view body) = 0;
+		virtual void append_tail(const std::filesystem::path& path, std::string_view tail) = 0;
+		virtual void finish() = 0;
+
+	protected:
+		// Relative generic path in UTF-8
+		[[nodiscard]] std::string key_of(const std::filesystem::path& path) const;
+	};
+
+	// One file per doc below the docs folder, only touching the ones whose contents changed
+	// since the last run, so file watchers, site builds and uploads only see real changes.
+	//
+	// Every doc's hash is kept in <docs>/.docs_gen/manifest. Docs the last run wrote that are not
+	// written again are deleted, and <docs>/.docs_gen/changes lists every changed ("changed\t<path>")
+	// and deleted ("deleted\t<path>") doc relative to the docs folder for tools that sync them.
+	// Without a manifest the folder is cleared first, as nothing says which files are ours.
+	// Body and tail are hashed separately, so a doc whose tail alone changed is cut back to its
+	// body and gets the new tail appended
+	class folder_output final : public doc_output {
+		struct entry {
+			std::uint64_t body_hash;
+			std::uint64_t body_size;
+			std::uint64_t tail_hash;
+			std::uint64_t tail_size;
+			// the body is on disk from this run, the tail still has to be appended
+			bool written;
+		};
+
+		util::flat_map<std::string, entry> previous_;
+		std::mutex mutex_;
+		util::flat_map<std::string, entry> current_;
+		std::vector<std::string> changed_;
+		std::vector<std::string> deleted_;
+		std::size_t failed_ = 0;
+
+	public:
+		explicit folder_output(const std::filesystem::path& root);
+
+		// Loads the manifest of the last run, false if the folder cannot be created
+		bool begin() override;
+		// Creates every folder the docs go to, so writing a doc is a single open
+		void prepare(const std::vector<std::filesystem::path>& paths) override;
+		void write(const std::filesystem::path& path, std::string_view body, std::string_view tail = {}) override;
+		void write_body(const std::filesystem::path& path, std::string_view body) override;
+		void append_tail(const std::filesystem::path& path, std::string_view tail) override;
+		// Deletes the docs of the last run that were not written again, saves the manifest and
+		// the list of changes
+		void finish() override;
+
+		[[nodiscard]] const std::vector<std::string>& get_changed() const { return changed_; }
+		[[nodiscard]] const std::vector<std::string>& get_deleted() const { return deleted_; }
+		[[nodiscard]] std::size_t get_unchanged() const { return current_.size() - changed_.size(); }
+
+	private:
+		// The entry of the last run if the doc on disk still has its size, nullptr otherwise
+		[[nodiscard]] const entry* unchanged_on_disk(const std::string& key, const std::filesystem::path& path) const;
+		bool store(const std::filesystem::path& path, std::string_view body, std::string_view tail, bool append);
+		void record(std::string key, const entry& e, bool changed);
+	};
+
+	// Creates the folders of the files at paths, all below root, each once and parents first, so
+	// sibling files share a single mkdir. Returns how many folders could not be created
+	std::size_t create_folders(const std::filesystem::path& root, const std::vector<std::filesystem::path>& paths);
+
+	// docs_path is the docs folder, archives are written next to it (docs.bundle, docs.tar)
+	[[nodiscard]] std::unique_ptr<doc_output> open_doc_output(output_format format, const std::filesystem::path& docs_path);
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_DOC_OUTPUT_H
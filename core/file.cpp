@@ -10,36 +10,15 @@ namespace docs_gen_core {
 		title_ = path_.filename().wstring();
 	}
 
-	file::file(const file& other)
-		: path_(other.path_), title_(other.title_) {
-	}
-
-	file::file(file&& other) noexcept
-		: path_(std::move(other.path_)), title_(std::move(other.title_)) {
-	}
-
 	script_file::script_file(const std::filesystem::path& path)
 		: file(path) {
 	}
 
-	script_file::script_file(const script_file& other)
-		: file(other) {
-	}
-
-	script_file::script_file(script_file&& other) noexcept
-		: file(std::move(other)) {
-	}
-
-	script_file& script_file::operator=(const script_file& other) {
-		path_ = other.path_;
-		title_ = other.title_;
-		return *this;
-	}
-
-	script_file& script_file::operator=(script_file&& other) noexcept {
-		path_ = std::move(other.path_);
-		title_ = std::move(other.title_);
-		return *this;
+	void script_file::release_contents() {
+		script_class c{};
+		c.name = std::move(class_.name);
+		c.parent = std::move(class_.parent);
+		class_ = std::move(c);
 	}
 
 	ext_resource_other::ext_resource_other(const std::wstring& type, const std::filesystem::path& path)
@@ -51,56 +30,43 @@ namespace docs_gen_core {
 		: file(path) {
 	}
 
-	dott_file::dott_file(const dott_file& other)
-		: file(other), packed_scenes_(other.packed_scenes_), ext_resources_(other.ext_resources_) {}
-
-	dott_file::dott_file(dott_file&& other) noexcept
-		: packed_scenes_(std::move(other.packed_scenes_)), ext_resources_(std::move(other.ext_resources_)) {
-		path_ = std::move(other.path_);
-		title_ = std::move(other.title_);
-	}
-
-	dott_file& dott_file::operator=(const dott_file& other) {
-		path_ = other.path_;
-		title_ = other.title_;
-		packed_scenes_ = other.packed_scenes_;
-		ext_resources_ = other.ext_resources_;
-		return *this;
-	}
-
-	dott_file& dott_file::operator=(dott_file&& other) noexcept {
-		path_ = std::move(other.path_);
-		title_ = std::move(other.title_);
-		packed_scenes_ = std::move(other.packed_scenes_);
-		ext_resources_ = std::move(other.ext_resources_);
-		return *this;
-	}
-
-	void dott_file::push_packed_scene(const std::wstring& key, const std::shared_ptr<scene_file>& child) {
+	void dott_file::push_packed_scene(const std::wstring& key, scene_handle child) {
 		if (packed_scenes_.find(key) != packed_scenes_.end()) {
 #ifndef RELEASE
 			std::cerr << "[WARNING] overwriting external resource PackedScene ";
-			std::wcerr << packed_scenes_[key]->get_path();
-			std::cerr << '\n';
+			std::wcerr << key;
+			std::cerr << " in " << path_ << '\n';
 #endif
 		}
 		
 		packed_scenes_[key] = child;
 	}
 
-	void dott_file::push_ext_resource(const std::wstring& key, const std::shared_ptr<resource_file>& resource) {
+	void dott_file::push_ext_resource(const std::wstring& key, resource_handle resource) {
 		if (ext_resources_.find(key) != ext_resources_.end()) {
 #ifndef RELEASE
 			std::cerr << "[WARNING] overwriting external resource Resource ";
-			std::wcerr << ext_resources_[key];
-			std::cerr << '\n';
+			std::wcerr << key;
+			std::cerr << " in " << path_ << '\n';
 #endif
 		}
 		
 		ext_resources_[key] = resource;
 	}
 
-	void dott_file::push_ext_resource_other(const std::wstring& key, const ext_resource_other& resource) {
+	void dott_file::push_script(const std::wstring& key, script_handle script) {
+		if (scripts_.find(key) != scripts_.end()) {
+#ifndef RELEASE
+			std::cerr << "[WARNING] overwriting external resource Script ";
+			std::wcerr << key;
+			std::cerr << " in " << path_ << '\n';
+#endif
+		}
+		
+		scripts_[key] = script;
+	}
+
+	void dott_file::push_ext_resource_other(const std::wstring& key, ext_resource_other resource) {
 		if (ext_resources_other_.find(key) != ext_resources_other_.end()) {
 			const auto& res = ext_resources_other_[key];
 #ifndef RELEASE
@@ -110,118 +76,64 @@ namespace docs_gen_core {
 #endif
 		}
 		
-		ext_resources_other_[key] = resource;
+		ext_resources_other_[key] = std::move(resource);
 	}
 
-	resource_file::resource_file(const std::filesystem::path& path)
-		: dott_file(path) {
+	file_ref dott_file::find_ext_file(const std::wstring& key) const {
+		if (const auto it = packed_scenes_.find(key); it != packed_scenes_.end())
+			return it->second;
+		if (const auto it = scripts_.find(key); it != scripts_.end())
+			return it->second;
+		if (const auto it = ext_resources_.find(key); it != ext_resources_.end())
+			return it->second;
+		return {};
 	}
 
-	resource_file::resource_file(const resource_file& other)
-		: dott_file(other), uid_(other.uid_), scripts_(other.scripts_) {
+	void dott_file::release_links() {
+		util::flat_map<std::wstring, scene_handle>{}.swap(packed_scenes_);
+		util::flat_map<std::wstring, resource_handle>{}.swap(ext_resources_);
+		util::flat_map<std::wstring, script_handle>{}.swap(scripts_);
+		util::flat_map<std::wstring, ext_resource_other>{}.swap(ext_resources_other_);
 	}
 
-	resource_file::resource_file(resource_file&& other) noexcept
-		: uid_(std::move(other.uid_)) {
-		path_ = std::move(other.path_);
-		title_ = std::move(other.title_);
-		packed_scenes_ = std::move(other.packed_scenes_);
-		ext_resources_ = std::move(other.ext_resources_);
-		scripts_ = std::move(other.scripts_);
-	}
-
-	resource_file& resource_file::operator=(const resource_file& other) {
-		path_ = other.path_;
-		title_ = other.title_;
-		uid_ = other.uid_;
-		packed_scenes_ = other.packed_scenes_;
-		ext_resources_ = other.ext_resources_;
-		scripts_ = other.scripts_;
-		return *this;
-	}
-
-	resource_file& resource_file::operator=(resource_file&& other) noexcept {
-		path_ = std::move(other.path_);
-		title_ = std::move(other.title_);
-		packed_scenes_ = std::move(other.packed_scenes_);
-		ext_resources_ = std::move(other.ext_resources_);
-		scripts_ = std::move(other.scripts_);
-		return *this;
-	}
-
-	void resource_file::push_script(const std::wstring& key, const std::shared_ptr<script_file>& s) {
-		if (scripts_.find(key) != scripts_.end()) {
-#ifndef RELEASE
-			std::cerr << "[WARNING] overwriting external resource Script ";
-			std::wcerr << scripts_[key]->get_path();
-			std::cerr << '\n';
-#endif
-		}
-		
-		scripts_[key] = s;
+	resource_file::resource_file(const std::filesystem::path& path)
+		: dott_file(path) {
 	}
 
-	void resource_file::push_sub_resource(const std::wstring& key, const std::shared_ptr<resource>& resource) {
-		if (sub_resources_.find(key) != sub_resources_.end()) {
+	void resource_file::push_sub_resource(const std::wstring& key, resource&& resource) {
+		if (const auto it = sub_resource_ids_.find(key); it != sub_resource_ids_.end()) {
 #ifndef RELEASE
 			std::cerr << "[WARNING] overwriting sub_resource ";
-			std::wcerr << resource->type;
+			std::wcerr << resource.type;
 			std::cerr << '\n';
 #endif
+			sub_resources_[it->second] = std::move(resource);
+			return;
 		}
 		
-		sub_resources_[key] = resource;
-	}
-
-	scene_file::scene_file(const std::filesystem::path& path)
-		: dott_file(path) {
-	}
-
-	scene_file::scene_file(const scene_file& other)
-		: dott_file(other), uid_(other.uid_), scripts_(other.scripts_), node_tree_(other.node_tree_) {
+		sub_resource_ids_[key] = static_cast<std::uint32_t>(sub_resources_.size());
+		sub_resources_.push_back(std::move(resource));
 	}
 
-	scene_file::scene_file(scene_file&& other) noexcept
-		: uid_(std::move(other.uid_)), node_tree_(std::move(other.node_tree_)) {
-		path_ = std::move(other.path_);
-		title_ = std::move(other.title_);
-		packed_scenes_ = std::move(other.packed_scenes_);
-		ext_resources_ = std::move(other.ext_resources_);
-		scripts_ = std::move(other.scripts_);
+	std::uint32_t resource_file::find_sub_resource(const std::wstring& key) const {
+		const auto it = sub_resource_ids_.find(key);
+		return it != sub_resource_ids_.end() ? it->second : ~std::uint32_t{ 0 };
 	}
 
-	scene_file& scene_file::operator=(const scene_file& other) {
-		path_ = other.path_;
-		title_ = other.title_;
-		packed_scenes_ = other.packed_scenes_;
-		ext_resources_ = other.ext_resources_;
-		scripts_ = other.scripts_;
-		uid_ = other.uid_;
-		node_tree_ = other.node_tree_;
-		return *this;
+	void resource_file::release_contents() {
+		release_links();
+		std::vector<resource>{}.swap(sub_resources_);
+		util::flat_map<std::wstring, std::uint32_t>{}.swap(sub_resource_ids_);
+		resource_ = resource{};
 	}
 
-	scene_file& scene_file::operator=(scene_file&& other) noexcept {
-		path_ = std::move(other.path_);
-		title_ = std::move(other.title_);
-		packed_scenes_ = std::move(other.packed_scenes_);
-		ext_resources_ = std::move(other.ext_resources_);
-		scripts_ = std::move(other.scripts_);
-		uid_ = std::move(other.uid_);
-		node_tree_ = std::move(other.node_tree_);
-		return *this;
+	scene_file::scene_file(const std::filesystem::path& path)
+		: dott_file(path) {
 	}
 
-	void scene_file::push_script(const std::wstring& key, const std::shared_ptr<script_file>& script) {
-		if (scripts_.find(key) != scripts_.end()) {
-#ifndef RELEASE
-			std::cerr << "[WARNING] overwriting external resource Script ";
-			std::wcerr << scripts_[key]->get_path();
-			std::cerr << '\n';
-#endif
-		}
-		
-		scripts_[key] = script;
+	void scene_file::release_contents() {
+		release_links();
+		node_tree_ = node_tree{};
 	}
 	
 } // docs_gen_core
@@ -1,13 +1,15 @@
 #ifndef DOCS_GEN_FILE_H
 #define DOCS_GEN_FILE_H
 
+#include <cstdint>
 #include <filesystem>
 #include <vector>
 #include <string>
 #include <memory>
-#include <unordered_map>
 
+#include "handle.hpp"
 #include "node.hpp"
+#include "util/flat_map.hpp"
 
 namespace docs_gen_core {
 
@@ -18,11 +20,13 @@ namespace docs_gen_core {
 
 		file() = default;
 		explicit file(const std::filesystem::path& path);
-		file(const file& other);
-		file(file&& other) noexcept;
+		file(const file& other) = delete;
+		file(file&& other) noexcept = default;
 		virtual ~file() = default;
 	
 	public:
+		// Files are built in place in their project and never copied, moving is only there
+		// so the project's arrays can grow
 		file& operator=(const file&) = delete;
 		file& operator=(file&&) = delete;
 		
@@ -64,20 +68,17 @@ namespace docs_gen_core {
 	public:
 		script_file() = default;
 		explicit script_file(const std::filesystem::path& path);
-		script_file(const script_file& other);
-		script_file(script_file&& other) noexcept;
+		script_file(const script_file& other) = delete;
+		script_file(script_file&& other) noexcept = default;
 		~script_file() override = default;
 
-		script_file& operator=(const script_file& other);
-		script_file& operator=(script_file&& other) noexcept;
-
 		void set_script_class(const script_class& c) { class_ = c; }
 		void set_script_class(script_class&& c) { class_ = std::move(c); }
 		[[nodiscard]] const script_class& get_script_class() const { return class_; }
-	};
 
-	class scene_file;
-	class resource_file;
+		// Drops everything but the class name and parent, which the index keeps for linking
+		void release_contents();
+	};
 
 	struct ext_resource_other {
 		std::wstring type;
@@ -94,32 +95,37 @@ namespace docs_gen_core {
 		ext_resource_other& operator=(ext_resource_other&&) noexcept = default;
 	};
 
+	// Scene or resource file. External resources are keyed by their id in the file and
+	// point into the owning project by handle
 	class dott_file : public file {
 	protected:
-		std::unordered_map<std::wstring, std::shared_ptr<scene_file>> packed_scenes_;
-		std::unordered_map<std::wstring, std::shared_ptr<resource_file>> ext_resources_;
-		std::unordered_map<std::wstring, ext_resource_other> ext_resources_other_;
+		util::flat_map<std::wstring, scene_handle> packed_scenes_;
+		util::flat_map<std::wstring, resource_handle> ext_resources_;
+		util::flat_map<std::wstring, script_handle> scripts_;
+		util::flat_map<std::wstring, ext_resource_other> ext_resources_other_;
 
 		dott_file() = default;
 		explicit dott_file(const std::filesystem::path& path);
-		dott_file(const dott_file& other);
-		dott_file(dott_file&& other) noexcept;
+		dott_file(const dott_file& other) = delete;
+		dott_file(dott_file&& other) noexcept = default;
 		~dott_file() override = default;
 
-		dott_file& operator=(const dott_file& other);
-		dott_file& operator=(dott_file&& other) noexcept;
-
 	public:
-		void push_packed_scene(const std::wstring& key, const std::shared_ptr<scene_file>& child);
-		void push_ext_resource(const std::wstring& key, const std::shared_ptr<resource_file>& resource);
-		void push_ext_resource_other(const std::wstring& key, const ext_resource_other& resource);
-
-		[[nodiscard]] const std::unordered_map<std::wstring, std::shared_ptr<scene_file>>& get_packed_scenes() const { return packed_scenes_; }
-		[[nodiscard]] std::unordered_map<std::wstring, std::shared_ptr<scene_file>>& get_packed_scenes() { return packed_scenes_; }
-		[[nodiscard]] const std::unordered_map<std::wstring, std::shared_ptr<resource_file>>& get_ext_resources() const { return ext_resources_; }
-		[[nodiscard]] std::unordered_map<std::wstring, std::shared_ptr<resource_file>>& get_ext_resources() { return ext_resources_; }
-		[[nodiscard]] const std::unordered_map<std::wstring, ext_resource_other>& get_ext_resource_other() const { return ext_resources_other_; }
-		[[nodiscard]] std::unordered_map<std::wstring, ext_resource_other>& get_ext_resource_other() { return ext_resources_other_; }
+		void push_packed_scene(const std::wstring& key, scene_handle child);
+		void push_ext_resource(const std::wstring& key, resource_handle resource);
+		void push_script(const std::wstring& key, script_handle script);
+		void push_ext_resource_other(const std::wstring& key, ext_resource_other resource);
+
+		[[nodiscard]] const util::flat_map<std::wstring, scene_handle>& get_packed_scenes() const { return packed_scenes_; }
+		[[nodiscard]] const util::flat_map<std::wstring, resource_handle>& get_ext_resources() const { return ext_resources_; }
+		[[nodiscard]] const util::flat_map<std::wstring, script_handle>& get_scripts() const { return scripts_; }
+		[[nodiscard]] const util::flat_map<std::wstring, ext_resource_other>& get_ext_resource_other() const { return ext_resources_other_; }
+
+		// The scene, resource or script behind an ExtResource id, invalid if it is none of those
+		[[nodiscard]] file_ref find_ext_file(const std::wstring& key) const;
+
+	protected:
+		void release_links();
 	};
 
 	class resource_file final : public dott_file {
@@ -129,13 +135,14 @@ namespace docs_gen_core {
 				std::wstring name;
 				std::wstring value;
 			};
+			// index into the sub resources of the same file
 			struct sub_res_field {
 				std::wstring name;
-				std::weak_ptr<resource> field;
+				std::uint32_t index;
 			};
 			struct ext_res_field {
 				std::wstring name;
-				std::weak_ptr<file> file;
+				file_ref target;
 			};
 
 			std::wstring type;
@@ -148,62 +155,59 @@ namespace docs_gen_core {
 	private:
 		std::wstring uid_;
 		std::wstring script_class_;
-		std::unordered_map<std::wstring, std::shared_ptr<script_file>> scripts_;
 
-		std::unordered_map<std::wstring, std::shared_ptr<resource>> sub_resources_;
+		std::vector<resource> sub_resources_;
+		util::flat_map<std::wstring, std::uint32_t> sub_resource_ids_;
 		resource resource_;
 
 	public:
 		resource_file() = default;
 		explicit resource_file(const std::filesystem::path& path);
-		resource_file(const resource_file& other);
-		resource_file(resource_file&& other) noexcept;
+		resource_file(const resource_file& other) = delete;
+		resource_file(resource_file&& other) noexcept = default;
 		~resource_file() override = default;
 
-		resource_file& operator=(const resource_file& other);
-		resource_file& operator=(resource_file&& other) noexcept;
-
 		void set_uid(const std::wstring& s) { uid_ = s; }
 		void set_script_class(const std::wstring& s) { script_class_ = s; }
-		void push_script(const std::wstring& key, const std::shared_ptr<script_file>& s);
-		void push_sub_resource(const std::wstring& key, const std::shared_ptr<resource>& resource);
-		void set_resource(const resource& resource) { resource_ = resource; }
+		void push_sub_resource(const std::wstring& key, resource&& resource);
+		void set_resource(resource&& resource) { resource_ = std::move(resource); }
 
 		[[nodiscard]] const std::wstring& get_uid() const { return uid_; }
 		[[nodiscard]] const std::wstring& get_script_class() const { return script_class_; }
-		[[nodiscard]] const std::unordered_map<std::wstring, std::shared_ptr<script_file>>& get_scripts() const { return scripts_; }
-		[[nodiscard]] const std::unordered_map<std::wstring, std::shared_ptr<resource>>& get_sub_resources() const { return sub_resources_; }
+		// In the order they appear in the file
+		[[nodiscard]] const std::vector<resource>& get_sub_resources() const { return sub_resources_; }
+		[[nodiscard]] std::uint32_t find_sub_resource(const std::wstring& key) const;
 		[[nodiscard]] const resource& get_resource() const { return resource_; }
+
+		// Drops the parsed model once its doc is written, path and uid stay for other files to link to
+		void release_contents();
 	};
 
 	class scene_file final : public dott_file {
 		std::wstring uid_;
-		std::unordered_map<std::wstring, std::shared_ptr<script_file>> scripts_;
 		node_tree node_tree_;
 
 	public:
 		scene_file() = default;
 		explicit scene_file(const std::filesystem::path& path);
-		scene_file(const scene_file& other);
-		scene_file(scene_file&& other) noexcept;
+		scene_file(const scene_file& other) = delete;
+		scene_file(scene_file&& other) noexcept = default;
 		~scene_file() override = default;
 
-		scene_file& operator=(const scene_file& other);
-		scene_file& operator=(scene_file&& other) noexcept;
-
 		void set_uid(const std::wstring& s) { uid_ = s; }
-		void push_script(const std::wstring& key, const std::shared_ptr<script_file>& script);
 
 		[[nodiscard]] const std::wstring& get_uid() const { return uid_; }
-		[[nodiscard]] const std::unordered_map<std::wstring, std::shared_ptr<script_file>>& get_scripts() const { return scripts_; }
-		[[nodiscard]] std::unordered_map<std::wstring, std::shared_ptr<script_file>>& get_scripts() { return scripts_; }
 		[[nodiscard]] const node_tree& get_node_tree() const { return node_tree_; }
 		[[nodiscard]] node_tree& get_node_tree() { return node_tree_; }
+
+		// Drops the parsed model once its doc is written, path and uid stay for other files to link to
+		void release_contents();
 	};
 
+	// Hashes a scene by its uid
 	struct scene_file_hash {
-		bool operator()(const std::shared_ptr<scene_file>& f) const noexcept {
-			return std::hash<std::wstring>{}(f->get_uid());
+		std::size_t operator()(const scene_file& f) const noexcept {
+			return util::string_hash{}(f.get_uid());
 		}
 	};
 
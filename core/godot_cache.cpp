@@ -0,0 +1,108 @@
+#include "godot_cache.hpp"
+
+#include <cstdint>
+#include <iostream>
+
+#include "lexer.hpp"
+#include "rsrc_parser.hpp"
+#include "util/util.hpp"
+
+namespace docs_gen_core {
+
+	namespace {
+
+		std::uint32_t read_u32(std::string_view s, std::size_t pos) {
+			const auto* b = reinterpret_cast<const unsigned char*>(s.data() + pos);
+			return std::uint32_t(b[0]) | std::uint32_t(b[1]) << 8 | std::uint32_t(b[2]) << 16 | std::uint32_t(b[3]) << 24;
+		}
+
+		std::string_view strip_res(std::string_view path) {
+			if (path.compare(0, 6, "res://") == 0) path.remove_prefix(6);
+			return path;
+		}
+
+		// Value of "key": "..." / "key": &"..." inside one dictionary of the class list
+		std::string_view dict_string(std::string_view dict, std::string_view key) {
+			std::string quoted;
+			quoted.reserve(key.size() + 2);
+			quoted.push_back('"');
+			quoted.append(key);
+			quoted.push_back('"');
+
+			auto at = dict.find(quoted);
+			if (at == std::string_view::npos) return {};
+			at = dict.find('"', dict.find(':', at + quoted.size()));
+			if (at == std::string_view::npos) return {};
+			const auto end = dict.find('"', at + 1);
+			if (end == std::string_view::npos) return {};
+			return dict.substr(at + 1, end - at - 1);
+		}
+
+	} // anonymous
+
+	bool godot_cache::load(const file_source& source) {
+		const auto cache_dir = source.root() / ".godot";
+
+		file_data uid_data;
+		const bool has_uids = source.read(cache_dir / "uid_cache.bin", uid_data) && parse_uid_cache(uid_data.view(), uid_paths);
+
+		file_data class_data;
+		const bool has_classes = source.read(cache_dir / "global_script_class_cache.cfg", class_data) && parse_class_cache(class_data.view(), class_scripts);
+
+#ifndef RELEASE
+		if (!has_uids) {
+			std::cerr << "[WARNING] could not read .godot/uid_cache.bin\n";
+		}
+		if (!has_classes) {
+			std::cerr << "[WARNING] could not read .godot/global_script_class_cache.cfg\n";
+		}
+#endif
+		return has_uids || has_classes;
+	}
+
+	bool godot_cache::parse_uid_cache(std::string_view data, util::flat_map<std::wstring, std::wstring>& uid_paths) {
+		if (data.size() < 4) return false;
+
+		const auto count = read_u32(data, 0);
+		std::size_t pos = 4;
+		for (std::uint32_t i = 0; i < count; ++i) {
+			if (pos + 12 > data.size()) return false;
+			const auto uid = std::uint64_t(read_u32(data, pos)) | std::uint64_t(read_u32(data, pos + 4)) << 32;
+			const auto len = read_u32(data, pos + 8);
+			pos += 12;
+			if (pos + len > data.size()) return false;
+
+			uid_paths[rsrc_parser::uid_to_text(uid)] = util::to_wstring(strip_res(data.substr(pos, len)));
+			pos += len;
+		}
+		return true;
+	}
+
+	bool godot_cache::parse_class_cache(std::string_view data, util::flat_map<std::wstring, std::wstring>& class_scripts) {
+		dott_lexer lexer{ data };
+		dott_lexer::property p;
+		std::string_view heading;
+		do {
+			while (lexer.next_property(p)) {
+				if (p.key != "list") continue;
+
+				auto list = p.value;
+				for (auto open = list.find('{'); open != std::string_view::npos; open = list.find('{')) {
+					const auto close = list.find('}', open);
+					if (close == std::string_view::npos) break;
+
+					const auto dict = list.substr(open, close - open);
+					const auto name = dict_string(dict, "class");
+					const auto path = dict_string(dict, "path");
+					if (!name.empty() && !path.empty()) {
+						class_scripts[util::to_wstring(name)] = util::to_wstring(strip_res(path));
+					}
+					list.remove_prefix(close + 1);
+				}
+				return true;
+			}
+		} while (lexer.next_section(heading));
+		return false;
+	}
+
+} // docs_gen_core
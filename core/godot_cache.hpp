@@ -0,0 +1,28 @@
+#ifndef DOCS_GEN_GODOT_CACHE_H
+#define DOCS_GEN_GODOT_CACHE_H
+
+#include <string>
+#include <string_view>
+
+#include "util/flat_map.hpp"
+#include "vfs.hpp"
+
+namespace docs_gen_core {
+
+	// Indexes the Godot editor already keeps under .godot/, used to seed the uid and
+	// class registries without parsing every file header first
+	struct godot_cache {
+		// uid text (without "uid://") -> project relative path (without "res://")
+		util::flat_map<std::wstring, std::wstring> uid_paths;
+		// class_name -> project relative script path
+		util::flat_map<std::wstring, std::wstring> class_scripts;
+
+		bool load(const file_source& source);
+
+		static bool parse_uid_cache(std::string_view data, util::flat_map<std::wstring, std::wstring>& uid_paths);
+		static bool parse_class_cache(std::string_view data, util::flat_map<std::wstring, std::wstring>& class_scripts);
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_GODOT_CACHE_H
@@ -0,0 +1,50 @@
+#ifndef DOCS_GEN_HANDLE_H
+#define DOCS_GEN_HANDLE_H
+
+#include <cstdint>
+
+namespace docs_gen_core {
+
+	class scene_file;
+	class resource_file;
+	class script_file;
+
+	// Index of a file in one of the typed arrays of a project
+	template <typename T>
+	struct handle {
+		static constexpr std::uint32_t invalid = ~std::uint32_t{ 0 };
+
+		std::uint32_t index = invalid;
+
+		[[nodiscard]] bool valid() const { return index != invalid; }
+
+		bool operator==(handle other) const { return index == other.index; }
+		bool operator!=(handle other) const { return index != other.index; }
+		bool operator<(handle other) const { return index < other.index; }
+	};
+
+	using scene_handle = handle<scene_file>;
+	using resource_handle = handle<resource_file>;
+	using script_handle = handle<script_file>;
+
+	enum class file_kind : std::uint8_t { none, scene, resource, script };
+
+	// Link to a file of any kind, e.g. a node property pointing at a scene, script or resource
+	struct file_ref {
+		file_kind kind = file_kind::none;
+		std::uint32_t index = ~std::uint32_t{ 0 };
+
+		file_ref() = default;
+		file_ref(scene_handle h) : kind(file_kind::scene), index(h.index) {}
+		file_ref(resource_handle h) : kind(file_kind::resource), index(h.index) {}
+		file_ref(script_handle h) : kind(file_kind::script), index(h.index) {}
+
+		[[nodiscard]] bool valid() const { return kind != file_kind::none; }
+
+		bool operator==(file_ref other) const { return kind == other.kind && index == other.index; }
+		bool operator!=(file_ref other) const { return !(*this == other); }
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_HANDLE_H
@@ -0,0 +1,137 @@
+#include "instance_tree.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace docs_gen_core {
+
+	instance_expander::instance_expander(const project& project)
+		: project_(project), expanded_(project.get_scenes().size()),
+		states_(project.get_scenes().size(), state::unvisited) {
+	}
+
+	const instance_expander::expanded_scene& instance_expander::expand(scene_handle scene) {
+		if (states_[scene.index] == state::done)
+			return *expanded_[scene.index];
+
+		// depth first with an explicit stack, prefab chains can be deeper than the call stack likes.
+		// A frame revisits its current node after the instanced scene below it is done
+		struct frame {
+			scene_handle scene;
+			std::size_t next;
+		};
+		std::vector<frame> stack;
+		begin(scene);
+		stack.push_back({ scene, 0 });
+
+		while (!stack.empty()) {
+			auto& top = stack.back();
+			auto& current = *expanded_[top.scene.index];
+
+			bool descended = false;
+			for (; top.next < current.nodes.size(); ++top.next) {
+				auto& n = current.nodes[top.next];
+				const auto target = n.node->instance;
+				if (!target.valid() || target.index >= states_.size())
+					continue;
+
+				if (states_[target.index] == state::done) {
+					n.instance = expanded_[target.index].get();
+					continue;
+				}
+
+				if (states_[target.index] == state::expanding) {
+#ifndef RELEASE
+					std::cerr << "[WARNING] instance cycle: " << project_.get(current.scene).get_path()
+						<< " instances " << project_.get(target).get_path() << " which is still being expanded\n";
+#endif
+					n.cycle = true;
+					++cycles_;
+					continue;
+				}
+
+				begin(target);
+				stack.push_back({ target, 0 });
+				descended = true;
+				break;
+			}
+
+			if (descended)
+				continue;
+
+			finish(current);
+			stack.pop_back();
+		}
+
+		return *expanded_[scene.index];
+	}
+
+	const instance_expander::expanded_scene* instance_expander::find(scene_handle scene) const {
+		if (!scene.valid() || scene.index >= states_.size() || states_[scene.index] != state::done)
+			return nullptr;
+		return expanded_[scene.index].get();
+	}
+
+	namespace {
+		// Appends the base fields whose property the node does not set itself
+		template <typename T>
+		void merge_fields(std::vector<std::pair<std::wstring, T>>& fields, const std::vector<std::pair<std::wstring, T>>& base) {
+			for (const auto& [name, value] : base) {
+				const auto set = std::any_of(fields.begin(), fields.end(), [&name = name](const auto& f) { return f.first == name; });
+				if (!set) {
+					fields.emplace_back(name, value);
+				}
+			}
+		}
+	}
+
+	node_tree::tree_node instance_expander::merge_root_(const node_tree::tree_node& node, const expanded_scene& scene, bool root_fields) {
+		node_tree::tree_node merged{ node.name, node.type };
+		merged.path = node.path;
+		merged.depth = node.depth;
+		merged.instance = node.instance;
+		merged.ext_resource_fields = node.ext_resource_fields;
+		merged.sub_resource_fields = node.sub_resource_fields;
+
+		// an inherited root passes its own base on, the nearest scene wins
+		for (const auto* s = &scene; s && !s->nodes.empty(); s = s->nodes[0].instance) {
+			const auto& root = *s->nodes[0].node;
+			merged.type = root.type;
+			if (root_fields) {
+				merge_fields(merged.ext_resource_fields, root.ext_resource_fields);
+				merge_fields(merged.sub_resource_fields, root.sub_resource_fields);
+			}
+		}
+		return merged;
+	}
+
+	void instance_expander::begin(scene_handle scene) {
+		auto e = std::make_unique<expanded_scene>();
+		e->scene = scene;
+		for (const auto& node : project_.get(scene).get_node_tree()) {
+			e->nodes.push_back({ node.get(), nullptr, false });
+		}
+
+		expanded_[scene.index] = std::move(e);
+		states_[scene.index] = state::expanding;
+	}
+
+	void instance_expander::finish(expanded_scene& scene) {
+		constexpr auto max = std::numeric_limits<std::uint64_t>::max();
+		std::uint64_t size = 0;
+		for (std::size_t i = 0; i < scene.nodes.size(); ++i) {
+			const auto& n = scene.nodes[i];
+			// the instance node replaces the instanced root, which is not counted again
+			std::uint64_t add = 1;
+			if (n.instance && n.instance->flattened_size > 0) {
+				add = n.instance->flattened_size;
+			}
+			size = max - size < add ? max : size + add;
+		}
+
+		scene.flattened_size = size;
+		states_[scene.scene.index] = state::done;
+	}
+
+} // docs_gen_core
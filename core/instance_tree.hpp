@@ -0,0 +1,102 @@
+#ifndef DOCS_GEN_INSTANCE_TREE_H
+#define DOCS_GEN_INSTANCE_TREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "handle.hpp"
+#include "node.hpp"
+#include "project.hpp"
+
+namespace docs_gen_core {
+
+	// Expanded view of scene trees with instanced scenes inlined. Each scene is expanded once
+	// and memoized; a PackedScene node points at the expansion of the scene it instances
+	// instead of holding a copy, so a prefab used n times costs one expansion plus n pointers
+	// and the whole view is linear in the number of nodes the project actually contains.
+	// A scene that ends up instancing itself is cut at the node that closes the cycle.
+	// Expanding is single threaded, the expanded scenes are immutable and safe to read afterwards
+	class instance_expander {
+	public:
+		struct expanded_scene;
+
+		struct expanded_node {
+			const node_tree::tree_node* node = nullptr;
+			// expansion of the instanced scene, nullptr for plain nodes and cut instances
+			const expanded_scene* instance = nullptr;
+			bool cycle = false;
+		};
+
+		struct expanded_scene {
+			scene_handle scene;
+			// the scene's own nodes in node_tree order
+			std::vector<expanded_node> nodes;
+			// nodes in the fully flattened tree, saturates instead of overflowing
+			std::uint64_t flattened_size = 0;
+		};
+
+	private:
+		enum class state : std::uint8_t { unvisited, expanding, done };
+
+		const project& project_;
+		std::vector<std::unique_ptr<expanded_scene>> expanded_;
+		std::vector<state> states_;
+		std::size_t cycles_ = 0;
+
+	public:
+		explicit instance_expander(const project& project);
+		instance_expander(const instance_expander& other) = delete;
+		instance_expander(instance_expander&& other) = delete;
+		~instance_expander() = default;
+
+		instance_expander& operator=(const instance_expander& other) = delete;
+		instance_expander& operator=(instance_expander&& other) = delete;
+
+		// Expands scene and every scene it instances, already expanded scenes are reused
+		const expanded_scene& expand(scene_handle scene);
+		// nullptr if scene has not been expanded
+		[[nodiscard]] const expanded_scene* find(scene_handle scene) const;
+		// Instance nodes cut so far because they would have closed a cycle
+		[[nodiscard]] std::size_t get_cycle_count() const { return cycles_; }
+
+		// Walks the flattened tree in pre-order, calling visitor(const tree_node&, std::size_t depth).
+		// An instance node stands for the root of the scene it instances: it is visited with the
+		// instanced root merged in, its type and, unless root_fields is false, its resource fields,
+		// the instance node's own fields overriding the root's. The merged node has no parent or
+		// children. The instanced root's children are visited one level below the instance node
+		template <typename Visitor>
+		static void visit(const expanded_scene& scene, Visitor&& visitor, bool root_fields = true) {
+			visit_(scene, visitor, 0, false, root_fields);
+		}
+
+	private:
+		void begin(scene_handle scene);
+		void finish(expanded_scene& scene);
+
+		template <typename Visitor>
+		static void visit_(const expanded_scene& scene, Visitor& visitor, std::size_t offset, bool skip_root, bool root_fields) {
+			if (skip_root && !scene.nodes.empty() && scene.nodes[0].instance) {
+				// an inherited scene, the children of its base come first
+				visit_(*scene.nodes[0].instance, visitor, offset, true, root_fields);
+			}
+			for (std::size_t i = skip_root ? 1 : 0; i < scene.nodes.size(); ++i) {
+				const auto& n = scene.nodes[i];
+				const auto depth = offset + n.node->depth;
+				if (n.instance) {
+					visitor(merge_root_(*n.node, *n.instance, root_fields), depth);
+					visit_(*n.instance, visitor, depth - 1, true, root_fields);
+				}
+				else {
+					visitor(*n.node, depth);
+				}
+			}
+		}
+
+		static node_tree::tree_node merge_root_(const node_tree::tree_node& node, const expanded_scene& scene, bool root_fields);
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_INSTANCE_TREE_H
@@ -0,0 +1,209 @@
+#include "lexer.hpp"
+
+namespace docs_gen_core {
+
+	namespace {
+
+		bool is_blank(char c) {
+			return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+		}
+
+		std::size_t skip_blank(std::string_view s, std::size_t pos) {
+			while (pos < s.size() && is_blank(s[pos])) ++pos;
+			return pos;
+		}
+
+		std::size_t skip_line(std::string_view s, std::size_t pos) {
+			const auto end = s.find('\n', pos);
+			return end == std::string_view::npos ? s.size() : end + 1;
+		}
+
+		// pos points at the opening quote, returns the position past the closing one
+		std::size_t skip_string(std::string_view s, std::size_t pos) {
+			for (++pos; pos < s.size(); ++pos) {
+				if (s[pos] == '\\') {
+					++pos;
+				}
+				else if (s[pos] == '"') {
+					return pos + 1;
+				}
+			}
+			return s.size();
+		}
+
+		// Scans a value up to the first newline (or whitespace if stop_at_space) that is
+		// not nested inside brackets or a string
+		std::size_t skip_value(std::string_view s, std::size_t pos, bool stop_at_space) {
+			std::size_t depth = 0;
+			while (pos < s.size()) {
+				const char c = s[pos];
+				if (c == '"') {
+					pos = skip_string(s, pos);
+					continue;
+				}
+
+				if (c == '(' || c == '[' || c == '{') {
+					++depth;
+				}
+				else if (c == ')' || c == ']' || c == '}') {
+					if (depth > 0) --depth;
+				}
+				else if (depth == 0 && (c == '\n' || (stop_at_space && is_blank(c)))) {
+					return pos;
+				}
+				++pos;
+			}
+			return pos;
+		}
+
+		// pos points at an opening bracket, returns the position of the matching closing one
+		std::size_t find_closing(std::string_view s, std::size_t pos) {
+			std::size_t depth = 0;
+			while (pos < s.size()) {
+				const char c = s[pos];
+				if (c == '"') {
+					pos = skip_string(s, pos);
+					continue;
+				}
+
+				if (c == '(' || c == '[' || c == '{') {
+					++depth;
+				}
+				else if (c == ')' || c == ']' || c == '}') {
+					if (--depth == 0) return pos;
+				}
+				++pos;
+			}
+			return s.size();
+		}
+
+	} // anonymous
+
+	dott_lexer::dott_lexer()
+		: pos_(0) {
+	}
+
+	dott_lexer::dott_lexer(std::string_view src)
+		: src_(src), pos_(0) {
+	}
+
+	void dott_lexer::reset(std::string_view src) {
+		src_ = src;
+		pos_ = 0;
+	}
+
+	bool dott_lexer::next_section(std::string_view& heading) {
+		while (true) {
+			pos_ = skip_blank(src_, pos_);
+			if (pos_ >= src_.size())
+				return false;
+
+			const char c = src_[pos_];
+			if (c == '[') {
+				const auto close = find_closing(src_, pos_);
+				heading = src_.substr(pos_ + 1, close - pos_ - 1);
+				pos_ = close < src_.size() ? skip_line(src_, close) : close;
+				return true;
+			}
+
+			if (c == ';') {
+				pos_ = skip_line(src_, pos_);
+				continue;
+			}
+
+			property p;
+			next_property(p);
+		}
+	}
+
+	bool dott_lexer::next_property(property& p) {
+		while (true) {
+			pos_ = skip_blank(src_, pos_);
+			if (pos_ >= src_.size() || src_[pos_] == '[')
+				return false;
+
+			const auto line_end = skip_line(src_, pos_);
+			const auto eq = src_.substr(0, line_end).find('=', pos_);
+			if (src_[pos_] == ';' || eq == std::string_view::npos) {
+				pos_ = line_end;
+				continue;
+			}
+
+			auto start = eq + 1;
+			while (start < src_.size() && (src_[start] == ' ' || src_[start] == '\t')) ++start;
+			const auto end = skip_value(src_, start, false);
+
+			p.key = trim(src_.substr(pos_, eq - pos_));
+			p.value = trim(src_.substr(start, end - start));
+			pos_ = end;
+			return true;
+		}
+	}
+
+	void dott_lexer::record(dott_entries& out) {
+		const auto append = [&out](std::string_view s) {
+			const dott_entries::range r{ static_cast<std::uint32_t>(out.text.size()), static_cast<std::uint32_t>(s.size()) };
+			out.text.append(s);
+			return r;
+		};
+
+		std::string_view heading;
+		property p;
+		while (next_section(heading)) {
+			dott_entries::section section{ append(heading), static_cast<std::uint32_t>(out.properties.size()), 0 };
+			while (next_property(p)) {
+				out.properties.push_back({ append(p.key), append(p.value) });
+				++section.property_count;
+			}
+			out.sections.push_back(section);
+		}
+	}
+
+	bool dott_lexer::next_attribute(std::string_view& heading, property& attr) {
+		const auto start = skip_blank(heading, 0);
+		if (start >= heading.size()) {
+			heading = {};
+			return false;
+		}
+
+		const auto end = skip_value(heading, start, true);
+		const auto token = heading.substr(start, end - start);
+		heading.remove_prefix(end);
+
+		const auto eq = token.find('=');
+		if (eq == std::string_view::npos) {
+			attr.key = token;
+			attr.value = {};
+		}
+		else {
+			attr.key = token.substr(0, eq);
+			attr.value = token.substr(eq + 1);
+		}
+		return true;
+	}
+
+	std::string_view dott_lexer::trim(std::string_view s) {
+		while (!s.empty() && is_blank(s.front())) s.remove_prefix(1);
+		while (!s.empty() && is_blank(s.back())) s.remove_suffix(1);
+		return s;
+	}
+
+	std::string_view dott_lexer::unquote(std::string_view s) {
+		if (s.size() >= 2 && s.front() == '"' && s.back() == '"') {
+			return s.substr(1, s.size() - 2);
+		}
+		return s;
+	}
+
+	bool dott_lexer::call_argument(std::string_view value, std::string_view callee, std::string_view& arg) {
+		value = trim(value);
+		if (value.size() < callee.size() + 2 || value.compare(0, callee.size(), callee) != 0
+			|| value[callee.size()] != '(' || value.back() != ')') {
+			return false;
+		}
+
+		arg = unquote(trim(value.substr(callee.size() + 1, value.size() - callee.size() - 2)));
+		return true;
+	}
+
+} // docs_gen_core
@@ -0,0 +1,73 @@
+#ifndef DOCS_GEN_LEXER_H
+#define DOCS_GEN_LEXER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace docs_gen_core {
+
+	// Every section and property of a file, lexed up front so it can be kept without the
+	// source, e.g. in the parse cache. Keys and values are ranges of text
+	struct dott_entries {
+		struct range {
+			std::uint32_t begin;
+			std::uint32_t size;
+		};
+		struct pair {
+			range key;
+			range value;
+		};
+		struct section {
+			range heading;
+			std::uint32_t first_property;
+			std::uint32_t property_count;
+		};
+
+		std::string text;
+		std::vector<section> sections;
+		std::vector<pair> properties;
+
+		[[nodiscard]] std::string_view view(range r) const { return std::string_view{ text }.substr(r.begin, r.size); }
+	};
+
+	// Streaming lexer over the text of a .tscn / .tres file. Sections ("[...]") and
+	// their "key = value" properties are returned as views into the source buffer,
+	// values may span several lines as long as brackets or quotes are left open.
+	class dott_lexer {
+	public:
+		struct property {
+			std::string_view key;
+			std::string_view value;
+		};
+
+	private:
+		std::string_view src_;
+		std::size_t pos_;
+
+	public:
+		dott_lexer();
+		explicit dott_lexer(std::string_view src);
+
+		void reset(std::string_view src);
+
+		// Moves to the next section header, skipping whatever is left of the current one.
+		// heading is the text between the brackets
+		bool next_section(std::string_view& heading);
+		// Returns the next property of the current section, false once the section ends
+		bool next_property(property& p);
+		// Lexes everything from the current position on, comments and blank lines are dropped
+		void record(dott_entries& out);
+
+		// Pops the next "key=value" (or bare "key") attribute off a section heading
+		static bool next_attribute(std::string_view& heading, property& attr);
+		static std::string_view trim(std::string_view s);
+		static std::string_view unquote(std::string_view s);
+		// Extracts the argument of a call-like value, e.g. ExtResource("1_abc") -> 1_abc
+		static bool call_argument(std::string_view value, std::string_view callee, std::string_view& arg);
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_LEXER_H
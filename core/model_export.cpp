@@ -0,0 +1,519 @@
+#include "model_export.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace docs_gen_core {
+
+	namespace {
+
+		constexpr std::size_t flush_size = 1 << 20;
+		// id of a link to nothing
+		constexpr std::uint32_t no_file = handle<file>::invalid;
+
+		void append_utf8(std::string& out, std::uint32_t c) {
+			if (c < 0x80) {
+				out.push_back(static_cast<char>(c));
+			}
+			else if (c < 0x800) {
+				out.push_back(static_cast<char>(0xC0 | (c >> 6)));
+				out.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+			}
+			else if (c < 0x10000) {
+				out.push_back(static_cast<char>(0xE0 | (c >> 12)));
+				out.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+				out.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+			}
+			else {
+				out.push_back(static_cast<char>(0xF0 | (c >> 18)));
+				out.push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+				out.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+				out.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+			}
+		}
+
+		// Calls fn(code point) for s, UTF-16 surrogate pairs (wchar_t on Windows) are joined and
+		// anything that is not a code point becomes U+FFFD
+		template <typename Fn>
+		void for_each_code_point(std::wstring_view s, Fn&& fn) {
+			for (std::size_t i = 0; i < s.size(); ++i) {
+				auto c = static_cast<std::uint32_t>(s[i]);
+				if (c >= 0xD800 && c < 0xDC00 && i + 1 < s.size()) {
+					const auto low = static_cast<std::uint32_t>(s[i + 1]);
+					if (low >= 0xDC00 && low < 0xE000) {
+						c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+						++i;
+					}
+				}
+				if ((c >= 0xD800 && c < 0xE000) || c > 0x10FFFF) {
+					c = 0xFFFD;
+				}
+				fn(c);
+			}
+		}
+
+		// Buffers the output and writes it in large blocks to a temporary file
+		class sink {
+			std::filesystem::path path_;
+			std::filesystem::path temp_;
+			std::ofstream out_;
+			std::string buffer_;
+
+		public:
+			explicit sink(const std::filesystem::path& path) : path_(path), temp_(path) {
+				temp_ += ".tmp";
+				out_.open(temp_, std::ios::out | std::ios::binary | std::ios::trunc);
+				buffer_.reserve(flush_size + flush_size / 4);
+			}
+
+			[[nodiscard]] bool is_open() const { return out_.is_open(); }
+			[[nodiscard]] std::string& buffer() { return buffer_; }
+
+			void flush_if_full() {
+				if (buffer_.size() >= flush_size) {
+					flush();
+				}
+			}
+
+			bool close() {
+				flush();
+				out_.close();
+				std::error_code ec;
+				if (out_) {
+					std::filesystem::rename(temp_, path_, ec);
+					if (!ec)
+						return true;
+				}
+				std::filesystem::remove(temp_, ec);
+				return false;
+			}
+
+		private:
+			void flush() {
+				out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+				buffer_.clear();
+			}
+		};
+
+		// One JSON object per record and line. Commas are placed by remembering whether the
+		// current object or array already has an element
+		class json_writer {
+			std::string& out_;
+			bool first_ = true;
+
+		public:
+			explicit json_writer(std::string& out) : out_(out) {}
+
+			void begin_record(std::string_view kind, std::uint8_t) {
+				out_.append(R"({"kind":")").append(kind).push_back('"');
+				first_ = false;
+			}
+			void end_record() {
+				out_.append("}\n");
+				first_ = true;
+			}
+
+			void string(std::string_view name, std::wstring_view value) {
+				separate(name);
+				out_.push_back('"');
+				for_each_code_point(value, [this](std::uint32_t c) {
+					switch (c) {
+					case '"': out_.append("\\\""); break;
+					case '\\': out_.append("\\\\"); break;
+					case '\n': out_.append("\\n"); break;
+					case '\r': out_.append("\\r"); break;
+					case '\t': out_.append("\\t"); break;
+					default:
+						if (c < 0x20) {
+							static constexpr char hex[] = "0123456789abcdef";
+							out_.append("\\u00");
+							out_.push_back(hex[c >> 4]);
+							out_.push_back(hex[c & 0xF]);
+						}
+						else {
+							append_utf8(out_, c);
+						}
+					}
+				});
+				out_.push_back('"');
+			}
+			void number(std::string_view name, std::uint64_t value) {
+				separate(name);
+				char digits[20];
+				const auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+				out_.append(digits, static_cast<std::size_t>(end - digits));
+			}
+			void boolean(std::string_view name, bool value) {
+				separate(name);
+				out_.append(value ? "true" : "false");
+			}
+			void link(std::string_view name, std::uint32_t id) {
+				if (id == no_file) {
+					separate(name);
+					out_.append("null");
+				}
+				else {
+					number(name, id);
+				}
+			}
+
+			void begin_array(std::string_view name, std::size_t) {
+				separate(name);
+				out_.push_back('[');
+				first_ = true;
+			}
+			void end_array() {
+				out_.push_back(']');
+				first_ = false;
+			}
+			void begin_object(std::string_view name) {
+				separate(name);
+				out_.push_back('{');
+				first_ = true;
+			}
+			void end_object() {
+				out_.push_back('}');
+				first_ = false;
+			}
+
+		private:
+			// name is empty for array elements
+			void separate(std::string_view name) {
+				if (!first_) {
+					out_.push_back(',');
+				}
+				first_ = false;
+				if (!name.empty()) {
+					out_.push_back('"');
+					out_.append(name);
+					out_.append("\":");
+				}
+			}
+		};
+
+		// The records of json_writer without keys or punctuation, see model_exporter
+		class binary_writer {
+			std::string& out_;
+			std::string scratch_;
+
+		public:
+			explicit binary_writer(std::string& out) : out_(out) {}
+
+			void begin_record(std::string_view, std::uint8_t kind) { out_.push_back(static_cast<char>(kind)); }
+			void end_record() {}
+
+			void string(std::string_view, std::wstring_view value) {
+				scratch_.clear();
+				for_each_code_point(value, [this](std::uint32_t c) { append_utf8(scratch_, c); });
+				put(scratch_.size());
+				out_.append(scratch_);
+			}
+			void number(std::string_view, std::uint64_t value) { put(value); }
+			void boolean(std::string_view, bool value) { out_.push_back(value ? 1 : 0); }
+			void link(std::string_view, std::uint32_t id) {
+				put(id == no_file ? 0 : std::uint64_t{ id } + 1);
+			}
+
+			void begin_array(std::string_view, std::size_t count) { put(count); }
+			void end_array() {}
+			void begin_object(std::string_view) {}
+			void end_object() {}
+
+		private:
+			void put(std::uint64_t value) {
+				while (value >= 0x80) {
+					out_.push_back(static_cast<char>((value & 0x7F) | 0x80));
+					value >>= 7;
+				}
+				out_.push_back(static_cast<char>(value));
+			}
+		};
+
+		// External resources of a scene or resource from its four tables, sorted by id so the
+		// output does not depend on hash order
+		struct ext_resource {
+			const std::wstring* key;
+			file_ref target;
+			const ext_resource_other* other;
+		};
+
+		std::vector<ext_resource> ext_resources_of(const dott_file& file) {
+			std::vector<ext_resource> out;
+			out.reserve(file.get_packed_scenes().size() + file.get_ext_resources().size() + file.get_scripts().size()
+				+ file.get_ext_resource_other().size());
+			for (const auto& [key, h] : file.get_packed_scenes()) out.push_back({ &key, h, nullptr });
+			for (const auto& [key, h] : file.get_ext_resources()) out.push_back({ &key, h, nullptr });
+			for (const auto& [key, h] : file.get_scripts()) out.push_back({ &key, h, nullptr });
+			for (const auto& [key, other] : file.get_ext_resource_other()) out.push_back({ &key, {}, &other });
+			std::sort(out.begin(), out.end(), [](const auto& a, const auto& b) { return *a.key < *b.key; });
+			return out;
+		}
+
+		struct file_ids {
+			std::uint32_t scenes;
+			std::uint32_t resources;
+
+			[[nodiscard]] std::uint32_t operator()(file_ref ref) const {
+				switch (ref.kind) {
+				case file_kind::scene: return ref.index;
+				case file_kind::resource: return scenes + ref.index;
+				case file_kind::script: return scenes + resources + ref.index;
+				default: return no_file;
+				}
+			}
+		};
+
+		template <typename Writer>
+		void write_ext_resources(Writer& writer, const project_view& view, const file_ids& id_of, const dott_file& file) {
+			const auto resources = ext_resources_of(file);
+			writer.begin_array("ext_resources", resources.size());
+			for (const auto& e : resources) {
+				writer.begin_object({});
+				writer.string("id", *e.key);
+				writer.link("file", id_of(e.target));
+				writer.string("type", e.other ? std::wstring_view{ e.other->type } : std::wstring_view{});
+				writer.string("path", e.other ? e.other->path.generic_wstring() : view.res_path_of(e.target));
+				writer.end_object();
+			}
+			writer.end_array();
+		}
+
+		template <typename Writer>
+		void write_dependencies(Writer& writer, const project_view& view, file_ref ref, std::vector<std::uint32_t>& scratch) {
+			const auto targets = view.dependencies_of(ref);
+			scratch.assign(targets.begin(), targets.end());
+			std::sort(scratch.begin(), scratch.end());
+			scratch.erase(std::unique(scratch.begin(), scratch.end()), scratch.end());
+			writer.begin_array("dependencies", scratch.size());
+			for (const auto id : scratch) {
+				writer.link({}, id);
+			}
+			writer.end_array();
+		}
+
+		template <typename Writer>
+		void write_nodes(Writer& writer, const file_ids& id_of, const scene_file& file, std::vector<std::uint32_t>& parents) {
+			const auto* root = file.get_node_tree().get_root();
+			std::size_t count = 0;
+			if (root) {
+				project_view::visit_nodes(*root, [&](const node_tree::tree_node&, std::size_t) { ++count; });
+			}
+
+			writer.begin_array("nodes", count);
+			if (root) {
+				// parents[depth] is the index of the last node seen at that depth
+				parents.clear();
+				std::uint32_t index = 0;
+				project_view::visit_nodes(*root, [&](const node_tree::tree_node& node, std::size_t depth) {
+					parents.resize(depth + 1);
+					parents[depth] = index++;
+					writer.begin_object({});
+					writer.string("name", node.name);
+					writer.string("type", node.type);
+					writer.link("parent", depth == 0 ? no_file : parents[depth - 1]);
+					writer.link("instance", id_of(node.instance));
+					writer.begin_array("ext_fields", node.ext_resource_fields.size());
+					for (const auto& [name, target] : node.ext_resource_fields) {
+						writer.begin_object({});
+						writer.string("name", name);
+						writer.link("file", id_of(target));
+						writer.end_object();
+					}
+					writer.end_array();
+					writer.begin_array("sub_fields", node.sub_resource_fields.size());
+					for (const auto& [name, value] : node.sub_resource_fields) {
+						writer.begin_object({});
+						writer.string("name", name);
+						writer.string("value", value);
+						writer.end_object();
+					}
+					writer.end_array();
+					writer.end_object();
+				});
+			}
+			writer.end_array();
+		}
+
+		template <typename Writer>
+		void write_fields(Writer& writer, std::string_view name, const std::vector<resource_file::resource::field>& fields) {
+			writer.begin_array(name, fields.size());
+			for (const auto& f : fields) {
+				writer.begin_object({});
+				writer.string("name", f.name);
+				writer.string("value", f.value);
+				writer.end_object();
+			}
+			writer.end_array();
+		}
+
+		template <typename Writer>
+		void write_resource(Writer& writer, const file_ids& id_of, std::string_view name, const resource_file::resource& res) {
+			writer.begin_object(name);
+			writer.string("type", res.type);
+			writer.begin_array("ext_fields", res.res_file_fields.size());
+			for (const auto& f : res.res_file_fields) {
+				writer.begin_object({});
+				writer.string("name", f.name);
+				writer.link("file", id_of(f.target));
+				writer.end_object();
+			}
+			writer.end_array();
+			write_fields(writer, "other_fields", res.res_other_fields);
+			writer.begin_array("sub_fields", res.sub_res_fields.size());
+			for (const auto& f : res.sub_res_fields) {
+				writer.begin_object({});
+				writer.string("name", f.name);
+				writer.number("index", f.index);
+				writer.end_object();
+			}
+			writer.end_array();
+			write_fields(writer, "fields", res.fields);
+			writer.end_object();
+		}
+
+		template <typename Writer>
+		void write_variables(Writer& writer, std::string_view name, const std::vector<script_class::variable>& variables) {
+			writer.begin_array(name, variables.size());
+			for (const auto& v : variables) {
+				writer.begin_object({});
+				writer.string("name", v.name);
+				writer.string("type", v.type);
+				writer.string("description", v.short_desc);
+				writer.end_object();
+			}
+			writer.end_array();
+		}
+
+		template <typename Writer>
+		void write_class(Writer& writer, const script_class& c) {
+			writer.begin_object("class");
+			writer.string("name", c.name);
+			writer.string("parent", c.parent);
+			writer.boolean("public", c.is_public);
+			writer.begin_array("tags", c.tags.size());
+			for (const auto& tag : c.tags) {
+				writer.string({}, tag);
+			}
+			writer.end_array();
+			writer.string("description", c.short_desc);
+			writer.begin_array("exports", c.categories.size());
+			for (const auto& category : c.categories) {
+				writer.begin_object({});
+				writer.string("category", category.name);
+				write_variables(writer, "variables", category.variables);
+				writer.end_object();
+			}
+			writer.end_array();
+			writer.begin_array("functions", c.functions.size());
+			for (const auto& f : c.functions) {
+				writer.begin_object({});
+				writer.string("name", f.name);
+				writer.string("description", f.short_desc);
+				write_variables(writer, "arguments", f.arguments);
+				writer.string("return_type", f.return_type);
+				writer.end_object();
+			}
+			writer.end_array();
+			writer.end_object();
+		}
+
+		template <typename Writer>
+		void write_records(Writer& writer, sink& out, const project_view& view) {
+			const file_ids id_of{ static_cast<std::uint32_t>(view.scenes().size()), static_cast<std::uint32_t>(view.resources().size()) };
+
+			writer.begin_record("project", 0);
+			writer.number("format", model_exporter::format_version);
+			writer.string("root", view.root().generic_wstring());
+			writer.number("files", view.size());
+			writer.number("scenes", view.scenes().size());
+			writer.number("resources", view.resources().size());
+			writer.number("scripts", view.scripts().size());
+			writer.end_record();
+
+			std::vector<std::uint32_t> scratch;
+			for (std::uint32_t i = 0; i < view.scenes().size(); ++i) {
+				const auto& file = view.scenes()[i];
+				const file_ref ref = scene_handle{ i };
+				writer.begin_record("scene", 1);
+				writer.number("id", id_of(ref));
+				writer.string("path", view.res_path_of(file));
+				writer.string("uid", file.get_uid());
+				write_ext_resources(writer, view, id_of, file);
+				write_dependencies(writer, view, ref, scratch);
+				write_nodes(writer, id_of, file, scratch);
+				writer.end_record();
+				out.flush_if_full();
+			}
+			for (std::uint32_t i = 0; i < view.resources().size(); ++i) {
+				const auto& file = view.resources()[i];
+				const file_ref ref = resource_handle{ i };
+				writer.begin_record("resource", 2);
+				writer.number("id", id_of(ref));
+				writer.string("path", view.res_path_of(file));
+				writer.string("uid", file.get_uid());
+				writer.string("script_class", file.get_script_class());
+				write_ext_resources(writer, view, id_of, file);
+				write_dependencies(writer, view, ref, scratch);
+				write_resource(writer, id_of, "resource", file.get_resource());
+				writer.begin_array("sub_resources", file.get_sub_resources().size());
+				for (const auto& res : file.get_sub_resources()) {
+					write_resource(writer, id_of, {}, res);
+				}
+				writer.end_array();
+				writer.end_record();
+				out.flush_if_full();
+			}
+			for (std::uint32_t i = 0; i < view.scripts().size(); ++i) {
+				const auto& file = view.scripts()[i];
+				const file_ref ref = script_handle{ i };
+				writer.begin_record("script", 3);
+				writer.number("id", id_of(ref));
+				writer.string("path", view.res_path_of(file));
+				write_dependencies(writer, view, ref, scratch);
+				write_class(writer, file.get_script_class());
+				writer.end_record();
+				out.flush_if_full();
+			}
+		}
+
+	} // anonymous
+
+	model_exporter::model_exporter(const project_view& view)
+		: view_(view) {
+	}
+
+	bool model_exporter::write(const std::filesystem::path& path, export_format format) const {
+		sink out{ path };
+		if (!out.is_open()) {
+			std::cerr << "[ERROR] could not write the model export: " << path << '\n';
+			return false;
+		}
+
+		if (format == export_format::binary) {
+			auto& buffer = out.buffer();
+			buffer.append("GDPM");
+			for (int i = 0; i < 4; ++i) {
+				buffer.push_back(static_cast<char>((format_version >> (8 * i)) & 0xFF));
+			}
+			binary_writer writer{ buffer };
+			write_records(writer, out, view_);
+		}
+		else {
+			json_writer writer{ out.buffer() };
+			write_records(writer, out, view_);
+		}
+
+		if (!out.close()) {
+			std::cerr << "[ERROR] could not write the model export: " << path << '\n';
+			return false;
+		}
+		std::cout << "[INFO] Exported " << view_.size() << " files to " << path << '\n';
+		return true;
+	}
+
+} // docs_gen_core
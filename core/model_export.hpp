@@ -0,0 +1,61 @@
+#ifndef DOCS_GEN_MODEL_EXPORT_H
+#define DOCS_GEN_MODEL_EXPORT_H
+
+#include <cstdint>
+#include <filesystem>
+
+#include "project_view.hpp"
+
+namespace docs_gen_core {
+
+	enum class export_format {
+		jsonl,
+		binary,
+	};
+
+	// Writes the parsed model of a project for tools that want the data rather than the docs:
+	// files, uids, node trees, external and sub-resource links and script classes. Records are
+	// serialized straight from the model, one file at a time, without building a document first.
+	//
+	// Files are numbered scenes first, then resources, then scripts (the dependency_graph ids),
+	// and links between files use those numbers. A project record comes first, then one record
+	// per file:
+	//   {"kind":"project","format":1,"root":"...","files":n,"scenes":n,"resources":n,"scripts":n}
+	//   {"kind":"scene","id":0,"path":"res://...","uid":"uid://...","ext_resources":[...],
+	//    "dependencies":[ids],"nodes":[{"name","type","parent","instance","ext_fields","sub_fields"}]}
+	//   {"kind":"resource","id":1,"path","uid","script_class","ext_resources","dependencies",
+	//    "resource":{"type","ext_fields","other_fields","sub_fields","fields"},"sub_resources":[...]}
+	//   {"kind":"script","id":2,"path","dependencies","class":{"name","parent","public","tags",
+	//    "description","exports":[{"category","variables"}],"functions":[...]}}
+	// "parent" is the index of the parent node in "nodes", nodes are in pre-order. Missing links
+	// are null. dependencies are empty unless the index was built (dir::build_index).
+	//
+	// jsonl writes each record as one line of JSON. binary writes "GDPM", the format version
+	// (u32 little endian) and then the same records with the same fields in the same order,
+	// without keys: the record kind as one byte (1 scene, 2 resource, 3 script, 0 project),
+	// unsigned numbers as LEB128, file links as LEB128 of id + 1 (0 for none), booleans as a
+	// byte, strings as LEB128 byte length and UTF-8, arrays as LEB128 count and their elements.
+	//
+	// Files whose contents were released (streaming) or never parsed (outside the entries) only
+	// have their path and uid. The file is written under a temporary name and renamed when done
+	class model_exporter {
+		const project_view& view_;
+
+	public:
+		static constexpr std::uint32_t format_version = 1;
+
+		explicit model_exporter(const project_view& view);
+		model_exporter(const model_exporter& other) = delete;
+		model_exporter(model_exporter&& other) = delete;
+		~model_exporter() = default;
+
+		model_exporter& operator=(const model_exporter& other) = delete;
+		model_exporter& operator=(model_exporter&& other) = delete;
+
+		// false if the file could not be written
+		bool write(const std::filesystem::path& path, export_format format) const;
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_MODEL_EXPORT_H
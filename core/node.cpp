@@ -13,54 +13,6 @@ namespace docs_gen_core {
         : name(name), type(type), depth(0), parent(parent) {
     }
 
-    node_tree::tree_node::tree_node(const tree_node& other)
-        : name(other.name), type(other.type), path(other.path), depth(other.depth),
-        parent(other.parent), children(other.children) {
-    }
-
-    node_tree::tree_node::tree_node(tree_node&& other) noexcept
-        : name(std::move(other.name)), type(std::move(other.type)), path(std::move(other.path)),
-        depth(other.depth), parent(std::move(other.parent)), children(std::move(other.children)) {
-     }
-
-    node_tree::tree_node& node_tree::tree_node::operator=(const tree_node& other) {
-        name = other.name;
-        type = other.type;
-        path = other.path;
-        depth = other.depth;
-        parent = other.parent;
-        children = other.children;
-        return *this;
-    }
-
-    node_tree::tree_node& node_tree::tree_node::operator=(tree_node&& other) noexcept {
-        name = std::move(other.name);
-        type = std::move(other.type);
-        path = std::move(other.path);
-        depth = other.depth;
-        parent = std::move(other.parent);
-        children = std::move(other.children);
-        return *this;
-    }
-
-    node_tree::node_tree(const node_tree& other)
-        : root_(other.root_) {
-    }
-
-    node_tree::node_tree(node_tree&& other) noexcept
-        : root_(std::move(other.root_)) {
-    }
-
-    node_tree& node_tree::operator=(const node_tree& other) {
-        root_ = other.root_;
-        return *this;
-    }
-
-    node_tree& node_tree::operator=(node_tree&& other) noexcept {
-        root_ = std::move(other.root_);
-        return *this;
-    }
-
     node_tree::iterator node_tree::begin() {
         return iterator(root_);
     }
@@ -69,6 +21,14 @@ namespace docs_gen_core {
         return {};
     }
 
+    node_tree::iterator node_tree::begin() const {
+        return iterator(root_);
+    }
+
+    node_tree::iterator node_tree::end() const {
+        return {};
+    }
+
     node_tree::iterator node_tree::insert(const std::wstring& name, const std::wstring& type) {
         return insert(name, type, {});
     }
@@ -114,6 +74,11 @@ namespace docs_gen_core {
 
     node_tree::iterator::iterator(const std::shared_ptr<tree_node>& node)
         : path_(""), current_(node) {
+        // a tree that was never parsed has no root and is empty
+        if (!current_) {
+            return;
+        }
+
         for (auto it = current_->children.rbegin(); it != current_->children.rend(); ++it) {
             stack_.push(*it);
         }
@@ -7,10 +7,10 @@
 #include <string>
 #include <vector>
 
+#include "handle.hpp"
+
 namespace docs_gen_core {
 
-    class file;
-    
     class node_tree {
     public:
         class iterator;
@@ -23,34 +23,42 @@ namespace docs_gen_core {
             std::size_t depth;
             std::weak_ptr<tree_node> parent;
             std::vector<std::shared_ptr<tree_node>> children;
-            std::vector<std::pair<std::wstring, std::weak_ptr<file>>> ext_resource_fields;
+            std::vector<std::pair<std::wstring, file_ref>> ext_resource_fields;
+            // the scene a PackedScene node instances
+            scene_handle instance;
             std::vector<std::pair<std::wstring, std::wstring>> sub_resource_fields;
 
             tree_node(const std::wstring& name, const std::wstring& type);
             tree_node(const std::wstring& name, const std::wstring& type, const std::weak_ptr<tree_node>& parent);
-            tree_node(const tree_node& other);
-            tree_node(tree_node&& other) noexcept;
+            tree_node(const tree_node& other) = delete;
+            tree_node(tree_node&& other) noexcept = default;
             ~tree_node() = default;
 
-            tree_node& operator=(const tree_node& other);
-            tree_node& operator=(tree_node&& other) noexcept;
+            tree_node& operator=(const tree_node& other) = delete;
+            tree_node& operator=(tree_node&& other) noexcept = default;
         };
         
     private:
         std::shared_ptr<tree_node> root_;
 
     public:
+        // Owns its nodes, a copy would only share them, so the tree is move-only
         node_tree() = default;
-        node_tree(const node_tree& other);
-        node_tree(node_tree&& other) noexcept;
+        node_tree(const node_tree& other) = delete;
+        node_tree(node_tree&& other) noexcept = default;
         ~node_tree() = default;
 
-        node_tree& operator=(const node_tree& other);
-        node_tree& operator=(node_tree&& other) noexcept;
+        node_tree& operator=(const node_tree& other) = delete;
+        node_tree& operator=(node_tree&& other) noexcept = default;
 
         iterator begin();
         iterator end();
+        iterator begin() const;
+        iterator end() const;
         
+        // nullptr for a tree that was never parsed
+        [[nodiscard]] const tree_node* get_root() const { return root_.get(); }
+
         iterator insert(const std::wstring& name, const std::wstring& type);
         iterator insert(const std::wstring& name, const std::wstring& type, const std::wstring& parent);
 
@@ -0,0 +1,415 @@
+#include "parse_cache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+#include "util/util.hpp"
+
+namespace docs_gen_core {
+
+	namespace {
+
+		// Cached files are "GDPC", the parser version, the kind ('s'cript or 'd'ott entries),
+		// the content key (SHA-256 digest and size) and the payload size, followed by the
+		// payload. Integers are little endian, strings are a length followed by their characters
+		constexpr std::string_view magic = "GDPC";
+		constexpr std::size_t header_size = 4 + 4 + 1 + 32 + 8 + 8;
+
+		class writer {
+			std::string& out_;
+
+		public:
+			explicit writer(std::string& out) : out_(out) {}
+
+			void u8(std::uint8_t v) { out_.push_back(static_cast<char>(v)); }
+
+			void u32(std::uint32_t v) {
+				for (int i = 0; i < 4; ++i) u8(static_cast<std::uint8_t>(v >> (i * 8)));
+			}
+
+			void u64(std::uint64_t v) {
+				for (int i = 0; i < 8; ++i) u8(static_cast<std::uint8_t>(v >> (i * 8)));
+			}
+
+			// LEB128, text is mostly ASCII so most characters take one byte
+			void varint(std::uint64_t v) {
+				while (v >= 0x80) {
+					u8(static_cast<std::uint8_t>(v | 0x80));
+					v >>= 7;
+				}
+				u8(static_cast<std::uint8_t>(v));
+			}
+
+			void str(std::string_view s) {
+				varint(s.size());
+				out_.append(s);
+			}
+
+			void digest(const std::array<std::uint8_t, 32>& d) {
+				out_.append(reinterpret_cast<const char*>(d.data()), d.size());
+			}
+
+			void wstr(std::wstring_view s) {
+				varint(s.size());
+				for (const auto c : s) varint(static_cast<std::uint32_t>(c));
+			}
+
+			void range(dott_entries::range r) {
+				u32(r.begin);
+				u32(r.size);
+			}
+		};
+
+		// Every read checks the bounds, a truncated or foreign file fails instead of crashing
+		class reader {
+			std::string_view in_;
+
+		public:
+			explicit reader(std::string_view in) : in_(in) {}
+
+			[[nodiscard]] bool done() const { return in_.empty(); }
+
+			bool u8(std::uint8_t& v) {
+				if (in_.empty()) return false;
+				v = static_cast<std::uint8_t>(in_.front());
+				in_.remove_prefix(1);
+				return true;
+			}
+
+			bool u32(std::uint32_t& v) {
+				std::uint64_t w;
+				if (!fixed(w, 4)) return false;
+				v = static_cast<std::uint32_t>(w);
+				return true;
+			}
+
+			bool u64(std::uint64_t& v) { return fixed(v, 8); }
+
+			bool varint(std::uint64_t& v) {
+				v = 0;
+				for (int shift = 0; shift < 64; shift += 7) {
+					std::uint8_t b;
+					if (!u8(b)) return false;
+					v |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+					if (!(b & 0x80)) return true;
+				}
+				return false;
+			}
+
+			bool str(std::string& s) {
+				std::uint64_t size;
+				if (!varint(size) || size > in_.size()) return false;
+				s.assign(in_.substr(0, size));
+				in_.remove_prefix(size);
+				return true;
+			}
+
+			bool wstr(std::wstring& s) {
+				std::uint64_t size;
+				if (!varint(size) || size > in_.size()) return false;
+				s.resize(size);
+				for (auto& c : s) {
+					std::uint64_t v;
+					if (!varint(v)) return false;
+					c = static_cast<wchar_t>(v);
+				}
+				return true;
+			}
+
+			bool range(dott_entries::range& r) { return u32(r.begin) && u32(r.size); }
+
+			bool bytes(std::string_view& s, std::size_t size) {
+				if (size > in_.size()) return false;
+				s = in_.substr(0, size);
+				in_.remove_prefix(size);
+				return true;
+			}
+
+			bool digest(std::array<std::uint8_t, 32>& d) {
+				std::string_view s;
+				if (!bytes(s, d.size())) return false;
+				std::copy(s.begin(), s.end(), d.begin());
+				return true;
+			}
+
+			template <typename T, typename F>
+			bool list(std::vector<T>& items, F&& read_item) {
+				std::uint64_t count;
+				// every item takes at least a byte, which also rejects absurd counts
+				if (!varint(count) || count > in_.size()) return false;
+				items.resize(count);
+				for (auto& item : items) {
+					if (!read_item(item)) return false;
+				}
+				return true;
+			}
+
+		private:
+			bool fixed(std::uint64_t& v, std::size_t size) {
+				if (in_.size() < size) return false;
+				v = 0;
+				for (std::size_t i = 0; i < size; ++i) {
+					v |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(in_[i])) << (i * 8);
+				}
+				in_.remove_prefix(size);
+				return true;
+			}
+		};
+
+		void write_variables(writer& w, const std::vector<script_class::variable>& vars) {
+			w.varint(vars.size());
+			for (const auto& v : vars) {
+				w.wstr(v.name);
+				w.wstr(v.type);
+				w.wstr(v.short_desc);
+			}
+		}
+
+		bool read_variables(reader& r, std::vector<script_class::variable>& vars) {
+			return r.list(vars, [&r](script_class::variable& v) { return r.wstr(v.name) && r.wstr(v.type) && r.wstr(v.short_desc); });
+		}
+
+		void write_script_class(writer& w, const script_class& c) {
+			w.u8(c.is_public ? 1 : 0);
+			w.wstr(c.name);
+			w.wstr(c.parent);
+			w.varint(c.tags.size());
+			for (const auto& tag : c.tags) {
+				w.wstr(tag);
+			}
+			w.wstr(c.short_desc);
+			w.varint(c.categories.size());
+			for (const auto& category : c.categories) {
+				w.wstr(category.name);
+				write_variables(w, category.variables);
+			}
+			w.varint(c.functions.size());
+			for (const auto& f : c.functions) {
+				w.wstr(f.name);
+				w.wstr(f.short_desc);
+				write_variables(w, f.arguments);
+				w.wstr(f.return_type);
+			}
+		}
+
+		bool read_script_class(reader& r, script_class& c) {
+			std::uint8_t is_public;
+			if (!r.u8(is_public))
+				return false;
+			c.is_public = is_public != 0;
+			return r.wstr(c.name) && r.wstr(c.parent)
+				&& r.list(c.tags, [&r](std::wstring& tag) { return r.wstr(tag); })
+				&& r.wstr(c.short_desc)
+				&& r.list(c.categories, [&r](script_class::export_category& category) {
+					return r.wstr(category.name) && read_variables(r, category.variables);
+				})
+				&& r.list(c.functions, [&r](script_class::function& f) {
+					return r.wstr(f.name) && r.wstr(f.short_desc) && read_variables(r, f.arguments) && r.wstr(f.return_type);
+				});
+		}
+
+		void write_entries(writer& w, const dott_entries& entries) {
+			w.str(entries.text);
+			w.varint(entries.sections.size());
+			for (const auto& section : entries.sections) {
+				w.range(section.heading);
+				w.u32(section.first_property);
+				w.u32(section.property_count);
+			}
+			w.varint(entries.properties.size());
+			for (const auto& p : entries.properties) {
+				w.range(p.key);
+				w.range(p.value);
+			}
+		}
+
+		bool read_entries(reader& r, dott_entries& entries) {
+			if (!r.str(entries.text)
+				|| !r.list(entries.sections, [&r](dott_entries::section& s) {
+					return r.range(s.heading) && r.u32(s.first_property) && r.u32(s.property_count);
+				})
+				|| !r.list(entries.properties, [&r](dott_entries::pair& p) { return r.range(p.key) && r.range(p.value); })) {
+				return false;
+			}
+
+			// the parser trusts every range, so check them all once here
+			const auto in_text = [&entries](dott_entries::range range) {
+				return static_cast<std::uint64_t>(range.begin) + range.size <= entries.text.size();
+			};
+			for (const auto& s : entries.sections) {
+				if (!in_text(s.heading) || static_cast<std::uint64_t>(s.first_property) + s.property_count > entries.properties.size())
+					return false;
+			}
+			for (const auto& p : entries.properties) {
+				if (!in_text(p.key) || !in_text(p.value))
+					return false;
+			}
+			return true;
+		}
+
+	} // anonymous
+
+	parse_cache::parse_cache()
+		: temp_prefix_((static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}()) {
+	}
+
+	bool parse_cache::set_directory(const std::filesystem::path& directory) {
+		std::error_code ec;
+		std::filesystem::create_directories(directory, ec);
+		if (ec || !std::filesystem::is_directory(directory, ec)) {
+#ifndef RELEASE
+			std::cerr << "[WARNING] could not create the parse cache directory " << directory << ", parsing without it\n";
+#endif
+			return false;
+		}
+
+		directory_ = directory / ("v" + std::to_string(parser_version));
+		return true;
+	}
+
+	parse_cache::key parse_cache::key_of(std::string_view contents) {
+		return { util::sha256(contents), contents.size() };
+	}
+
+	std::shared_ptr<const script_class> parse_cache::find(const key& k) {
+		auto& s = shard_of(k);
+		{
+			std::lock_guard lock{ s.mutex };
+			if (const auto it = s.classes.find(k); it != s.classes.end()) {
+				++hits_;
+				return it->second;
+			}
+		}
+
+		std::string payload;
+		if (on_disk() && read(k, 's', payload)) {
+			script_class c{};
+			reader r{ payload };
+			if (read_script_class(r, c) && r.done()) {
+				++hits_;
+				auto shared = std::make_shared<const script_class>(std::move(c));
+				std::lock_guard lock{ s.mutex };
+				return s.classes.try_emplace(k, std::move(shared)).first->second;
+			}
+		}
+
+		++misses_;
+		return nullptr;
+	}
+
+	void parse_cache::insert(const key& k, const script_class& c) {
+		auto shared = std::make_shared<const script_class>(c);
+		auto& s = shard_of(k);
+		{
+			std::lock_guard lock{ s.mutex };
+			s.classes.try_emplace(k, std::move(shared));
+		}
+
+		if (on_disk()) {
+			std::string payload;
+			writer w{ payload };
+			write_script_class(w, c);
+			write(k, 's', payload);
+		}
+	}
+
+	bool parse_cache::find(const key& k, dott_entries& out) {
+		if (!on_disk())
+			return false;
+
+		std::string payload;
+		if (read(k, 'd', payload)) {
+			reader r{ payload };
+			if (read_entries(r, out) && r.done()) {
+				++hits_;
+				return true;
+			}
+			out = {};
+		}
+
+		++misses_;
+		return false;
+	}
+
+	void parse_cache::insert(const key& k, const dott_entries& entries) {
+		if (!on_disk())
+			return;
+
+		std::string payload;
+		writer w{ payload };
+		write_entries(w, entries);
+		write(k, 'd', payload);
+	}
+
+	// <directory>/v<version>/<first two hex digits of the digest>/<digest>.<kind>
+	std::filesystem::path parse_cache::path_of(const key& k, char kind) const {
+		char name[68];
+		for (std::size_t i = 0; i < k.digest.size(); ++i) {
+			std::snprintf(name + i * 2, 3, "%02x", k.digest[i]);
+		}
+		std::snprintf(name + 64, 3, ".%c", kind);
+		return directory_ / std::string_view{ name, 2 } / name;
+	}
+
+	bool parse_cache::read(const key& k, char kind, std::string& payload) const {
+		std::ifstream in{ path_of(k, kind), std::ios::binary };
+		if (!in)
+			return false;
+
+		std::string data{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+		reader r{ data };
+		std::string_view m;
+		std::uint32_t version;
+		std::uint8_t stored_kind;
+		key stored;
+		std::uint64_t size;
+		if (!r.bytes(m, magic.size()) || m != magic || !r.u32(version) || version != parser_version
+			|| !r.u8(stored_kind) || stored_kind != static_cast<std::uint8_t>(kind)
+			|| !r.digest(stored.digest) || !r.u64(stored.size) || !(stored == k)
+			|| !r.u64(size) || size != data.size() - header_size) {
+			return false;
+		}
+
+		payload = data.substr(header_size);
+		return true;
+	}
+
+	void parse_cache::write(const key& k, char kind, std::string_view payload) {
+		std::string data;
+		data.reserve(header_size + payload.size());
+		writer w{ data };
+		data.append(magic);
+		w.u32(parser_version);
+		w.u8(static_cast<std::uint8_t>(kind));
+		w.digest(k.digest);
+		w.u64(k.size);
+		w.u64(payload.size());
+		data.append(payload);
+
+		const auto path = path_of(k, kind);
+		std::error_code ec;
+		std::filesystem::create_directories(path.parent_path(), ec);
+
+		auto temp = path;
+		temp += "." + std::to_string(temp_prefix_) + "-" + std::to_string(temp_counter_++) + ".tmp";
+		{
+			std::ofstream out{ temp, std::ios::binary };
+			out.write(data.data(), static_cast<std::streamsize>(data.size()));
+			if (!out) {
+				out.close();
+				std::filesystem::remove(temp, ec);
+				return;
+			}
+		}
+
+		// another process may have written the same content first, either copy is as good
+		std::filesystem::rename(temp, path, ec);
+		if (ec) {
+			std::filesystem::remove(temp, ec);
+		}
+	}
+
+} // docs_gen_core
@@ -0,0 +1,103 @@
+#ifndef DOCS_GEN_PARSE_CACHE_H
+#define DOCS_GEN_PARSE_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "file.hpp"
+#include "lexer.hpp"
+#include "util/flat_map.hpp"
+
+namespace docs_gen_core {
+
+	// Parse results by file content, keyed by its SHA-256 and size, so byte-identical files (vendored addons, the same file on
+	// several branches) are parsed once. Nothing cached depends on the project around a file:
+	// script classes only depend on their text, and text scenes and resources are cached as
+	// lexed entries whose links are resolved against each project when they are parsed.
+	//
+	// Script classes are kept in memory for every project of a batch. With a directory set,
+	// script classes and lexed entries are also stored there, one file per content key under
+	// v<parser_version>/, so later runs and other checkouts sharing the directory reuse them.
+	// Files are written under a temporary name and renamed into place, so processes sharing the
+	// directory never see half of one; unreadable or mismatching files count as misses.
+	// Safe to use from several threads
+	class parse_cache {
+	public:
+		// Bump whenever a parser or the layout of the cached files changes, older files are then ignored
+		static constexpr std::uint32_t parser_version = 2;
+
+		// A cached file is trusted on a key match alone, so the key has to be a real digest:
+		// a plain hash would let a crafted file pick up another file's parse results
+		struct key {
+			std::array<std::uint8_t, 32> digest;
+			std::uint64_t size;
+
+			bool operator==(const key& other) const { return digest == other.digest && size == other.size; }
+		};
+
+	private:
+		struct key_hash {
+			std::uint64_t operator()(const key& k) const noexcept {
+				std::uint64_t h = 0;
+				for (int i = 0; i < 8; ++i) h |= static_cast<std::uint64_t>(k.digest[i]) << (i * 8);
+				return h;
+			}
+		};
+
+		static constexpr std::size_t shard_count = 16;
+		struct shard {
+			std::mutex mutex;
+			util::flat_map<key, std::shared_ptr<const script_class>, key_hash> classes;
+		};
+
+		std::array<shard, shard_count> shards_;
+		std::atomic<std::size_t> hits_{ 0 };
+		std::atomic<std::size_t> misses_{ 0 };
+
+		std::filesystem::path directory_;
+		// makes temporary file names unique between processes sharing the directory
+		std::uint64_t temp_prefix_;
+		std::atomic<std::uint64_t> temp_counter_{ 0 };
+
+	public:
+		parse_cache();
+		parse_cache(const parse_cache& other) = delete;
+		parse_cache(parse_cache&& other) = delete;
+		~parse_cache() = default;
+
+		parse_cache& operator=(const parse_cache& other) = delete;
+		parse_cache& operator=(parse_cache&& other) = delete;
+
+		// false if the directory cannot be created, the cache then stays in memory only
+		bool set_directory(const std::filesystem::path& directory);
+		[[nodiscard]] bool on_disk() const { return !directory_.empty(); }
+
+		[[nodiscard]] static key key_of(std::string_view contents);
+
+		// nullptr on a miss
+		[[nodiscard]] std::shared_ptr<const script_class> find(const key& k);
+		void insert(const key& k, const script_class& c);
+		// Lexed text scenes and resources are only cached on disk, false on a miss
+		bool find(const key& k, dott_entries& out);
+		void insert(const key& k, const dott_entries& entries);
+
+		[[nodiscard]] std::size_t get_hits() const { return hits_; }
+		[[nodiscard]] std::size_t get_misses() const { return misses_; }
+
+	private:
+		shard& shard_of(const key& k) { return shards_[k.digest[31] % shard_count]; }
+
+		[[nodiscard]] std::filesystem::path path_of(const key& k, char kind) const;
+		bool read(const key& k, char kind, std::string& payload) const;
+		void write(const key& k, char kind, std::string_view payload);
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_PARSE_CACHE_H
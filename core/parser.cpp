@@ -6,198 +6,78 @@
 
 namespace docs_gen_core {
 
-	dott_parser::dott_parser(const std::shared_ptr<dott_file>& file)
-	: file_(file) {
-		in_.open(file_->get_path(), std::ios::in | std::ios::binary);
-		if (!in_.is_open()) {
-#ifndef RELEASE
-			std::cerr << "[ERROR] could not open file: " << file_->get_path() << '\n';
-#endif
-			return;
-		}
+	template <typename File>
+	dott_parser<File>::dott_parser(File& file)
+		: dott_parser(file, file_data::load(file.get_path())) {
 	}
 
-	bool dott_parser::parse_scene_header() {
-		next_entry();
-		if (!validate_scene_header()) {
-#ifndef RELEASE
-			std::cerr << "[ERROR] corrupted scene file: " << file_->get_path() << '\n';
-#endif
-			return false;
-		}
+	template <typename File>
+	dott_parser<File>::dott_parser(File& file, file_data data)
+		: file_(&file), data_(std::move(data)), lexer_(data_.view()) {
+	}
 
-		auto file = dynamic_cast<scene_file*>(file_.get());
-		if (!file) {
-#ifndef RELEASE
-			std::cerr << "[ERROR] wrong file type " << file_->get_path() << '\n';
-#endif
-			return false;
-		}
-		
-		file->set_uid(fields_[L"uid"]);
-		return true;
+	template <typename File>
+	dott_parser<File>::dott_parser(File& file, std::unique_ptr<const dott_entries> entries)
+		: file_(&file), entries_(std::move(entries)) {
 	}
 
-	bool dott_parser::parse_resource_header() {
+	template <typename File>
+	bool dott_parser<File>::parse_header() {
 		next_entry();
-		if (!validate_resource_header()) {
+		if (!validate_header()) {
 #ifndef RELEASE
-			std::cerr << "[ERROR] corrupted resource file: " << file_->get_path() << '\n';
+			std::cerr << "[ERROR] corrupted " << traits::name << " file: " << file_->get_path() << '\n';
 #endif
 			return false;
 		}
 
-		auto file = dynamic_cast<resource_file*>(file_.get());
-		if (!file) {
-#ifndef RELEASE
-			std::cerr << "[ERROR] wrong file type " << file_->get_path() << '\n';
-#endif
-			return false;
+		file_->set_uid(fields_[L"uid"]);
+		if constexpr (traits::has_resources) {
+			file_->set_script_class(fields_[L"script_class"]);
 		}
-
-		file->set_uid(fields_[L"uid"]);
-		file->set_script_class(fields_[L"script_class"]);
 		return true;
 	}
 
-	bool dott_parser::parse_scene_file_contents(
-		const std::unordered_map<std::wstring, std::shared_ptr<scene_file>>& scene_files,
-		const std::unordered_map<std::wstring, std::shared_ptr<script_file>>& script_files,
-		const std::unordered_map<std::wstring, std::shared_ptr<resource_file>>& resource_files) {
-		auto file = dynamic_cast<scene_file*>(file_.get());
-		if (!file) {
-#ifndef RELEASE
-			std::cerr << "[ERROR] wrong file type " << file_->get_path() << '\n';
-#endif
-			return false;
-		}
-
+	template <typename File>
+	bool dott_parser<File>::parse_contents(const project& project) {
 #ifndef RELEASE
-		std::cout << "---- Processing scene file " << file->get_path() << " ----\n";
+		std::cout << "---- Processing " << traits::name << " file " << file_->get_path() << " ----\n";
 #endif
 		while (next_entry()) {
+			if (fields_.find(traits::header) != fields_.end()) {
+				check_header();
+				continue;
+			}
+
 			if (fields_.find(L"ext_resource") != fields_.end()) {
-				if (!validate_ext_resource_type()) {
-#ifndef RELEASE
-					std::cerr << "[ERROR] corrupted scene file (invalid external resource type): " << file->get_path() << '\n';
-#endif
+				if (!parse_ext_resource(project))
 					return false;
-				}
-
-				auto& type = fields_[L"type"];
-				if (type == L"PackedScene") {
-					if (!validate_ext_resource_packed_scene()) {
-#ifndef RELEASE
-						std::cerr << "[WARNING] corrupted scene file (invalid external resource \"PackedScene\"): " << file->get_path() << '\n';
-#endif
-						continue;
-					}
-
-					auto& uid = fields_[L"uid"];
-					if (scene_files.find(uid) == scene_files.end()) {
-#ifndef RELEASE
-						std::cerr << "[WARNING] previously not encountered scene file: ";
-						std::wcerr << fields_[L"path"];
-						std::cerr << '\n';
-#endif
-						continue;
-					}
-
-					file->push_packed_scene(fields_[L"id"], scene_files.at(uid));
-				}
-				else if (type == L"Script") {
-					if (!validate_ext_resource_script()) {
-#ifndef RELEASE
-						std::cerr << "[WARNING] corrupted scene file (invalid external resource \"Script\"): " << file->get_path() << '\n';
-#endif
-						continue;
-					}
-
-					std::wstring path_str = fields_[L"path"];
-					auto rel_root_path = root_path_ / std::filesystem::path{ path_str };
-					rel_root_path.make_preferred();
-					path_str = rel_root_path.relative_path().wstring();
-					if (script_files.find(path_str) == script_files.end()) {
-#ifndef RELEASE
-						std::cerr << "[WARNING] previously not encountered script file: ";
-						std::wcerr << fields_[L"path"];
-						std::cerr << '\n';
-#endif
-						continue;
-					}
+				continue;
+			}
 
-					file->push_script(fields_[L"id"], script_files.at(path_str));
+			if constexpr (traits::has_nodes) {
+				if (fields_.find(L"node") != fields_.end()) {
+					parse_node(*file_);
 				}
-				else if (type == L"Resource") {
-					if (!validate_ext_resource_resource()) {
-#ifndef RELEASE
-						std::cerr << "[WARNING] corrupted scene file (invalid external resource \"Resource\"): " << file->get_path() << '\n';
-#endif
-						continue;
-					}
-
-					auto& uid = fields_[L"uid"];
-					if (resource_files.find(uid) == resource_files.end()) {
-#ifndef RELEASE
-						std::cerr << "[WARNING] previously not encountered resource file: ";
-						std::wcerr << fields_[L"path"];
-						std::cerr << '\n';
-#endif
-						continue;
-					}
+			}
 
-					file->push_ext_resource(fields_[L"id"], resource_files.at(uid));
-				}
-				else {
-					if (!validate_ext_resource_other()) {
+			if constexpr (traits::has_resources) {
+				if (fields_.find(L"sub_resource") != fields_.end()) {
+					if (!validate_sub_resource()) {
 #ifndef RELEASE
-						std::cerr << "[WARNING] corrupted scene file (invalid external resource \"Other\"): " << file->get_path() << '\n';
+						std::cerr << "[WARNING] corrupted resource file (invalid sub_resource): " << file_->get_path() << '\n';
 #endif
 						continue;
 					}
 
-					file->push_ext_resource_other(fields_[L"id"], {fields_[L"type"], fields_[L"path"]});
-				}
-			}
-			else if (fields_.find(L"node") != fields_.end()) {
-				auto tn = file->get_node_tree().end();
-				
-				if (fields_.find(L"type") != fields_.end()) {
-					tn = file->get_node_tree().insert(fields_[L"name"], fields_[L"type"], fields_[L"parent"]);
-				}
-				else if (fields_.find(L"instance") != fields_.end()) {
-					auto& instance = fields_[L"instance"];
-					if (file->get_packed_scenes().find(instance) != file->get_packed_scenes().end()) {
-						tn = file->get_node_tree().insert(fields_[L"name"], L"PackedScene", fields_[L"parent"]);
-					}
-				}
-				else {
-					tn = file->get_node_tree().insert(fields_[L"name"], L"Unknown", fields_[L"parent"]);
+					resource_file::resource r{fields_[L"type"], {}, {}, {}, {}};
+					parse_resource_properties(*file_, r);
+					file_->push_sub_resource(fields_[L"id"], std::move(r));
 				}
-
-				if (tn != file->get_node_tree().end()) {
-					while (next_node_field()) {
-						auto second = node_field_.second;
-						if (second.find(L"ExtResource") != std::string::npos) {						
-							second = second.substr(13, second.size() - 15);
-							const auto& sf =  file->get_packed_scenes().find(second);
-							if (sf != file->get_packed_scenes().end()) {
-								(*tn)->ext_resource_fields.emplace_back(node_field_.first, sf->second);
-								continue;
-							}
-
-							const auto& scf = file->get_scripts().find(second);
-							if (scf != file->get_scripts().end()) {
-								(*tn)->ext_resource_fields.emplace_back(node_field_.first, scf->second);
-								continue;
-							}
-
-							const auto& rf = file->get_ext_resources().find(second);
-							if (rf != file->get_ext_resources().end()) {
-								(*tn)->ext_resource_fields.emplace_back(node_field_.first, rf->second);
-							}
-						}
-					}
+				else if (fields_.find(L"resource") != fields_.end()) {
+					resource_file::resource r{{}, {}, {}, {}, {}};
+					parse_resource_properties(*file_, r);
+					file_->set_resource(std::move(r));
 				}
 			}
 		}
@@ -205,348 +85,297 @@ namespace docs_gen_core {
 		return true;
 	}
 
-	bool dott_parser::parse_resource_file_contents(
-		const std::unordered_map<std::wstring, std::shared_ptr<scene_file>>& scene_files,
-		const std::unordered_map<std::wstring, std::shared_ptr<script_file>>& script_files,
-		const std::unordered_map<std::wstring, std::shared_ptr<resource_file>>& resource_files) {
-		auto file = dynamic_cast<resource_file*>(file_.get());
-		if (!file) {
+	// A file whose uid was seeded from the Godot cache never had its header parsed, so what
+	// only the header holds is taken here and the seeded uid is checked against it
+	template <typename File>
+	void dott_parser<File>::check_header() {
+		const auto& uid = fields_[L"uid"];
+		if (!uid.empty() && uid != file_->get_uid()) {
 #ifndef RELEASE
-			std::cerr << "[ERROR] wrong file type " << file_->get_path() << '\n';
+			std::cerr << "[WARNING] uid in the header of " << file_->get_path() << " does not match .godot/uid_cache.bin\n";
 #endif
-			return false;
 		}
+		if constexpr (traits::has_resources) {
+			file_->set_script_class(fields_[L"script_class"]);
+		}
+	}
 
+	// false only for a corrupted file, unresolved resources are skipped with a warning
+	template <typename File>
+	bool dott_parser<File>::parse_ext_resource(const project& project) {
+		if constexpr (traits::requires_ext_resource_type) {
+			if (!validate_ext_resource_type()) {
 #ifndef RELEASE
-		std::cout << "---- Processing resource file " << file->get_path() << " ----\n";
+				std::cerr << "[ERROR] corrupted " << traits::name << " file (invalid external resource type): " << file_->get_path() << '\n';
 #endif
-		while (next_entry()) {
-			if (fields_.find(L"ext_resource") != fields_.end()) {
-				auto& type = fields_[L"type"];
-				if (type == L"Script") {
-					if (!validate_ext_resource_script()) {
+				return false;
+			}
+		}
+
+		auto& file = *file_;
+		const auto& type = fields_[L"type"];
+		if constexpr (traits::has_packed_scenes) {
+			if (type == L"PackedScene") {
+				if (!validate_ext_resource_packed_scene()) {
 #ifndef RELEASE
-						std::cerr << "[WARNING] corrupted resource file (invalid external resource \"Script\"): " << file->get_path() << '\n';
+					std::cerr << "[WARNING] corrupted " << traits::name << " file (invalid external resource \"PackedScene\"): " << file.get_path() << '\n';
 #endif
-						continue;
-					}
+					return true;
+				}
 
-					std::wstring path_str = fields_[L"path"];
-					auto rel_root_path = root_path_ / std::filesystem::path{ path_str };
-					rel_root_path.make_preferred();
-					path_str = rel_root_path.relative_path().wstring();
-					if (script_files.find(path_str) == script_files.end()) {
+				const auto scene = project.find_scene(fields_[L"uid"]);
+				if (!scene.valid()) {
 #ifndef RELEASE
-						std::cerr << "[WARNING] previously not encountered script file: ";
-						std::wcerr << fields_[L"path"];
-						std::cerr << '\n';
+					std::cerr << "[WARNING] previously not encountered scene file: ";
+					std::wcerr << fields_[L"path"];
+					std::cerr << '\n';
 #endif
-						continue;
-					}
-				
-					file->push_script(fields_[L"id"], script_files.at(path_str));
+					return true;
 				}
-				else if (type == L"Resource") {
-					if (!validate_ext_resource_resource()) {
+
+				file.push_packed_scene(fields_[L"id"], scene);
+				return true;
+			}
+		}
+
+		if (type == L"Script") {
+			if (!validate_ext_resource_script()) {
 #ifndef RELEASE
-						std::cerr << "[WARNING] corrupted resource file (invalid external resource \"Resource\"): " << file->get_path() << '\n';
+				std::cerr << "[WARNING] corrupted " << traits::name << " file (invalid external resource \"Script\"): " << file.get_path() << '\n';
 #endif
-						continue;
-					}
+				return true;
+			}
 
-					auto& uid = fields_[L"uid"];
-					if (resource_files.find(uid) == resource_files.end()) {
+			const auto script = project.find_script(project::script_key(root_path_ / std::filesystem::path{ fields_[L"path"] }));
+			if (!script.valid()) {
 #ifndef RELEASE
-						std::cerr << "[WARNING] previously not encountered resource file: ";
-						std::wcerr << fields_[L"path"];
-						std::cerr << '\n';
+				std::cerr << "[WARNING] previously not encountered script file: ";
+				std::wcerr << fields_[L"path"];
+				std::cerr << '\n';
 #endif
-						continue;
-					}
+				return true;
+			}
 
-					file->push_ext_resource(fields_[L"id"], resource_files.at(uid));
-				}
-				else {
-					if (!validate_ext_resource_other()) {
+			file.push_script(fields_[L"id"], script);
+		}
+		else if (type == L"Resource") {
+			if (!validate_ext_resource_resource()) {
 #ifndef RELEASE
-						std::cerr << "[WARNING] corrupted scene file (invalid external resource \"Other\"): " << file->get_path() << '\n';
+				std::cerr << "[WARNING] corrupted " << traits::name << " file (invalid external resource \"Resource\"): " << file.get_path() << '\n';
 #endif
-						continue;
-					}
-
-					file->push_ext_resource_other(fields_[L"id"], {fields_[L"type"], fields_[L"path"]});
-				}
+				return true;
 			}
-			else if (fields_.find(L"sub_resource") != fields_.end()) {
-				if (!validate_sub_resource()) {
+
+			const auto resource = project.find_resource(fields_[L"uid"]);
+			if (!resource.valid()) {
 #ifndef RELEASE
-					std::cerr << "[WARNING] corrupted resource file (invalid sub_resource): " << file->get_path() << '\n';
+				std::cerr << "[WARNING] previously not encountered resource file: ";
+				std::wcerr << fields_[L"path"];
+				std::cerr << '\n';
 #endif
-					continue;
-				}
-				
-				const auto& type = fields_[L"type"];
-				resource_file::resource r{type, {}, {}, {}, {}};
-				while (next_resource_field()) {
-					auto& [name, val] = res_field_;
-					if (val.find(L"ExtResource") != std::wstring::npos) {
-						val = val.substr(13, val.size() - 15);
-						const auto& ps = file->get_packed_scenes();
-						if (ps.find(val) != ps.end()) {
-							r.res_file_fields.push_back({name, ps.at(val)});
-							continue;
-						}
-
-						const auto& sf = file->get_scripts();
-						if (sf.find(val) != sf.end()) {
-							r.res_file_fields.push_back({name, sf.at(val)});
-							continue;
-						}
-
-						const auto& rf = file->get_ext_resources();
-						if (rf.find(val) != rf.end()) {
-							r.res_file_fields.push_back({name, rf.at(val)});
-							continue;
-						}
-						
-						const auto& ero = file->get_ext_resource_other();
-						if (ero.find(val) != ero.end()) {
-							r.res_other_fields.push_back({name, ero.at(val).name});
-						}
-					}
-					else if (val.find(L"SubResource") != std::wstring::npos) {
-						val = val.substr(13, val.size() - 15);
-						const auto& srf = file->get_sub_resources();
-						if (srf.find(val) != srf.end()) {
-							r.sub_res_fields.push_back({name, srf.at(val)});
-						}
-					}
-					else {
-						r.fields.push_back({name, val});
-					}
-				}
-				file->push_sub_resource(fields_[L"id"], std::make_shared<resource_file::resource>(r));
-			}
-			else if (fields_.find(L"resource") != fields_.end()) {
-				resource_file::resource r{{},{},{},{}, {}};
-				while (next_resource_field()) {
-					auto& [name, val] = res_field_;
-					if (val.find(L"ExtResource") != std::wstring::npos) {
-						val = val.substr(13, val.size() - 15);
-						const auto& ps = file->get_packed_scenes();
-						if (ps.find(val) != ps.end()) {
-							r.res_file_fields.push_back({name, ps.at(val)});
-							continue;
-						}
-
-						const auto& sf = file->get_scripts();
-						if (sf.find(val) != sf.end()) {
-							r.res_file_fields.push_back({name, sf.at(val)});
-							continue;
-						}
-
-						const auto& rf = file->get_ext_resources();
-						if (rf.find(val) != rf.end()) {
-							r.res_file_fields.push_back({name, rf.at(val)});
-							continue;
-						}
-						
-						const auto& ero = file->get_ext_resource_other();
-						if (ero.find(val) != ero.end()) {
-							r.res_other_fields.push_back({name, ero.at(val).name});
-						}
-					}
-					else if (val.find(L"SubResource") != std::wstring::npos) {
-						val = val.substr(13, val.size() - 15);
-						const auto& srf = file->get_sub_resources();
-						if (srf.find(val) != srf.end()) {
-							r.sub_res_fields.push_back({name, srf.at(val)});
-						}
-					}
-					else {
-						r.fields.push_back({name, val});
-					}
-				}
-				file->set_resource(r);
+				return true;
 			}
+
+			file.push_ext_resource(fields_[L"id"], resource);
 		}
+		else {
+			if (!validate_ext_resource_other()) {
+#ifndef RELEASE
+				std::cerr << "[WARNING] corrupted " << traits::name << " file (invalid external resource \"Other\"): " << file.get_path() << '\n';
+#endif
+				return true;
+			}
 
+			file.push_ext_resource_other(fields_[L"id"], {fields_[L"type"], fields_[L"path"]});
+		}
 		return true;
 	}
 
-	bool dott_parser::next_entry() {
-		if (in_.eof() || in_.bad())
-			return false;
+	template <typename File>
+	void dott_parser<File>::parse_node(scene_file& file) {
+		auto& tree = file.get_node_tree();
+		auto tn = tree.end();
 
-		wchar_t c;
-		while (in_.get(c) && c != '[') {
-			if (c == '{') {
-				while (in_.get(c) && c != '}') {}
+		if (fields_.find(L"type") != fields_.end()) {
+			tn = tree.insert(fields_[L"name"], fields_[L"type"], fields_[L"parent"]);
+		}
+		else if (fields_.find(L"instance") != fields_.end()) {
+			const auto& instance = fields_[L"instance"];
+			if (const auto it = file.get_packed_scenes().find(instance); it != file.get_packed_scenes().end()) {
+				tn = tree.insert(fields_[L"name"], L"PackedScene", fields_[L"parent"]);
+				if (tn != tree.end()) {
+					(*tn)->instance = it->second;
+				}
 			}
 		}
-		if (in_.eof() || in_.bad())
-			return false;
-
-		const auto start = in_.tellg();
-		while (in_.get(c) && c != ']') {}
-		if (in_.eof() || in_.bad())
-			return false;
-
-		const auto size = in_.tellg() - start - 1;
-		in_.seekg(start, std::wifstream::beg);
-		std::wstring temp(size, '\0');
-		in_.read(temp.data(), size);
-
-		iss_ = std::wistringstream(temp);
-		fields_.clear();
-		while (next_field()) {
+		else {
+			tn = tree.insert(fields_[L"name"], L"Unknown", fields_[L"parent"]);
 		}
 
-		while (in_.get(c) && c != '\n') {}
-
-		return true;
-	}
-
-	bool dott_parser::next_field() {
-		if (iss_.eof())
-			return false;
+		if (tn == tree.end())
+			return;
 
-		std::wstring temp;
-		wchar_t c;
-		bool is_quote_opened = false;
-		while (iss_.get(c)) {
-			if (c == '"') {
-				is_quote_opened = !is_quote_opened;
-			}
-			if (std::isspace(c) && !is_quote_opened) {
-				break;
+		std::string_view id;
+		while (next_property()) {
+			if (dott_lexer::call_argument(property_.value, "ExtResource", id)) {
+				if (const auto ref = file.find_ext_file(util::to_wstring(id)); ref.valid()) {
+					(*tn)->ext_resource_fields.emplace_back(util::to_wstring(property_.key), ref);
+				}
 			}
-			temp.push_back(c);
 		}
+	}
 
-		auto del = temp.find_first_of('=');
-		if (del == std::string::npos) {
-			fields_[temp] = {};
-		} else {
-			const auto lhs = temp.substr(0, del);
-			auto rhs = temp.substr(del + 1);
-			if (lhs == L"uid") {
-				rhs = rhs.substr(7, rhs.size() - 8);
-			}
-			if (lhs == L"path") {
-				rhs = rhs.substr(7, rhs.size() - 8);
+	// Shared by [sub_resource] and [resource] sections, sub resources can only point at ones above them
+	template <typename File>
+	void dott_parser<File>::parse_resource_properties(const resource_file& file, resource_file::resource& r) {
+		std::string_view id;
+		while (next_property()) {
+			auto name = util::to_wstring(property_.key);
+			if (dott_lexer::call_argument(property_.value, "ExtResource", id)) {
+				const auto val = util::to_wstring(id);
+				if (const auto ref = file.find_ext_file(val); ref.valid()) {
+					r.res_file_fields.push_back({std::move(name), ref});
+					continue;
+				}
+
+				const auto& ero = file.get_ext_resource_other();
+				if (const auto it = ero.find(val); it != ero.end()) {
+					r.res_other_fields.push_back({std::move(name), it->second.name});
+				}
 			}
-			if (lhs == L"id" || lhs == L"type" || lhs == L"parent" || lhs == L"name") {
-				rhs = rhs.substr(1, rhs.size() - 2);
+			else if (dott_lexer::call_argument(property_.value, "SubResource", id)) {
+				const auto index = file.find_sub_resource(util::to_wstring(id));
+				if (index < file.get_sub_resources().size()) {
+					r.sub_res_fields.push_back({std::move(name), index});
+				}
 			}
-			if (lhs == L"instance") {
-				rhs = rhs.substr(13, rhs.size() - 15);
+			else {
+				r.fields.push_back({std::move(name), util::to_wstring(property_.value)});
 			}
-			fields_[lhs] = rhs;
 		}
-
-		return true;
 	}
 
-	bool dott_parser::next_node_field() {
-		if (in_.eof() || in_.bad())
-			return false;
-		
-		std::wstring temp;
-		std::getline(in_, temp);
-
-		if (temp.empty())
-			return false;
-
-		auto del = temp.find_first_of('=');
-		if (del == std::string::npos)
+	template <typename File>
+	bool dott_parser<File>::next_entry() {
+		std::string_view heading;
+		if (entries_) {
+			if (next_section_ >= entries_->sections.size())
+				return false;
+			const auto& section = entries_->sections[next_section_++];
+			heading = entries_->view(section.heading);
+			next_property_ = section.first_property;
+			properties_end_ = section.first_property + section.property_count;
+		}
+		else if (!lexer_.next_section(heading))
 			return false;
 
-		node_field_ = {temp.substr(0, del - 1), temp.substr(del + 2)};
+		fields_.clear();
+		dott_lexer::property attr;
+		while (dott_lexer::next_attribute(heading, attr)) {
+			push_field(attr);
+		}
 
 		return true;
 	}
 
-	bool dott_parser::next_resource_field() {
-		if (in_.eof() || in_.bad())
-			return false;
-		
-		std::wstring temp;
-		std::getline(in_, temp);
+	template <typename File>
+	void dott_parser<File>::push_field(const dott_lexer::property& attr) {
+		const auto& lhs = attr.key;
+		auto rhs = attr.value;
+		if (lhs == "uid" || lhs == "path") {
+			rhs = dott_lexer::unquote(rhs);
+			const auto scheme = rhs.find("://");
+			if (scheme != std::string_view::npos) {
+				rhs.remove_prefix(scheme + 3);
+			}
+		}
+		if (lhs == "id" || lhs == "type" || lhs == "parent" || lhs == "name" || lhs == "script_class") {
+			rhs = dott_lexer::unquote(rhs);
+		}
+		if (lhs == "instance") {
+			dott_lexer::call_argument(rhs, "ExtResource", rhs);
+		}
+		fields_[util::to_wstring(lhs)] = util::to_wstring(rhs);
+	}
 
-		if (temp.empty())
-			return false;
+	template <typename File>
+	bool dott_parser<File>::next_property() {
+		if (!entries_)
+			return lexer_.next_property(property_);
 
-		auto del = temp.find_first_of('=');
-		if (del == std::string::npos)
+		if (next_property_ >= properties_end_)
 			return false;
-
-		res_field_ = {temp.substr(0, del - 1), temp.substr(del + 2)};
-
+		const auto& p = entries_->properties[next_property_++];
+		property_ = { entries_->view(p.key), entries_->view(p.value) };
 		return true;
 	}
 
 	// TODO think of a more sophisticated validation lul
-	bool dott_parser::validate_scene_header() {
-		return fields_.find(L"gd_scene") != fields_.end()
-			&& fields_.find(L"uid") != fields_.end() && !fields_[L"uid"].empty();
-	}
-
-	bool dott_parser::validate_resource_header() {
-		return fields_.find(L"gd_resource") != fields_.end()
+	template <typename File>
+	bool dott_parser<File>::validate_header() {
+		return fields_.find(traits::header) != fields_.end()
 			&& fields_.find(L"uid") != fields_.end() && !fields_[L"uid"].empty();
 	}
 
-	bool dott_parser::validate_ext_resource_type() {
+	template <typename File>
+	bool dott_parser<File>::validate_ext_resource_type() {
 		return fields_.find(L"type") != fields_.end() && !fields_[L"type"].empty();
 	}
 
-	bool dott_parser::validate_ext_resource_packed_scene() {
+	template <typename File>
+	bool dott_parser<File>::validate_ext_resource_packed_scene() {
 		return fields_.find(L"uid") != fields_.end() && !fields_[L"uid"].empty()
 			&& fields_.find(L"path") != fields_.end() && !fields_[L"path"].empty() 
 			&& fields_.find(L"id") != fields_.end() && !fields_[L"id"].empty();
 	}
 
-	bool dott_parser::validate_ext_resource_resource() {
+	template <typename File>
+	bool dott_parser<File>::validate_ext_resource_resource() {
 		return fields_.find(L"uid") != fields_.end() && !fields_[L"uid"].empty()
 			&& fields_.find(L"path") != fields_.end() && !fields_[L"path"].empty() 
 			&& fields_.find(L"id") != fields_.end() && !fields_[L"id"].empty();
 	}
 
-	bool dott_parser::validate_ext_resource_script() {
+	template <typename File>
+	bool dott_parser<File>::validate_ext_resource_script() {
 		return fields_.find(L"path") != fields_.end() && !fields_[L"path"].empty()
 			&& fields_.find(L"id") != fields_.end() && !fields_[L"id"].empty();
 	}
 
-	bool dott_parser::validate_ext_resource_other() {
+	template <typename File>
+	bool dott_parser<File>::validate_ext_resource_other() {
 		return fields_.find(L"path") != fields_.end() && !fields_[L"path"].empty()
 			&& fields_.find(L"id") != fields_.end() && !fields_[L"id"].empty();
 	}
 
-	bool dott_parser::validate_sub_resource() {
+	template <typename File>
+	bool dott_parser<File>::validate_sub_resource() {
 		return fields_.find(L"type") != fields_.end() && !fields_[L"type"].empty()
 			&& fields_.find(L"id") != fields_.end() && !fields_[L"id"].empty();
 	}
 
-	bool dott_parser::validate_node() {
+	template <typename File>
+	bool dott_parser<File>::validate_node() {
 		return fields_.find(L"name") != fields_.end() && !fields_[L"name"].empty()
 			&& (fields_.find(L"type") != fields_.end() && !fields_[L"type"].empty()
 			|| fields_.find(L"instance") != fields_.end() && !fields_[L"instance"].empty());
 	}
 
-	script_parser::script_parser(const std::shared_ptr<script_file>& file)
-		: file_(file) {
-		in_.open(file_->get_path(), std::ios::in | std::ios::binary);
-		if (!in_.is_open()) {
-			std::cerr << "[ERROR] could not open file: " << file_->get_path() << '\n';
-			return;
-		}
+	template class dott_parser<scene_file>;
+	template class dott_parser<resource_file>;
+
+	script_parser::script_parser(script_file& file)
+		: script_parser(file, file_data::load(file.get_path())) {
+	}
+
+	script_parser::script_parser(script_file& file, file_data data)
+		: file_(&file), data_(std::move(data)), pos_(0) {
 	}
 
 	bool script_parser::parse() {
 		std::wstring line;
 		script_class sc{};
-		while (std::getline(in_, line)) {
+		while (next_line(line)) {
 			if (line.empty())
 				continue;
 
@@ -582,14 +411,14 @@ namespace docs_gen_core {
 				auto& cat = sc.categories.back();
 				auto var_desc = line.substr(5);
 
-				std::getline(in_, line);
+				next_line(line);
 				if (line.find(L"@export var") == std::string::npos) {
 					return false;
 				}
 
 				auto v = extract_variable(line);
 				v.short_desc = var_desc;
-				cat.variables.emplace_back(v);
+				cat.variables.push_back(std::move(v));
 				
 				continue;
 			}
@@ -606,13 +435,13 @@ namespace docs_gen_core {
 			if (line.find(L"#FUNC") != std::string::npos) {
 				auto func_desc = line.substr(6);
 
-				std::getline(in_, line);
+				next_line(line);
 				if (line.find(L"func") == std::string::npos) {
 					return false;
 				}
 				auto f = extract_function(line);
 				f.short_desc = func_desc;
-				sc.functions.emplace_back(f);
+				sc.functions.push_back(std::move(f));
 				continue;
 			}
 
@@ -624,6 +453,43 @@ namespace docs_gen_core {
 		return true;
 	}
 
+	bool script_parser::parse_header() {
+		std::wstring line;
+		script_class sc{};
+		while (next_line(line)) {
+			if (line.empty())
+				continue;
+
+			if (line.find(L"extends") != std::string::npos) {
+				sc.parent = line.substr(8);
+				continue;
+			}
+
+			if (line.find(L"#CLASS") != std::string::npos)
+				continue;
+
+			if (line.find(L"class_name") != std::string::npos) {
+				sc.name = line.substr(11);
+			}
+		}
+		file_->set_script_class(std::move(sc));
+		return true;
+	}
+
+	bool script_parser::next_line(std::wstring& line) {
+		const auto src = data_.view();
+		if (pos_ >= src.size())
+			return false;
+
+		auto end = src.find('\n', pos_);
+		if (end == std::string_view::npos)
+			end = src.size();
+
+		line = util::to_wstring(src.substr(pos_, end - pos_));
+		pos_ = end + 1;
+		return true;
+	}
+
 	std::wstring script_parser::extract_category_name(const std::wstring& s) {
 		std::wstring res;
 		std::size_t start = s.find_first_of('"');
@@ -1,56 +1,90 @@
 #ifndef DOCS_GEN_PARSER_H
 #define DOCS_GEN_PARSER_H
 
-#include <fstream>
-#include <sstream>
 #include <string>
 #include <memory>
-#include <unordered_map>
 
 #include "file.hpp"
+#include "project.hpp"
+#include "lexer.hpp"
+#include "vfs.hpp"
+#include "util/flat_map.hpp"
 
 namespace docs_gen_core {
 
+	// Per file kind half of the text parser: what the header section is called and which
+	// sections and external resources the kind has. dott_parser picks its handlers from it at
+	// compile time, so the parse loop needs no runtime type checks
+	template <typename File>
+	struct dott_traits;
+
+	template <>
+	struct dott_traits<scene_file> {
+		static constexpr const wchar_t* header = L"gd_scene";
+		static constexpr const char* name = "scene";
+		// an ext_resource without a type is a corrupted file, not an unknown resource
+		static constexpr bool requires_ext_resource_type = true;
+		static constexpr bool has_packed_scenes = true;
+		static constexpr bool has_nodes = true;
+		static constexpr bool has_resources = false;
+	};
+
+	template <>
+	struct dott_traits<resource_file> {
+		static constexpr const wchar_t* header = L"gd_resource";
+		static constexpr const char* name = "resource";
+		static constexpr bool requires_ext_resource_type = false;
+		static constexpr bool has_packed_scenes = false;
+		static constexpr bool has_nodes = false;
+		static constexpr bool has_resources = true;
+	};
+
+	// Parser for text scenes (.tscn) and resources (.tres), File is scene_file or resource_file
+	template <typename File>
 	class dott_parser {
 	public:
-		using fields_type = std::unordered_map<std::wstring, std::wstring>;
+		using traits = dott_traits<File>;
+		using fields_type = util::flat_map<std::wstring, std::wstring>;
 
 	private:
 		std::filesystem::path root_path_;
-		std::shared_ptr<dott_file> file_;
+		File* file_;
 
-		std::wifstream in_;
-		std::wistringstream iss_;
+		file_data data_;
+		dott_lexer lexer_;
 		fields_type fields_;
-		std::pair<std::wstring, std::wstring> node_field_;
-		std::pair<std::wstring, std::wstring> res_field_;
+		dott_lexer::property property_;
+
+		// set when parsing from already lexed entries instead of the source
+		std::unique_ptr<const dott_entries> entries_;
+		std::size_t next_section_ = 0;
+		std::size_t next_property_ = 0;
+		std::size_t properties_end_ = 0;
 
 	public:
-		explicit dott_parser(const std::shared_ptr<dott_file>& file);
+		explicit dott_parser(File& file);
+		dott_parser(File& file, file_data data);
+		dott_parser(File& file, std::unique_ptr<const dott_entries> entries);
 
 		[[nodiscard]] const fields_type& get_fields() const { return fields_; }
 
-		bool parse_scene_header();
-		bool parse_resource_header();
-		bool parse_scene_file_contents(
-			const std::unordered_map<std::wstring, std::shared_ptr<scene_file>>& scene_files,
-			const std::unordered_map<std::wstring, std::shared_ptr<script_file>>& script_files,
-			const std::unordered_map<std::wstring, std::shared_ptr<resource_file>>& resource_files);
-		bool parse_resource_file_contents(
-			const std::unordered_map<std::wstring, std::shared_ptr<scene_file>>& scene_files,
-			const std::unordered_map<std::wstring, std::shared_ptr<script_file>>& script_files,
-			const std::unordered_map<std::wstring, std::shared_ptr<resource_file>>& resource_files);
+		bool parse_header();
+		bool parse_contents(const project& project);
 
 		void set_root_path(const std::filesystem::path& path) { root_path_ = path; }
 
 	private:
 		bool next_entry();
-		bool next_field();
-		bool next_node_field();
-		bool next_resource_field();
-		
-		bool validate_scene_header();
-		bool validate_resource_header();
+		void push_field(const dott_lexer::property& attr);
+		bool next_property();
+
+		void check_header();
+		bool parse_ext_resource(const project& project);
+		// only called for the kinds whose traits have the section
+		void parse_node(scene_file& file);
+		void parse_resource_properties(const resource_file& file, resource_file::resource& r);
+
+		bool validate_header();
 		bool validate_ext_resource_type();
 		bool validate_ext_resource_packed_scene();
 		bool validate_ext_resource_resource();
@@ -60,15 +94,23 @@ namespace docs_gen_core {
 		bool validate_node();
 	};
 
+	using scene_parser = dott_parser<scene_file>;
+	using resource_parser = dott_parser<resource_file>;
+
 	class script_parser {
-		std::shared_ptr<script_file> file_;
-		std::wifstream in_;
+		script_file* file_;
+		file_data data_;
+		std::size_t pos_;
 
 	public:
-		explicit script_parser(const std::shared_ptr<script_file>& file);
+		explicit script_parser(script_file& file);
+		script_parser(script_file& file, file_data data);
 		bool parse();
+		// Only picks up class_name and extends, enough to index the script without its full model
+		bool parse_header();
 
 	private:
+		bool next_line(std::wstring& line);
 		std::wstring extract_category_name(const std::wstring& s);
 		void extract_and_push_tags(const std::wstring& s, std::vector<std::wstring>& tags);
 		script_class::variable extract_variable(const std::wstring& s);
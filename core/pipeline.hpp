@@ -0,0 +1,155 @@
+#ifndef DOCS_GEN_PIPELINE_H
+#define DOCS_GEN_PIPELINE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "util/bounded_queue.hpp"
+
+namespace docs_gen_core {
+
+	// Workers per stage of the streaming pipeline and the depth of the queues between them
+	struct pipeline_config {
+		std::size_t read_workers = 1;
+		std::size_t parse_workers = std::max(1u, std::thread::hardware_concurrency());
+		std::size_t render_workers = 1;
+		std::size_t write_workers = 1;
+		std::size_t queue_depth = 16;
+	};
+
+	// What one stage did during a run. starved is the time its workers waited for input,
+	// blocked the time they waited for room downstream, queue_peak the deepest its input queue got
+	struct stage_stats {
+		std::string name;
+		std::size_t workers = 0;
+		std::size_t items = 0;
+		std::size_t queue_peak = 0;
+		std::chrono::nanoseconds starved{ 0 };
+		std::chrono::nanoseconds blocked{ 0 };
+	};
+
+	// Queue feeding one stage. Knows how many upstream workers are still running so the
+	// downstream workers can tell an empty queue from a finished one. Waiting workers spin
+	// briefly on the lock-free queue, then park on a condition variable until the other side
+	// moves an item or the last producer is done, so idle stages do not burn cores
+	template <typename T>
+	class stage_channel {
+		static constexpr int spin_limit = 64;
+
+		util::bounded_queue<T> queue_;
+		std::atomic<std::size_t> producers_;
+		std::atomic<std::size_t> peak_;
+		std::mutex mutex_;
+		std::condition_variable not_empty_;
+		std::condition_variable not_full_;
+		std::atomic<std::size_t> parked_pops_{ 0 };
+		std::atomic<std::size_t> parked_pushes_{ 0 };
+
+	public:
+		stage_channel(std::size_t depth, std::size_t producers)
+			: queue_(depth), producers_(producers), peak_(0) {
+		}
+
+		// Waits while the queue is full, adding the wait to blocked
+		void push(T item, std::chrono::nanoseconds& blocked) {
+			if (!queue_.try_push(item)) {
+				const auto start = std::chrono::steady_clock::now();
+				bool pushed = false;
+				for (int i = 0; i < spin_limit && !pushed; ++i) {
+					std::this_thread::yield();
+					pushed = queue_.try_push(item);
+				}
+				if (!pushed) {
+					std::unique_lock lock{ mutex_ };
+					parked_pushes_.fetch_add(1);
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+					while (!queue_.try_push(item)) {
+						not_full_.wait(lock);
+					}
+					parked_pushes_.fetch_sub(1);
+				}
+				blocked += std::chrono::steady_clock::now() - start;
+			}
+			wake(parked_pops_, not_empty_);
+
+			const auto depth = queue_.size();
+			auto peak = peak_.load(std::memory_order_relaxed);
+			while (depth > peak && !peak_.compare_exchange_weak(peak, depth, std::memory_order_relaxed)) {}
+		}
+
+		// Waits while the queue is empty, adding the wait to starved. Returns false once every
+		// producer is done and the queue is drained
+		bool pop(T& item, std::chrono::nanoseconds& starved) {
+			if (queue_.try_pop(item)) {
+				wake(parked_pushes_, not_full_);
+				return true;
+			}
+
+			const auto start = std::chrono::steady_clock::now();
+			const auto popped = [&] {
+				starved += std::chrono::steady_clock::now() - start;
+				wake(parked_pushes_, not_full_);
+				return true;
+			};
+			for (int i = 0; i < spin_limit; ++i) {
+				const bool done = producers_.load(std::memory_order_acquire) == 0;
+				if (queue_.try_pop(item))
+					return popped();
+				if (done) {
+					starved += std::chrono::steady_clock::now() - start;
+					return false;
+				}
+				std::this_thread::yield();
+			}
+
+			std::unique_lock lock{ mutex_ };
+			parked_pops_.fetch_add(1);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			while (true) {
+				const bool done = producers_.load(std::memory_order_acquire) == 0;
+				if (queue_.try_pop(item)) {
+					parked_pops_.fetch_sub(1);
+					lock.unlock();
+					return popped();
+				}
+				if (done) {
+					parked_pops_.fetch_sub(1);
+					starved += std::chrono::steady_clock::now() - start;
+					return false;
+				}
+				not_empty_.wait(lock);
+			}
+		}
+
+		void producer_done() {
+			producers_.fetch_sub(1, std::memory_order_acq_rel);
+			// taking the lock orders the count before any parked consumer's next check
+			{ std::lock_guard lock{ mutex_ }; }
+			not_empty_.notify_all();
+		}
+
+		[[nodiscard]] std::size_t peak() const { return peak_.load(std::memory_order_relaxed); }
+
+	private:
+		// After a push or pop, wakes one worker parked on the other side. The fence pairs with
+		// the one a parking worker runs between counting itself and its last try, so either it
+		// sees the item or this sees it parked
+		void wake(std::atomic<std::size_t>& parked, std::condition_variable& cv) {
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (parked.load(std::memory_order_relaxed) == 0)
+				return;
+
+			{ std::lock_guard lock{ mutex_ }; }
+			cv.notify_one();
+		}
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_PIPELINE_H
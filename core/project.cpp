@@ -0,0 +1,87 @@
+#include "project.hpp"
+
+namespace docs_gen_core {
+
+	void project::reserve(std::size_t scenes, std::size_t resources, std::size_t scripts) {
+		scenes_.reserve(scenes);
+		resources_.reserve(resources);
+		scripts_.reserve(scripts);
+		paths_.reserve(scenes + resources + scripts);
+	}
+
+	void project::clear() {
+		scenes_.clear();
+		resources_.clear();
+		scripts_.clear();
+		scene_uids_ = {};
+		resource_uids_ = {};
+		paths_ = {};
+		script_classes_ = {};
+	}
+
+	scene_handle project::add_scene(const std::filesystem::path& path) {
+		scenes_.emplace_back(path);
+		const scene_handle h{ static_cast<std::uint32_t>(scenes_.size() - 1) };
+		paths_[script_key(path)] = h;
+		return h;
+	}
+
+	resource_handle project::add_resource(const std::filesystem::path& path) {
+		resources_.emplace_back(path);
+		const resource_handle h{ static_cast<std::uint32_t>(resources_.size() - 1) };
+		paths_[script_key(path)] = h;
+		return h;
+	}
+
+	script_handle project::add_script(const std::filesystem::path& path) {
+		scripts_.emplace_back(path);
+		const script_handle h{ static_cast<std::uint32_t>(scripts_.size() - 1) };
+		paths_[script_key(path)] = h;
+		return h;
+	}
+
+	const file* project::get(file_ref ref) const {
+		switch (ref.kind) {
+		case file_kind::scene:
+			return &scenes_[ref.index];
+		case file_kind::resource:
+			return &resources_[ref.index];
+		case file_kind::script:
+			return &scripts_[ref.index];
+		default:
+			return nullptr;
+		}
+	}
+
+	scene_handle project::find_scene(const std::wstring& uid) const {
+		const auto it = scene_uids_.find(uid);
+		return it != scene_uids_.end() ? it->second : scene_handle{};
+	}
+
+	resource_handle project::find_resource(const std::wstring& uid) const {
+		const auto it = resource_uids_.find(uid);
+		return it != resource_uids_.end() ? it->second : resource_handle{};
+	}
+
+	script_handle project::find_script(const std::wstring& path) const {
+		const auto ref = find_path(path);
+		return ref.kind == file_kind::script ? script_handle{ ref.index } : script_handle{};
+	}
+
+	file_ref project::find_path(const std::wstring& path) const {
+		const auto it = paths_.find(path);
+		return it != paths_.end() ? it->second : file_ref{};
+	}
+
+	script_handle project::find_script_class(const std::wstring& name) const {
+		const auto it = script_classes_.find(name);
+		return it != script_classes_.end() ? it->second : script_handle{};
+	}
+
+	std::wstring project::script_key(const std::filesystem::path& path) {
+		auto p = path;
+		p.make_preferred();
+		return p.relative_path().wstring();
+	}
+
+} // docs_gen_core
@@ -0,0 +1,95 @@
+#ifndef DOCS_GEN_PROJECT_H
+#define DOCS_GEN_PROJECT_H
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "file.hpp"
+#include "handle.hpp"
+#include "util/flat_map.hpp"
+
+namespace docs_gen_core {
+
+	// Owns every file of a Godot project in one dense array per kind. Files link to each other
+	// by handle, so links are plain indices: no reference counting, trivially copyable between
+	// threads and easy to write out.
+	// Files are only added while indexing, handles and references stay valid after that
+	class project {
+	public:
+		using uid_table = util::flat_map<std::wstring, scene_handle>;
+		using resource_uid_table = util::flat_map<std::wstring, resource_handle>;
+		using script_table = util::flat_map<std::wstring, script_handle>;
+		using path_table = util::flat_map<std::wstring, file_ref>;
+
+	private:
+		std::vector<scene_file> scenes_;
+		std::vector<resource_file> resources_;
+		std::vector<script_file> scripts_;
+
+		uid_table scene_uids_;
+		resource_uid_table resource_uids_;
+		// every file keyed by its path without the root name, the way the parsers resolve "res://" paths
+		path_table paths_;
+		script_table script_classes_;
+
+	public:
+		project() = default;
+		project(const project& other) = delete;
+		project(project&& other) = delete;
+		~project() = default;
+
+		project& operator=(const project& other) = delete;
+		project& operator=(project&& other) = delete;
+
+		void reserve(std::size_t scenes, std::size_t resources, std::size_t scripts);
+		// Drops every file and table, all handles are invalid afterwards
+		void clear();
+		scene_handle add_scene(const std::filesystem::path& path);
+		resource_handle add_resource(const std::filesystem::path& path);
+		script_handle add_script(const std::filesystem::path& path);
+
+		[[nodiscard]] scene_file& get(scene_handle h) { return scenes_[h.index]; }
+		[[nodiscard]] const scene_file& get(scene_handle h) const { return scenes_[h.index]; }
+		[[nodiscard]] resource_file& get(resource_handle h) { return resources_[h.index]; }
+		[[nodiscard]] const resource_file& get(resource_handle h) const { return resources_[h.index]; }
+		[[nodiscard]] script_file& get(script_handle h) { return scripts_[h.index]; }
+		[[nodiscard]] const script_file& get(script_handle h) const { return scripts_[h.index]; }
+		// nullptr for an invalid reference
+		[[nodiscard]] const file* get(file_ref ref) const;
+		// file must be one of this project's files
+		[[nodiscard]] scene_handle handle_of(const scene_file& file) const {
+			return { static_cast<std::uint32_t>(&file - scenes_.data()) };
+		}
+		[[nodiscard]] resource_handle handle_of(const resource_file& file) const {
+			return { static_cast<std::uint32_t>(&file - resources_.data()) };
+		}
+		[[nodiscard]] script_handle handle_of(const script_file& file) const {
+			return { static_cast<std::uint32_t>(&file - scripts_.data()) };
+		}
+
+		[[nodiscard]] const std::vector<scene_file>& get_scenes() const { return scenes_; }
+		[[nodiscard]] const std::vector<resource_file>& get_resources() const { return resources_; }
+		[[nodiscard]] const std::vector<script_file>& get_scripts() const { return scripts_; }
+
+		[[nodiscard]] uid_table& get_scene_uids() { return scene_uids_; }
+		[[nodiscard]] const uid_table& get_scene_uids() const { return scene_uids_; }
+		[[nodiscard]] resource_uid_table& get_resource_uids() { return resource_uids_; }
+		[[nodiscard]] const resource_uid_table& get_resource_uids() const { return resource_uids_; }
+		[[nodiscard]] const path_table& get_paths() const { return paths_; }
+		[[nodiscard]] script_table& get_script_classes() { return script_classes_; }
+		[[nodiscard]] const script_table& get_script_classes() const { return script_classes_; }
+
+		[[nodiscard]] scene_handle find_scene(const std::wstring& uid) const;
+		[[nodiscard]] resource_handle find_resource(const std::wstring& uid) const;
+		[[nodiscard]] script_handle find_script(const std::wstring& path) const;
+		// path is a script_key, invalid if no file has it
+		[[nodiscard]] file_ref find_path(const std::wstring& path) const;
+		[[nodiscard]] script_handle find_script_class(const std::wstring& name) const;
+
+		[[nodiscard]] static std::wstring script_key(const std::filesystem::path& path);
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_PROJECT_H
@@ -0,0 +1,58 @@
+#include "project_settings.hpp"
+
+#include <iostream>
+
+#include "lexer.hpp"
+#include "util/util.hpp"
+
+namespace docs_gen_core {
+
+	namespace {
+
+		std::wstring res_path(std::string_view value) {
+			value = dott_lexer::unquote(dott_lexer::trim(value));
+			// autoloads registered as singletons are marked with a leading '*'
+			if (!value.empty() && value.front() == '*') value.remove_prefix(1);
+			if (value.compare(0, 6, "res://") == 0) value.remove_prefix(6);
+			return util::to_wstring(value);
+		}
+
+	} // anonymous
+
+	bool project_settings::load(const file_source& source) {
+		file_data data;
+		if (!source.read(source.root() / "project.godot", data)) {
+#ifndef RELEASE
+			std::cerr << "[WARNING] could not read project.godot\n";
+#endif
+			return false;
+		}
+		return parse(data.view(), *this);
+	}
+
+	bool project_settings::parse(std::string_view data, project_settings& settings) {
+		dott_lexer lexer{ data };
+		dott_lexer::property p;
+		std::string_view heading;
+		bool found = false;
+		while (lexer.next_section(heading)) {
+			heading = dott_lexer::trim(heading);
+			if (heading == "application") {
+				while (lexer.next_property(p)) {
+					if (dott_lexer::trim(p.key) == "run/main_scene") {
+						settings.main_scene = res_path(p.value);
+						found = true;
+					}
+				}
+			}
+			else if (heading == "autoload") {
+				while (lexer.next_property(p)) {
+					settings.autoloads.push_back(res_path(p.value));
+					found = true;
+				}
+			}
+		}
+		return found;
+	}
+
+} // docs_gen_core
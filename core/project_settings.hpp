@@ -0,0 +1,27 @@
+#ifndef DOCS_GEN_PROJECT_SETTINGS_H
+#define DOCS_GEN_PROJECT_SETTINGS_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "vfs.hpp"
+
+namespace docs_gen_core {
+
+	// The parts of project.godot that say where a game starts
+	struct project_settings {
+		// "application/run/main_scene", either a project relative path (without "res://") or
+		// a uid (with "uid://")
+		std::wstring main_scene;
+		// every autoload's scene or script, in the same form as main_scene
+		std::vector<std::wstring> autoloads;
+
+		bool load(const file_source& source);
+
+		static bool parse(std::string_view data, project_settings& settings);
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_PROJECT_SETTINGS_H
@@ -0,0 +1,98 @@
+#include "project_view.hpp"
+
+namespace docs_gen_core {
+
+	project_view::project_view(const project& project, const dependency_graph& dependencies, const std::filesystem::path& root)
+		: project_(project), dependencies_(dependencies), root_(root) {
+	}
+
+	file_ref project_view::find(std::wstring_view path) const {
+		if (path.compare(0, 6, L"res://") == 0) {
+			path.remove_prefix(6);
+		}
+		if (path.compare(0, 6, L"uid://") == 0) {
+			const std::wstring uid{ path.substr(6) };
+			if (const auto s = project_.find_scene(uid); s.valid()) return s;
+			if (const auto r = project_.find_resource(uid); r.valid()) return r;
+			return {};
+		}
+
+		return project_.find_path(project::script_key(root_ / std::filesystem::path{ path }));
+	}
+
+	const file* project_view::get(file_ref ref) const {
+		switch (ref.kind) {
+		case file_kind::scene: return as_scene(ref);
+		case file_kind::resource: return as_resource(ref);
+		case file_kind::script: return as_script(ref);
+		default: return nullptr;
+		}
+	}
+
+	const scene_file* project_view::as_scene(file_ref ref) const {
+		return ref.kind == file_kind::scene && ref.index < scenes().size() ? &scenes()[ref.index] : nullptr;
+	}
+
+	const resource_file* project_view::as_resource(file_ref ref) const {
+		return ref.kind == file_kind::resource && ref.index < resources().size() ? &resources()[ref.index] : nullptr;
+	}
+
+	const script_file* project_view::as_script(file_ref ref) const {
+		return ref.kind == file_kind::script && ref.index < scripts().size() ? &scripts()[ref.index] : nullptr;
+	}
+
+	const script_file* project_view::find_class(std::wstring_view name) const {
+		return as_script(project_.find_script_class(std::wstring{ name }));
+	}
+
+	std::wstring project_view::res_path_of(file_ref ref) const {
+		const auto* f = get(ref);
+		return f ? res_path_of(*f) : std::wstring{};
+	}
+
+	std::wstring project_view::res_path_of(const file& file) const {
+		return L"res://" + file.get_path().lexically_relative(root_).generic_wstring();
+	}
+
+	dependency_graph::users project_view::dependencies_of(file_ref ref) const {
+		const auto id = dependencies_.id_of(ref);
+		if (id >= dependencies_.size())
+			return { nullptr, nullptr };
+		return dependencies_.dependencies_of(id);
+	}
+
+	const node_tree::tree_node* project_view::find_node(const scene_file& scene, std::wstring_view path) {
+		const auto* root = scene.get_node_tree().get_root();
+		if (!root || path.empty() || path == L".")
+			return root;
+
+		// one child lookup per path element, the rest of the tree is never touched
+		const auto walk = [](const node_tree::tree_node* node, std::wstring_view rest) -> const node_tree::tree_node* {
+			while (node && !rest.empty()) {
+				const auto slash = rest.find(L'/');
+				const auto name = rest.substr(0, slash);
+				rest = slash == std::wstring_view::npos ? std::wstring_view{} : rest.substr(slash + 1);
+
+				const node_tree::tree_node* next = nullptr;
+				for (const auto& child : node->children) {
+					if (child->name == name) {
+						next = child.get();
+						break;
+					}
+				}
+				node = next;
+			}
+			return node;
+		};
+
+		if (const auto* node = walk(root, path))
+			return node;
+
+		// the same path with the root's name in front
+		const auto slash = path.find(L'/');
+		if (path.substr(0, slash) != root->name)
+			return nullptr;
+		return slash == std::wstring_view::npos ? root : walk(root, path.substr(slash + 1));
+	}
+
+} // docs_gen_core
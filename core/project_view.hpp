@@ -0,0 +1,84 @@
+#ifndef DOCS_GEN_PROJECT_VIEW_H
+#define DOCS_GEN_PROJECT_VIEW_H
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "dependency_graph.hpp"
+#include "file.hpp"
+#include "handle.hpp"
+#include "node.hpp"
+#include "project.hpp"
+
+namespace docs_gen_core {
+
+	// Read-only access to a parsed project for tools linking against Core, nothing is written
+	// to disk. Everything is returned by reference or pointer into the project, so a view is
+	// only valid as long as the project and dependency graph it looks at are not changed.
+	// Get one from dir::view() after construct_file_tree() and build_index()
+	class project_view {
+		const project& project_;
+		const dependency_graph& dependencies_;
+		std::filesystem::path root_;
+
+	public:
+		project_view(const project& project, const dependency_graph& dependencies, const std::filesystem::path& root);
+
+		[[nodiscard]] const std::vector<scene_file>& scenes() const { return project_.get_scenes(); }
+		[[nodiscard]] const std::vector<resource_file>& resources() const { return project_.get_resources(); }
+		[[nodiscard]] const std::vector<script_file>& scripts() const { return project_.get_scripts(); }
+		[[nodiscard]] std::size_t size() const { return scenes().size() + resources().size() + scripts().size(); }
+		[[nodiscard]] const std::filesystem::path& root() const { return root_; }
+
+		// Calls fn(file_ref, const file&) for scenes, then resources, then scripts
+		template <typename Fn>
+		void for_each_file(Fn&& fn) const {
+			for (std::uint32_t i = 0; i < scenes().size(); ++i) fn(file_ref{ scene_handle{ i } }, scenes()[i]);
+			for (std::uint32_t i = 0; i < resources().size(); ++i) fn(file_ref{ resource_handle{ i } }, resources()[i]);
+			for (std::uint32_t i = 0; i < scripts().size(); ++i) fn(file_ref{ script_handle{ i } }, scripts()[i]);
+		}
+
+		// "res://..." or project relative path, or "uid://...". Invalid if no file matches
+		[[nodiscard]] file_ref find(std::wstring_view path) const;
+		// nullptr if ref is invalid or of another kind
+		[[nodiscard]] const file* get(file_ref ref) const;
+		[[nodiscard]] const scene_file* as_scene(file_ref ref) const;
+		[[nodiscard]] const resource_file* as_resource(file_ref ref) const;
+		[[nodiscard]] const script_file* as_script(file_ref ref) const;
+		// Script declaring class_name name, nullptr if there is none
+		[[nodiscard]] const script_file* find_class(std::wstring_view name) const;
+		[[nodiscard]] std::wstring res_path_of(file_ref ref) const;
+		[[nodiscard]] std::wstring res_path_of(const file& file) const;
+
+		// Files using ref, sorted by dependency_graph id without duplicates
+		[[nodiscard]] dependency_graph::users users_of(file_ref ref) const { return dependencies_.users_of(ref); }
+		// Files ref uses, may repeat
+		[[nodiscard]] dependency_graph::users dependencies_of(file_ref ref) const;
+		[[nodiscard]] file_ref ref_of(std::uint32_t id) const { return dependencies_.ref_of(id); }
+
+		// Node at a NodePath like "Player/Shape", with or without the root's name in front.
+		// "" and "." are the root, nullptr if there is no such node
+		[[nodiscard]] static const node_tree::tree_node* find_node(const scene_file& scene, std::wstring_view path);
+		// Walks the subtree below node in pre-order, calling visitor(const tree_node&, std::size_t depth)
+		// with depth 0 for node itself
+		template <typename Visitor>
+		static void visit_nodes(const node_tree::tree_node& node, Visitor&& visitor) {
+			visit_nodes_(node, visitor, 0);
+		}
+
+	private:
+		template <typename Visitor>
+		static void visit_nodes_(const node_tree::tree_node& node, Visitor& visitor, std::size_t depth) {
+			visitor(node, depth);
+			for (const auto& child : node.children) {
+				visit_nodes_(*child, visitor, depth + 1);
+			}
+		}
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_PROJECT_VIEW_H
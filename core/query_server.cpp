@@ -0,0 +1,327 @@
+#include "query_server.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#ifndef WIN
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "util/util.hpp"
+
+namespace docs_gen_core {
+
+	namespace {
+
+		void append_line(std::string& out, std::size_t& lines, std::string_view line) {
+			out.append(line);
+			out.push_back('\n');
+			++lines;
+		}
+
+		void append_line(std::string& out, std::size_t& lines, std::string_view key, const std::wstring& value) {
+			out.append(key);
+			out.push_back(' ');
+			append_line(out, lines, util::to_string(value));
+		}
+
+#ifndef WIN
+		volatile std::sig_atomic_t stop_requested = 0;
+
+		void request_stop(int) {
+			stop_requested = 1;
+		}
+
+		// Writes what the socket takes without blocking and drops it from out, false if the client is gone
+		bool flush(int fd, std::string& out) {
+			std::size_t sent = 0;
+			while (sent < out.size()) {
+				const auto n = ::write(fd, out.data() + sent, out.size() - sent);
+				if (n < 0 && errno == EINTR) continue;
+				if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+				if (n <= 0) return false;
+				sent += static_cast<std::size_t>(n);
+			}
+			out.erase(0, sent);
+			return true;
+		}
+#endif
+
+	} // anonymous
+
+	query_server::query_server(dir& dir, const std::filesystem::path& socket_path)
+		: dir_(dir), socket_path_(socket_path) {
+	}
+
+	bool query_server::run() {
+#ifdef WIN
+		std::cerr << "[ERROR] the query server needs Unix domain sockets, which this build does not support\n";
+		return false;
+#else
+		const auto native = socket_path_.string();
+		sockaddr_un addr{};
+		if (native.size() >= sizeof(addr.sun_path)) {
+			std::cerr << "[ERROR] socket path too long: " << native << '\n';
+			return false;
+		}
+		addr.sun_family = AF_UNIX;
+		std::memcpy(addr.sun_path, native.c_str(), native.size() + 1);
+
+		const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		if (listener < 0) {
+			std::cerr << "[ERROR] could not create socket: " << std::strerror(errno) << '\n';
+			return false;
+		}
+		::unlink(native.c_str());
+		if (::bind(listener, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(listener, 16) != 0) {
+			std::cerr << "[ERROR] could not listen on " << native << ": " << std::strerror(errno) << '\n';
+			::close(listener);
+			return false;
+		}
+		// a client that hangs up early must not take the server down with it
+		const auto previous_pipe = std::signal(SIGPIPE, SIG_IGN);
+		// stopping interrupts poll, so the loop ends and the socket file is removed
+		stop_requested = 0;
+		const auto previous_int = std::signal(SIGINT, request_stop);
+		const auto previous_term = std::signal(SIGTERM, request_stop);
+		std::cout << "[INFO] Serving queries on " << native << std::endl;
+
+		// Client sockets never block: answers wait in out until the client reads them, and a
+		// client that does not read is no longer read from either, so it only stalls itself
+		struct client {
+			int fd;
+			std::string in;
+			std::string out;
+			// answered "error request too long", closed once that is sent
+			bool closing = false;
+		};
+		std::vector<client> clients;
+		std::vector<pollfd> fds;
+		auto last_refresh = std::chrono::steady_clock::now();
+		while (!stop_requested) {
+			fds.clear();
+			fds.push_back({ listener, POLLIN, 0 });
+			for (const auto& c : clients) {
+				short events = 0;
+				if (!c.closing && c.out.size() < max_pending_output) events |= POLLIN;
+				if (!c.out.empty()) events |= POLLOUT;
+				fds.push_back({ c.fd, events, 0 });
+			}
+
+			if (::poll(fds.data(), fds.size(), static_cast<int>(poll_interval_.count())) < 0) {
+				if (errno == EINTR) continue;
+				std::cerr << "[ERROR] poll failed: " << std::strerror(errno) << '\n';
+				break;
+			}
+
+			const auto now = std::chrono::steady_clock::now();
+			if (now - last_refresh >= poll_interval_) {
+				if (const auto changed = dir_.refresh(); changed > 0) {
+					std::cout << "[INFO] Reparsed " << changed << " changed files" << std::endl;
+				}
+				last_refresh = std::chrono::steady_clock::now();
+			}
+
+			for (std::size_t i = 1; i < fds.size(); ++i) {
+				auto& c = clients[i - 1];
+				if (fds[i].revents & (POLLHUP | POLLERR | POLLNVAL) && !(fds[i].revents & POLLIN)) {
+					::close(c.fd);
+					c.fd = -1;
+					continue;
+				}
+
+				if (fds[i].revents & POLLIN) {
+					char buf[4096];
+					const auto n = ::read(c.fd, buf, sizeof(buf));
+					if (n == 0 || (n < 0 && errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)) {
+						::close(c.fd);
+						c.fd = -1;
+						continue;
+					}
+					if (n > 0) {
+						c.in.append(buf, static_cast<std::size_t>(n));
+						c.closing = !answer_lines(c.in, c.out);
+					}
+				}
+
+				if (!c.out.empty() && !flush(c.fd, c.out)) {
+					::close(c.fd);
+					c.fd = -1;
+					continue;
+				}
+				if (c.closing && c.out.empty()) {
+					::close(c.fd);
+					c.fd = -1;
+				}
+			}
+			clients.erase(std::remove_if(clients.begin(), clients.end(), [](const client& c) { return c.fd < 0; }), clients.end());
+
+			if (fds[0].revents & POLLIN) {
+				if (const int fd = ::accept(listener, nullptr, nullptr); fd >= 0) {
+					::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+					clients.push_back({ fd, {}, {}, false });
+				}
+			}
+		}
+
+		for (const auto& c : clients) {
+			::close(c.fd);
+		}
+		::close(listener);
+		::unlink(native.c_str());
+		std::signal(SIGPIPE, previous_pipe);
+		std::signal(SIGINT, previous_int);
+		std::signal(SIGTERM, previous_term);
+		if (stop_requested) {
+			std::cout << "[INFO] Stopped serving queries" << std::endl;
+		}
+		return true;
+#endif
+	}
+
+	bool query_server::answer_lines(std::string& pending, std::string& out) {
+		std::size_t begin = 0;
+		for (auto end = pending.find('\n'); end != std::string::npos; end = pending.find('\n', begin)) {
+			if (end - begin > max_request_size)
+				break;
+			out += answer(std::string_view{ pending }.substr(begin, end - begin));
+			begin = end + 1;
+		}
+		pending.erase(0, begin);
+		if (pending.size() > max_request_size) {
+			pending.clear();
+			out += "error request too long\n";
+			return false;
+		}
+		return true;
+	}
+
+	std::string query_server::answer(std::string_view request) {
+		while (!request.empty() && (request.back() == '\r' || request.back() == '\n')) {
+			request.remove_suffix(1);
+		}
+		const auto space = request.find(' ');
+		const auto command = request.substr(0, space);
+		auto args = space == std::string_view::npos ? std::string_view{} : request.substr(space + 1);
+
+		std::string body;
+		std::size_t lines = 0;
+		if (command == "refresh") {
+			append_line(body, lines, "changed " + std::to_string(dir_.refresh()));
+			return "ok " + std::to_string(lines) + '\n' + body;
+		}
+
+		const auto view = dir_.view();
+		if (command == "class") {
+			if (!script_class_info(view, args, body, lines))
+				return "error unknown class\n";
+		}
+		else if (command == "file" || command == "users" || command == "dependencies" || command == "nodes") {
+			const auto arg_end = args.find(' ');
+			const auto target = view.find(util::to_wstring(args.substr(0, arg_end)));
+			if (!view.get(target))
+				return "error unknown file\n";
+			args = arg_end == std::string_view::npos ? std::string_view{} : args.substr(arg_end + 1);
+
+			if (command == "file") {
+				file_info(view, target, body, lines);
+			}
+			else if (command == "users") {
+				for (const auto user : view.users_of(target)) {
+					append_line(body, lines, util::to_string(view.res_path_of(view.ref_of(user))));
+				}
+			}
+			else if (command == "dependencies") {
+				const auto targets = view.dependencies_of(target);
+				std::vector<std::uint32_t> ids(targets.begin(), targets.end());
+				std::sort(ids.begin(), ids.end());
+				ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+				for (const auto dependency : ids) {
+					append_line(body, lines, util::to_string(view.res_path_of(view.ref_of(dependency))));
+				}
+			}
+			else {
+				const auto* scene = view.as_scene(target);
+				if (!scene)
+					return "error not a scene\n";
+				const auto* node = project_view::find_node(*scene, util::to_wstring(args));
+				if (!node)
+					return "error unknown node\n";
+				project_view::visit_nodes(*node, [&](const node_tree::tree_node& n, std::size_t depth) {
+					auto line = std::to_string(depth) + '\t' + util::to_string(n.name) + '\t' + util::to_string(n.type);
+					if (n.instance.valid()) {
+						line += '\t';
+						line += util::to_string(view.res_path_of(n.instance));
+					}
+					append_line(body, lines, line);
+				});
+			}
+		}
+		else {
+			return "error unknown command\n";
+		}
+
+		return "ok " + std::to_string(lines) + '\n' + body;
+	}
+
+	void query_server::file_info(const project_view& view, file_ref ref, std::string& out, std::size_t& lines) {
+		if (const auto* f = view.as_scene(ref)) {
+			append_line(out, lines, "kind scene");
+			append_line(out, lines, "path", view.res_path_of(*f));
+			append_line(out, lines, "uid", L"uid://" + f->get_uid());
+		}
+		else if (const auto* f = view.as_resource(ref)) {
+			append_line(out, lines, "kind resource");
+			append_line(out, lines, "path", view.res_path_of(*f));
+			append_line(out, lines, "uid", L"uid://" + f->get_uid());
+			if (!f->get_resource().type.empty())
+				append_line(out, lines, "type", f->get_resource().type);
+			if (!f->get_script_class().empty())
+				append_line(out, lines, "class", f->get_script_class());
+		}
+		else if (const auto* f = view.as_script(ref)) {
+			const auto& c = f->get_script_class();
+			append_line(out, lines, "kind script");
+			append_line(out, lines, "path", view.res_path_of(*f));
+			if (!c.name.empty())
+				append_line(out, lines, "class", c.name);
+			if (!c.parent.empty())
+				append_line(out, lines, "extends", c.parent);
+		}
+	}
+
+	bool query_server::script_class_info(const project_view& view, std::string_view name, std::string& out, std::size_t& lines) {
+		const auto* script = view.find_class(util::to_wstring(name));
+		if (!script)
+			return false;
+
+		const auto& c = script->get_script_class();
+		append_line(out, lines, "path", view.res_path_of(*script));
+		if (!c.parent.empty())
+			append_line(out, lines, "extends", c.parent);
+		for (const auto& category : c.categories) {
+			for (const auto& var : category.variables) {
+				append_line(out, lines, "var", var.name + L": " + var.type);
+			}
+		}
+		for (const auto& func : c.functions) {
+			auto signature = func.name + L"(";
+			for (std::size_t i = 0; i < func.arguments.size(); ++i) {
+				if (i > 0) signature += L", ";
+				signature += func.arguments[i].name + L": " + func.arguments[i].type;
+			}
+			signature += L") -> " + func.return_type;
+			append_line(out, lines, "func", signature);
+		}
+		return true;
+	}
+
+} // docs_gen_core
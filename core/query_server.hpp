@@ -0,0 +1,69 @@
+#ifndef DOCS_GEN_QUERY_SERVER_H
+#define DOCS_GEN_QUERY_SERVER_H
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include "dir.hpp"
+
+namespace docs_gen_core {
+
+	// Answers queries about a parsed project over a Unix domain socket, so tools can ask
+	// questions without starting a process that parses everything again.
+	//
+	// Requests are single lines, "<command> <arguments>", files are given as "res://..." or
+	// "uid://...". Every response starts with "ok <n>" followed by n lines, or is one
+	// "error <message>" line:
+	// - file <file>            kind, path, uid and class of a file
+	// - users <file>           files that use the given one
+	// - dependencies <file>    files the given one uses
+	// - nodes <scene> [path]   the node subtree at path (default the root), one
+	//                          "<depth>\t<name>\t<type>[\t<instanced scene>]" line per node
+	// - class <name>           script path, parent, exported variables and functions of a class
+	// - refresh                reparses changed files now instead of on the next poll
+	//
+	// Answers come from dir::view(), the same read-only API tools linking Core use.
+	// Connections are served from one thread, so queries never see a model that is being
+	// refreshed. Changes on disk are picked up between requests every poll interval.
+	// A client whose request line grows past max_request_size gets "error request too long"
+	// and is disconnected
+	class query_server {
+		dir& dir_;
+		std::filesystem::path socket_path_;
+		std::chrono::milliseconds poll_interval_{ 1000 };
+
+	public:
+		static constexpr std::size_t max_request_size = 4096;
+		// a client with this much unsent output is not read from until it catches up
+		static constexpr std::size_t max_pending_output = 1 << 20;
+
+		query_server(dir& dir, const std::filesystem::path& socket_path);
+		query_server(const query_server& other) = delete;
+		query_server(query_server&& other) = delete;
+		~query_server() = default;
+
+		query_server& operator=(const query_server& other) = delete;
+		query_server& operator=(query_server&& other) = delete;
+
+		void set_poll_interval(std::chrono::milliseconds interval) { poll_interval_ = interval; }
+
+		// Serves until SIGINT or SIGTERM, then closes the connections and removes the socket file.
+		// false if the socket could not be opened
+		bool run();
+		// The full response to one request line, without the socket
+		[[nodiscard]] std::string answer(std::string_view request);
+		// Answers every complete line of pending into out and keeps the unfinished rest. A line
+		// longer than max_request_size is answered "error request too long", pending is dropped
+		// and false is returned, the client is then closed
+		bool answer_lines(std::string& pending, std::string& out);
+
+	private:
+		static void file_info(const project_view& view, file_ref ref, std::string& out, std::size_t& lines);
+		static bool script_class_info(const project_view& view, std::string_view name, std::string& out, std::size_t& lines);
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_QUERY_SERVER_H
@@ -0,0 +1,44 @@
+#include "reachability.hpp"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace docs_gen_core {
+
+	reachability::reachability(const dependency_graph& graph)
+		: graph_(graph), reached_((graph.size() + 63) / 64, 0) {
+	}
+
+	void reachability::run(const std::vector<std::uint32_t>& roots) {
+		std::vector<std::uint32_t> queue;
+		queue.reserve(graph_.size() - count_);
+		const auto visit = [this, &queue](std::uint32_t id) {
+			auto& word = reached_[id >> 6];
+			const auto bit = std::uint64_t{ 1 } << (id & 63);
+			if (word & bit)
+				return;
+			word |= bit;
+			++count_;
+			queue.push_back(id);
+		};
+
+		for (const auto root : roots) {
+			if (root < graph_.size()) visit(root);
+		}
+		for (std::size_t head = 0; head < queue.size(); ++head) {
+			for (const auto target : graph_.dependencies_of(queue[head])) visit(target);
+		}
+	}
+
+	std::size_t reachability::lowest_bit(std::uint64_t bits) {
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward64(&index, bits);
+		return index;
+#else
+		return static_cast<std::size_t>(__builtin_ctzll(bits));
+#endif
+	}
+
+} // docs_gen_core
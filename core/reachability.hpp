@@ -0,0 +1,52 @@
+#ifndef DOCS_GEN_REACHABILITY_H
+#define DOCS_GEN_REACHABILITY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "dependency_graph.hpp"
+
+namespace docs_gen_core {
+
+	// Files of a dependency_graph reachable from a set of roots over its forward links. Visited
+	// files are one bit each and the frontier is a plain id queue, so a traversal touches every
+	// file and link at most once and the result for 100k files is a 12KB bitset
+	class reachability {
+		const dependency_graph& graph_;
+		std::vector<std::uint64_t> reached_;
+		std::size_t count_ = 0;
+
+	public:
+		explicit reachability(const dependency_graph& graph);
+
+		// Marks everything reachable from roots, ids the graph does not know are skipped.
+		// Can be called again with more roots, files already reached are not walked twice
+		void run(const std::vector<std::uint32_t>& roots);
+
+		[[nodiscard]] bool is_reached(std::uint32_t id) const {
+			return (reached_[id >> 6] >> (id & 63)) & 1;
+		}
+		[[nodiscard]] std::size_t get_reached_count() const { return count_; }
+
+		// Calls fn(std::uint32_t id) for every file that was not reached, in id order
+		template <typename Fn>
+		void for_each_unreached(Fn&& fn) const {
+			const auto size = graph_.size();
+			for (std::size_t word = 0; word < reached_.size(); ++word) {
+				for (auto bits = ~reached_[word]; bits != 0; bits &= bits - 1) {
+					const auto id = word * 64 + lowest_bit(bits);
+					if (id >= size)
+						return;
+					fn(static_cast<std::uint32_t>(id));
+				}
+			}
+		}
+
+	private:
+		static std::size_t lowest_bit(std::uint64_t bits);
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_REACHABILITY_H
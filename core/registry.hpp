@@ -0,0 +1,101 @@
+#ifndef DOCS_GEN_REGISTRY_H
+#define DOCS_GEN_REGISTRY_H
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "util/flat_map.hpp"
+
+namespace docs_gen_core {
+
+	// uid -> handle table that many header parsing threads can insert into at once. Keys are
+	// spread over independently locked shards. Once parsing is done it is frozen into a plain
+	// table that the resolve phase reads without any locking.
+	// If two values claim the same key the smaller one wins no matter which thread got there
+	// first, the other one is reported as a duplicate. Files are indexed in path order, so for
+	// handles that is the file with the smaller path
+	template <typename V>
+	class concurrent_registry {
+	public:
+		using table_type = util::flat_map<std::wstring, V>;
+
+		struct duplicate {
+			std::wstring key;
+			V kept;
+			V dropped;
+		};
+
+	private:
+		struct shard {
+			std::mutex mutex;
+			table_type entries;
+			std::vector<std::pair<std::wstring, V>> dropped;
+		};
+
+		std::vector<std::unique_ptr<shard>> shards_;
+
+	public:
+		explicit concurrent_registry(std::size_t shards = 32) {
+			const auto count = shards == 0 ? 1 : shards;
+			for (std::size_t i = 0; i < count; ++i) {
+				shards_.push_back(std::make_unique<shard>());
+			}
+		}
+		concurrent_registry(const concurrent_registry& other) = delete;
+		concurrent_registry(concurrent_registry&& other) = delete;
+		~concurrent_registry() = default;
+
+		concurrent_registry& operator=(const concurrent_registry& other) = delete;
+		concurrent_registry& operator=(concurrent_registry&& other) = delete;
+
+		void insert(const std::wstring& key, V value) {
+			// the high half picks the shard, the tables inside use the low bits
+			auto& s = *shards_[(util::string_hash{}(key) >> 32) % shards_.size()];
+			std::lock_guard lock{ s.mutex };
+
+			auto [it, inserted] = s.entries.try_emplace(key, value);
+			if (inserted || it->second == value)
+				return;
+
+			if (value < it->second) {
+				s.dropped.emplace_back(key, it->second);
+				it->second = value;
+			}
+			else {
+				s.dropped.emplace_back(key, value);
+			}
+		}
+
+		// Moves everything into table and lists the dropped duplicates sorted by key and value.
+		// Must not race with insert
+		void freeze(table_type& table, std::vector<duplicate>& duplicates) {
+			std::size_t size = table.size();
+			for (const auto& s : shards_) {
+				size += s->entries.size();
+			}
+			table.reserve(size);
+
+			for (auto& s : shards_) {
+				for (auto& [key, dropped] : s->dropped) {
+					duplicates.push_back({ key, s->entries[key], dropped });
+				}
+				s->dropped.clear();
+
+				for (auto& [key, value] : s->entries) {
+					table.try_emplace(std::move(key), value);
+				}
+				s->entries.clear();
+			}
+
+			std::sort(duplicates.begin(), duplicates.end(), [](const duplicate& a, const duplicate& b) {
+				return a.key != b.key ? a.key < b.key : a.dropped < b.dropped;
+			});
+		}
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_REGISTRY_H
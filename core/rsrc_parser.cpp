@@ -0,0 +1,835 @@
+#include "rsrc_parser.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#include "util/util.hpp"
+
+namespace docs_gen_core {
+
+	namespace {
+
+		enum : std::uint32_t {
+			variant_nil = 1,
+			variant_bool = 2,
+			variant_int = 3,
+			variant_float = 4,
+			variant_string = 5,
+			variant_vector2 = 10,
+			variant_rect2 = 11,
+			variant_vector3 = 12,
+			variant_plane = 13,
+			variant_quaternion = 14,
+			variant_aabb = 15,
+			variant_basis = 16,
+			variant_transform3d = 17,
+			variant_transform2d = 18,
+			variant_color = 20,
+			variant_node_path = 22,
+			variant_rid = 23,
+			variant_object = 24,
+			variant_input_event = 25,
+			variant_dictionary = 26,
+			variant_array = 30,
+			variant_packed_byte_array = 31,
+			variant_packed_int32_array = 32,
+			variant_packed_float32_array = 33,
+			variant_packed_string_array = 34,
+			variant_packed_vector3_array = 35,
+			variant_packed_color_array = 36,
+			variant_packed_vector2_array = 37,
+			variant_int64 = 40,
+			variant_double = 41,
+			variant_callable = 42,
+			variant_signal = 43,
+			variant_string_name = 44,
+			variant_vector2i = 45,
+			variant_rect2i = 46,
+			variant_vector3i = 47,
+			variant_packed_int64_array = 48,
+			variant_packed_float64_array = 49,
+			variant_vector4 = 50,
+			variant_vector4i = 51,
+			variant_projection = 52,
+			variant_packed_vector4_array = 53,
+		};
+
+		enum : std::uint32_t {
+			object_empty = 0,
+			object_external_resource = 1,
+			object_internal_resource = 2,
+			object_external_resource_index = 3,
+		};
+
+		enum : std::uint32_t {
+			format_flag_named_scene_ids = 1,
+			format_flag_uids = 2,
+			format_flag_real_t_is_double = 4,
+			format_flag_has_script_class = 8,
+		};
+
+		constexpr std::uint32_t reserved_fields = 11;
+		constexpr std::uint32_t format_version_no_nodepath_property = 3;
+		constexpr std::uint64_t invalid_uid = ~0ull;
+		// deeper arrays and dictionaries are taken for a corrupted file rather than recursed into
+		constexpr std::size_t max_value_depth = 64;
+
+		// PackedScene "_bundled" node encoding
+		constexpr std::int32_t flag_id_is_path = 1 << 30;
+		constexpr std::int32_t type_instantiated = 0x7FFFFFFF;
+		constexpr std::int32_t flag_mask = (1 << 24) - 1;
+		constexpr std::int32_t flag_prop_name_mask = (1 << 30) - 1;
+		constexpr std::int32_t name_index_mask = (1 << 18) - 1;
+
+		std::string format_real(double d) {
+			char buf[32];
+			std::snprintf(buf, sizeof(buf), "%g", d);
+			return buf;
+		}
+
+		const rsrc_parser::value* find_key(const rsrc_parser::value& dict, std::string_view key) {
+			for (std::size_t i = 0; i + 1 < dict.items.size(); i += 2) {
+				if (dict.items[i].type == rsrc_parser::value::kind::string && dict.items[i].text == key) {
+					return &dict.items[i + 1];
+				}
+			}
+			return nullptr;
+		}
+
+	} // anonymous
+
+	rsrc_parser::rsrc_parser(dott_file& file)
+		: rsrc_parser(file, file_data::load(file.get_path())) {
+	}
+
+	rsrc_parser::rsrc_parser(dott_file& file, file_data data)
+		: file_(&file), data_(std::move(data)), buffer_(data_.view()), pos_(0), ok_(false), big_endian_(false),
+		real64_(false), format_(0), flags_(0), uid_(invalid_uid) {
+		ok_ = read_header();
+	}
+
+	bool rsrc_parser::parse_header(scene_file& file) {
+		if (!ok_ || type_ != "PackedScene" || uid_ == invalid_uid) {
+#ifndef RELEASE
+			std::cerr << "[ERROR] corrupted scene file: " << file.get_path() << '\n';
+#endif
+			return false;
+		}
+
+		file.set_uid(uid_to_text(uid_));
+		return true;
+	}
+
+	bool rsrc_parser::parse_header(resource_file& file) {
+		if (!ok_ || uid_ == invalid_uid) {
+#ifndef RELEASE
+			std::cerr << "[ERROR] corrupted resource file: " << file.get_path() << '\n';
+#endif
+			return false;
+		}
+
+		file.set_uid(uid_to_text(uid_));
+		file.set_script_class(util::to_wstring(script_class_));
+		return true;
+	}
+
+	bool rsrc_parser::parse_contents(scene_file& file, const project& project) {
+		if (!ok_) {
+#ifndef RELEASE
+			std::cerr << "[ERROR] corrupted scene file: " << file.get_path() << '\n';
+#endif
+			return false;
+		}
+
+#ifndef RELEASE
+		std::cout << "---- Processing binary scene file " << file.get_path() << " ----\n";
+#endif
+		check_uid(file.get_path(), file.get_uid());
+		push_ext_resources(project);
+
+		if (int_resources_.empty()) {
+			return true;
+		}
+
+		std::string_view type;
+		std::vector<std::pair<std::string_view, value>> props;
+		if (!read_internal_resource(int_resources_.size() - 1, type, props)) {
+#ifndef RELEASE
+			std::cerr << "[ERROR] corrupted scene file (invalid main resource): " << file.get_path() << '\n';
+#endif
+			return false;
+		}
+
+		for (const auto& [name, v] : props) {
+			if (name == "_bundled") {
+				return fill_node_tree(file, v);
+			}
+		}
+		return true;
+	}
+
+	bool rsrc_parser::parse_contents(resource_file& file, const project& project) {
+		if (!ok_) {
+#ifndef RELEASE
+			std::cerr << "[ERROR] corrupted resource file: " << file.get_path() << '\n';
+#endif
+			return false;
+		}
+
+#ifndef RELEASE
+		std::cout << "---- Processing binary resource file " << file.get_path() << " ----\n";
+#endif
+		// the header is skipped for files seeded from the Godot cache
+		check_uid(file.get_path(), file.get_uid());
+		file.set_script_class(util::to_wstring(script_class_));
+		push_ext_resources(project);
+
+		std::string_view type;
+		std::vector<std::pair<std::string_view, value>> props;
+		for (std::size_t i = 0; i < int_resources_.size(); ++i) {
+			props.clear();
+			if (!read_internal_resource(i, type, props)) {
+#ifndef RELEASE
+				std::cerr << "[WARNING] corrupted resource file (invalid sub_resource): " << file.get_path() << '\n';
+#endif
+				return false;
+			}
+
+			resource_file::resource r{util::to_wstring(type), {}, {}, {}, {}};
+			fill_resource(file, r, props);
+			if (i + 1 == int_resources_.size()) {
+				r.type.clear();
+				file.set_resource(std::move(r));
+			}
+			else {
+				file.push_sub_resource(sub_resource_id(i), std::move(r));
+			}
+		}
+
+		return true;
+	}
+
+	std::wstring rsrc_parser::uid_to_text(std::uint64_t uid) {
+		// matches ResourceUID::id_to_text: base 34 over 'a'-'y' and '0'-'8'
+		constexpr std::uint64_t char_count = 'z' - 'a';
+		constexpr std::uint64_t base = char_count + ('9' - '0');
+
+		std::wstring res;
+		do {
+			const auto c = uid % base;
+			res.insert(res.begin(), c < char_count ? static_cast<wchar_t>('a' + c) : static_cast<wchar_t>('0' + (c - char_count)));
+			uid /= base;
+		} while (uid);
+		return res;
+	}
+
+	bool rsrc_parser::is_binary_resource(const std::filesystem::path& path) {
+		const auto ext = path.extension();
+		return ext == ".scn" || ext == ".res";
+	}
+
+	void rsrc_parser::check_uid(const std::filesystem::path& path, const std::wstring& uid) const {
+		if (uid_ != invalid_uid && uid_to_text(uid_) != uid) {
+#ifndef RELEASE
+			std::cerr << "[WARNING] uid in the header of " << path << " does not match .godot/uid_cache.bin\n";
+#endif
+		}
+	}
+
+	bool rsrc_parser::read_header() {
+		if (buffer_.size() < 4 || std::memcmp(buffer_.data(), "RSRC", 4) != 0) {
+#ifndef RELEASE
+			if (buffer_.size() >= 4 && std::memcmp(buffer_.data(), "RSCC", 4) == 0) {
+				std::cerr << "[WARNING] compressed binary resources are not supported: " << file_->get_path() << '\n';
+			}
+#endif
+			return false;
+		}
+
+		ok_ = true;
+		pos_ = 4;
+		const bool big_endian = read_u32() != 0;
+		const bool use_real64 = read_u32() != 0;
+		big_endian_ = big_endian;
+		read_u32(); // major
+		read_u32(); // minor
+		format_ = read_u32();
+		type_ = read_string();
+		read_u64(); // import metadata offset
+		flags_ = read_u32();
+		uid_ = read_u64();
+		if (!(flags_ & format_flag_uids)) {
+			uid_ = invalid_uid;
+		}
+		if (flags_ & format_flag_has_script_class) {
+			script_class_ = read_string();
+		}
+		real64_ = use_real64 || (flags_ & format_flag_real_t_is_double);
+
+		for (std::uint32_t i = 0; i < reserved_fields; ++i) {
+			read_u32();
+		}
+
+		const auto string_count = read_u32();
+		for (std::uint32_t i = 0; i < string_count && ok_; ++i) {
+			strings_.push_back(read_string());
+		}
+
+		const auto ext_count = read_u32();
+		for (std::uint32_t i = 0; i < ext_count && ok_; ++i) {
+			ext_entry e{};
+			e.type = read_string();
+			e.path = read_string();
+			e.uid = flags_ & format_flag_uids ? read_u64() : invalid_uid;
+			ext_resources_.push_back(e);
+		}
+
+		const auto int_count = read_u32();
+		for (std::uint32_t i = 0; i < int_count && ok_; ++i) {
+			int_entry e{};
+			e.path = read_string();
+			e.offset = read_u64();
+			int_resources_.push_back(e);
+		}
+
+		return ok_;
+	}
+
+	void rsrc_parser::push_ext_resources(const project& project) {
+		for (std::size_t i = 0; i < ext_resources_.size(); ++i) {
+			const auto& e = ext_resources_[i];
+			const auto key = std::to_wstring(i);
+
+			auto res_path = e.path;
+			const auto scheme = res_path.find("://");
+			if (scheme != std::string_view::npos) {
+				res_path.remove_prefix(scheme + 3);
+			}
+			const auto path = util::to_wstring(res_path);
+
+			if (e.type == "PackedScene" && e.uid != invalid_uid) {
+				if (const auto s = project.find_scene(uid_to_text(e.uid)); s.valid()) {
+					file_->push_packed_scene(key, s);
+					continue;
+				}
+			}
+			else if (e.type == "Resource" && e.uid != invalid_uid) {
+				if (const auto r = project.find_resource(uid_to_text(e.uid)); r.valid()) {
+					file_->push_ext_resource(key, r);
+					continue;
+				}
+			}
+			else if (e.type == "Script") {
+				if (const auto s = project.find_script(project::script_key(root_path_ / std::filesystem::path{ path })); s.valid()) {
+					file_->push_script(key, s);
+					continue;
+				}
+			}
+			else {
+				file_->push_ext_resource_other(key, {util::to_wstring(e.type), path});
+				continue;
+			}
+
+#ifndef RELEASE
+			std::cerr << "[WARNING] previously not encountered file: ";
+			std::wcerr << path;
+			std::cerr << '\n';
+#endif
+		}
+	}
+
+	bool rsrc_parser::read_internal_resource(std::size_t index, std::string_view& type,
+		std::vector<std::pair<std::string_view, value>>& props) {
+		pos_ = static_cast<std::size_t>(int_resources_[index].offset);
+		type = read_string();
+		const auto count = read_u32();
+		for (std::uint32_t i = 0; i < count && ok_; ++i) {
+			const auto name = read_table_string();
+			value v;
+			if (!read_value(v)) {
+				return false;
+			}
+			props.emplace_back(name, std::move(v));
+		}
+		return ok_;
+	}
+
+	void rsrc_parser::fill_resource(resource_file& file, resource_file::resource& r,
+		const std::vector<std::pair<std::string_view, value>>& props) const {
+		for (const auto& [name, v] : props) {
+			if (v.type == value::kind::ext_resource) {
+				if (const auto ref = file.find_ext_file(std::to_wstring(v.i)); ref.valid()) {
+					r.res_file_fields.push_back({util::to_wstring(name), ref});
+					continue;
+				}
+
+				const auto& ero = file.get_ext_resource_other();
+				const auto it = ero.find(std::to_wstring(v.i));
+				if (it != ero.end()) {
+					r.res_other_fields.push_back({util::to_wstring(name), it->second.name});
+				}
+			}
+			else if (v.type == value::kind::sub_resource) {
+				const auto index = file.find_sub_resource(sub_resource_id(static_cast<std::size_t>(v.i)));
+				if (index < file.get_sub_resources().size()) {
+					r.sub_res_fields.push_back({util::to_wstring(name), index});
+				}
+			}
+			else {
+				r.fields.push_back({util::to_wstring(name), util::to_wstring(to_text(v))});
+			}
+		}
+	}
+
+	bool rsrc_parser::fill_node_tree(scene_file& file, const value& bundled) {
+		const auto* names = find_key(bundled, "names");
+		const auto* variants = find_key(bundled, "variants");
+		const auto* nodes = find_key(bundled, "nodes");
+		const auto* node_count = find_key(bundled, "node_count");
+		const auto* node_paths = find_key(bundled, "node_paths");
+		if (!names || !variants || !nodes || !node_count) {
+#ifndef RELEASE
+			std::cerr << "[ERROR] corrupted scene file (invalid bundled scene): " << file.get_path() << '\n';
+#endif
+			return false;
+		}
+
+		const auto& n = nodes->ints;
+		std::size_t idx = 0;
+		auto next = [&n, &idx]() { return idx < n.size() ? n[idx++] : -1; };
+		auto name_at = [names](std::int32_t i) {
+			return i >= 0 && static_cast<std::size_t>(i) < names->items.size() ? names->items[i].text : std::string{};
+		};
+		auto variant_at = [variants](std::int32_t i) -> const value* {
+			return i >= 0 && static_cast<std::size_t>(i) < variants->items.size() ? &variants->items[i] : nullptr;
+		};
+
+		std::vector<std::wstring> node_rel_paths;
+		for (std::int64_t i = 0; i < node_count->i && idx < n.size(); ++i) {
+			const auto parent = next();
+			next(); // owner
+			const auto type = next();
+			const auto name = util::to_wstring(name_at(next() & name_index_mask));
+			const auto instance = next();
+
+			std::wstring parent_path;
+			if (parent >= 0 && (parent & flag_id_is_path)) {
+				const auto p = parent & flag_mask;
+				if (node_paths && static_cast<std::size_t>(p) < node_paths->items.size()) {
+					parent_path = util::to_wstring(node_paths->items[p].text);
+				}
+				if (parent_path.empty()) parent_path = L".";
+			}
+			else if (parent >= 0 && static_cast<std::size_t>(parent) < node_rel_paths.size()) {
+				parent_path = node_rel_paths[parent].empty() ? L"." : node_rel_paths[parent];
+			}
+
+			// a child before the root would have no parent to go to
+			if (!parent_path.empty() && !file.get_node_tree().get_root()) {
+#ifndef RELEASE
+				std::cerr << "[ERROR] corrupted scene file (invalid node parent): " << file.get_path() << '\n';
+#endif
+				return false;
+			}
+
+			if (parent < 0) node_rel_paths.emplace_back();
+			else if (parent_path == L".") node_rel_paths.push_back(name);
+			else node_rel_paths.push_back(parent_path + L"/" + name);
+
+			auto tn = file.get_node_tree().end();
+			if (type == type_instantiated) {
+				const auto* inst = variant_at(instance & flag_mask);
+				if (inst && inst->type == value::kind::ext_resource) {
+					const auto& ps = file.get_packed_scenes();
+					if (const auto it = ps.find(std::to_wstring(inst->i)); it != ps.end()) {
+						tn = file.get_node_tree().insert(name, L"PackedScene", parent_path);
+						if (tn != file.get_node_tree().end()) {
+							(*tn)->instance = it->second;
+						}
+					}
+				}
+			}
+			else {
+				const auto type_name = name_at(type);
+				tn = file.get_node_tree().insert(name, type_name.empty() ? L"Unknown" : util::to_wstring(type_name), parent_path);
+			}
+
+			const auto prop_count = next();
+			for (std::int32_t p = 0; p < prop_count; ++p) {
+				const auto prop_name = next() & flag_prop_name_mask;
+				const auto* v = variant_at(next());
+				if (tn == file.get_node_tree().end() || !v || v->type != value::kind::ext_resource) {
+					continue;
+				}
+
+				if (const auto ref = file.find_ext_file(std::to_wstring(v->i)); ref.valid()) {
+					(*tn)->ext_resource_fields.emplace_back(util::to_wstring(name_at(prop_name)), ref);
+				}
+			}
+
+			const auto group_count = next();
+			for (std::int32_t g = 0; g < group_count; ++g) {
+				next();
+			}
+		}
+
+		return true;
+	}
+
+	std::wstring rsrc_parser::sub_resource_id(std::size_t index) const {
+		if (index >= int_resources_.size()) {
+			return std::to_wstring(index);
+		}
+
+		auto path = int_resources_[index].path;
+		const auto local = path.find("::");
+		if (local != std::string_view::npos) {
+			path.remove_prefix(local + 2);
+		}
+		else if (path.compare(0, 8, "local://") == 0) {
+			path.remove_prefix(8);
+		}
+		return util::to_wstring(path);
+	}
+
+	std::string rsrc_parser::to_text(const value& v) const {
+		switch (v.type) {
+		case value::kind::nil:
+			return "null";
+		case value::kind::boolean:
+			return v.i ? "true" : "false";
+		case value::kind::integer:
+			return std::to_string(v.i);
+		case value::kind::real:
+			return format_real(v.f);
+		case value::kind::string:
+			return '"' + v.text + '"';
+		case value::kind::node_path:
+			return "NodePath(\"" + v.text + "\")";
+		case value::kind::ext_resource:
+			return "ExtResource(\"" + std::to_string(v.i) + "\")";
+		case value::kind::sub_resource: {
+			std::string id;
+			for (auto c : sub_resource_id(static_cast<std::size_t>(v.i))) id.push_back(static_cast<char>(c));
+			return "SubResource(\"" + id + "\")";
+		}
+		case value::kind::array:
+		case value::kind::string_array: {
+			std::string res = v.type == value::kind::array ? "[" : "PackedStringArray(";
+			for (std::size_t i = 0; i < v.items.size(); ++i) {
+				if (i) res += ", ";
+				res += to_text(v.items[i]);
+			}
+			res += v.type == value::kind::array ? "]" : ")";
+			return res;
+		}
+		case value::kind::dictionary: {
+			std::string res = "{";
+			for (std::size_t i = 0; i + 1 < v.items.size(); i += 2) {
+				if (i) res += ", ";
+				res += to_text(v.items[i]);
+				res += ": ";
+				res += to_text(v.items[i + 1]);
+			}
+			res += "}";
+			return res;
+		}
+		case value::kind::int_array: {
+			std::string res = "PackedInt32Array(";
+			for (std::size_t i = 0; i < v.ints.size(); ++i) {
+				if (i) res += ", ";
+				res += std::to_string(v.ints[i]);
+			}
+			res += ")";
+			return res;
+		}
+		case value::kind::other:
+			return v.text;
+		}
+		return {};
+	}
+
+	std::uint32_t rsrc_parser::read_u32() {
+		if (pos_ + 4 > buffer_.size()) {
+			ok_ = false;
+			pos_ = buffer_.size();
+			return 0;
+		}
+
+		const auto* b = reinterpret_cast<const unsigned char*>(buffer_.data() + pos_);
+		pos_ += 4;
+		if (big_endian_) {
+			return std::uint32_t(b[0]) << 24 | std::uint32_t(b[1]) << 16 | std::uint32_t(b[2]) << 8 | std::uint32_t(b[3]);
+		}
+		return std::uint32_t(b[3]) << 24 | std::uint32_t(b[2]) << 16 | std::uint32_t(b[1]) << 8 | std::uint32_t(b[0]);
+	}
+
+	std::uint64_t rsrc_parser::read_u64() {
+		const std::uint64_t a = read_u32();
+		const std::uint64_t b = read_u32();
+		return big_endian_ ? a << 32 | b : b << 32 | a;
+	}
+
+	float rsrc_parser::read_float() {
+		const auto bits = read_u32();
+		float f;
+		std::memcpy(&f, &bits, sizeof(f));
+		return f;
+	}
+
+	double rsrc_parser::read_double() {
+		const auto bits = read_u64();
+		double d;
+		std::memcpy(&d, &bits, sizeof(d));
+		return d;
+	}
+
+	double rsrc_parser::read_real() {
+		return real64_ ? read_double() : read_float();
+	}
+
+	std::string_view rsrc_parser::read_string() {
+		const auto len = read_u32();
+		if (len == 0 || !ok_) {
+			return {};
+		}
+		if (pos_ + len > buffer_.size()) {
+			ok_ = false;
+			pos_ = buffer_.size();
+			return {};
+		}
+
+		std::string_view res{ buffer_.data() + pos_, len };
+		pos_ += len;
+		while (!res.empty() && res.back() == '\0') res.remove_suffix(1);
+		return res;
+	}
+
+	std::string_view rsrc_parser::read_table_string() {
+		const auto id = read_u32();
+		if (id & 0x80000000) {
+			const auto len = id & 0x7FFFFFFF;
+			if (pos_ + len > buffer_.size()) {
+				ok_ = false;
+				pos_ = buffer_.size();
+				return {};
+			}
+
+			std::string_view res{ buffer_.data() + pos_, len };
+			pos_ += len;
+			while (!res.empty() && res.back() == '\0') res.remove_suffix(1);
+			return res;
+		}
+		return id < strings_.size() ? strings_[id] : std::string_view{};
+	}
+
+	void rsrc_parser::append_reals(value& v, const char* name, std::size_t count) {
+		v.type = value::kind::other;
+		v.text = name;
+		v.text += '(';
+		for (std::size_t i = 0; i < count; ++i) {
+			if (i) v.text += ", ";
+			v.text += format_real(read_real());
+		}
+		v.text += ')';
+	}
+
+	bool rsrc_parser::read_value(value& v, std::size_t depth) {
+		const auto type = read_u32();
+		switch (type) {
+		case variant_nil:
+			v.type = value::kind::nil;
+			break;
+		case variant_bool:
+			v.type = value::kind::boolean;
+			v.i = read_u32() != 0;
+			break;
+		case variant_int:
+			v.type = value::kind::integer;
+			v.i = static_cast<std::int32_t>(read_u32());
+			break;
+		case variant_int64:
+			v.type = value::kind::integer;
+			v.i = static_cast<std::int64_t>(read_u64());
+			break;
+		case variant_float:
+			v.type = value::kind::real;
+			v.f = read_float();
+			break;
+		case variant_double:
+			v.type = value::kind::real;
+			v.f = read_double();
+			break;
+		case variant_string:
+		case variant_string_name:
+			v.type = value::kind::string;
+			v.text = read_string();
+			break;
+		case variant_vector2: append_reals(v, "Vector2", 2); break;
+		case variant_rect2: append_reals(v, "Rect2", 4); break;
+		case variant_vector3: append_reals(v, "Vector3", 3); break;
+		case variant_vector4: append_reals(v, "Vector4", 4); break;
+		case variant_plane: append_reals(v, "Plane", 4); break;
+		case variant_quaternion: append_reals(v, "Quaternion", 4); break;
+		case variant_aabb: append_reals(v, "AABB", 6); break;
+		case variant_basis: append_reals(v, "Basis", 9); break;
+		case variant_transform3d: append_reals(v, "Transform3D", 12); break;
+		case variant_transform2d: append_reals(v, "Transform2D", 6); break;
+		case variant_projection: append_reals(v, "Projection", 16); break;
+		case variant_vector2i:
+		case variant_rect2i:
+		case variant_vector3i:
+		case variant_vector4i: {
+			const char* name = type == variant_vector2i ? "Vector2i" : type == variant_rect2i ? "Rect2i"
+				: type == variant_vector3i ? "Vector3i" : "Vector4i";
+			const std::size_t count = type == variant_vector2i ? 2 : type == variant_vector3i ? 3 : 4;
+			v.type = value::kind::other;
+			v.text = name;
+			v.text += '(';
+			for (std::size_t i = 0; i < count; ++i) {
+				if (i) v.text += ", ";
+				v.text += std::to_string(static_cast<std::int32_t>(read_u32()));
+			}
+			v.text += ')';
+			break;
+		}
+		case variant_color: {
+			v.type = value::kind::other;
+			v.text = "Color(";
+			for (std::size_t i = 0; i < 4; ++i) {
+				if (i) v.text += ", ";
+				v.text += format_real(read_float());
+			}
+			v.text += ')';
+			break;
+		}
+		case variant_node_path: {
+			v.type = value::kind::node_path;
+			const auto name_count = read_u32() ;
+			// name and subname counts are two 16 bit fields
+			const auto names = big_endian_ ? name_count >> 16 : name_count & 0xFFFF;
+			auto subnames = big_endian_ ? name_count & 0xFFFF : name_count >> 16;
+			const bool absolute = subnames & 0x8000;
+			subnames &= 0x7FFF;
+			if (format_ < format_version_no_nodepath_property) {
+				subnames += 1;
+			}
+
+			if (absolute) v.text += '/';
+			for (std::uint32_t i = 0; i < names && ok_; ++i) {
+				if (i) v.text += '/';
+				v.text += read_table_string();
+			}
+			for (std::uint32_t i = 0; i < subnames && ok_; ++i) {
+				const auto s = read_table_string();
+				if (s.empty()) continue;
+				v.text += ':';
+				v.text += s;
+			}
+			break;
+		}
+		case variant_rid:
+			v.type = value::kind::other;
+			v.text = "RID(" + std::to_string(read_u32()) + ")";
+			break;
+		case variant_callable:
+		case variant_signal:
+			v.type = value::kind::nil;
+			break;
+		case variant_object: {
+			const auto obj = read_u32();
+			if (obj == object_empty) {
+				v.type = value::kind::nil;
+			}
+			else if (obj == object_external_resource) {
+				v.type = value::kind::other;
+				read_string();
+				v.text = "Resource(\"" + std::string(read_string()) + "\")";
+			}
+			else if (obj == object_internal_resource) {
+				v.type = value::kind::sub_resource;
+				v.i = read_u32();
+			}
+			else if (obj == object_external_resource_index) {
+				v.type = value::kind::ext_resource;
+				v.i = read_u32();
+			}
+			else {
+				return ok_ = false;
+			}
+			break;
+		}
+		case variant_dictionary:
+		case variant_array: {
+			if (depth >= max_value_depth) return ok_ = false;
+			v.type = type == variant_array ? value::kind::array : value::kind::dictionary;
+			const auto len = (read_u32() & 0x7FFFFFFF) * (type == variant_array ? 1u : 2u);
+			for (std::uint32_t i = 0; i < len && ok_; ++i) {
+				value item;
+				if (!read_value(item, depth + 1)) return false;
+				v.items.push_back(std::move(item));
+			}
+			break;
+		}
+		case variant_packed_byte_array: {
+			const auto len = read_u32();
+			v.type = value::kind::other;
+			v.text = "PackedByteArray(" + std::to_string(len) + " bytes)";
+			pos_ += len + ((4 - len % 4) % 4);
+			if (pos_ > buffer_.size()) return ok_ = false;
+			break;
+		}
+		case variant_packed_int32_array: {
+			v.type = value::kind::int_array;
+			const auto len = read_u32();
+			if (pos_ + std::size_t(len) * 4 > buffer_.size()) return ok_ = false;
+			v.ints.reserve(len);
+			for (std::uint32_t i = 0; i < len; ++i) {
+				v.ints.push_back(static_cast<std::int32_t>(read_u32()));
+			}
+			break;
+		}
+		case variant_packed_string_array: {
+			v.type = value::kind::string_array;
+			const auto len = read_u32();
+			for (std::uint32_t i = 0; i < len && ok_; ++i) {
+				value item;
+				item.type = value::kind::string;
+				item.text = read_string();
+				v.items.push_back(std::move(item));
+			}
+			break;
+		}
+		case variant_packed_int64_array:
+		case variant_packed_float32_array:
+		case variant_packed_float64_array:
+		case variant_packed_vector2_array:
+		case variant_packed_vector3_array:
+		case variant_packed_vector4_array:
+		case variant_packed_color_array: {
+			const std::size_t real_size = real64_ ? 8 : 4;
+			const std::size_t elem = type == variant_packed_int64_array || type == variant_packed_float64_array ? 8
+				: type == variant_packed_float32_array ? 4
+				: type == variant_packed_vector2_array ? 2 * real_size
+				: type == variant_packed_vector3_array ? 3 * real_size
+				: type == variant_packed_vector4_array ? 4 * real_size
+				: 16;
+			const auto len = read_u32();
+			v.type = value::kind::other;
+			v.text = "PackedArray(" + std::to_string(len) + " items)";
+			pos_ += std::size_t(len) * elem;
+			if (pos_ > buffer_.size()) return ok_ = false;
+			break;
+		}
+		case variant_input_event:
+		default:
+#ifndef RELEASE
+			std::cerr << "[WARNING] unsupported binary variant type " << type << " in " << file_->get_path() << '\n';
+#endif
+			return ok_ = false;
+		}
+		return ok_;
+	}
+
+} // docs_gen_core
@@ -0,0 +1,106 @@
+#ifndef DOCS_GEN_RSRC_PARSER_H
+#define DOCS_GEN_RSRC_PARSER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "file.hpp"
+#include "project.hpp"
+#include "vfs.hpp"
+
+namespace docs_gen_core {
+
+	// Reader for Godot's binary resource format ("RSRC", .scn / .res). Fills the same
+	// scene_file / resource_file model as dott_parser, straight from the string table,
+	// external / internal resource tables and property blocks
+	class rsrc_parser {
+	public:
+		struct value {
+			enum class kind { nil, boolean, integer, real, string, node_path, ext_resource, sub_resource, array, dictionary, int_array, string_array, other };
+
+			kind type = kind::nil;
+			std::int64_t i = 0;
+			double f = 0.0;
+			std::string text;
+			std::vector<value> items;
+			std::vector<std::int32_t> ints;
+		};
+
+	private:
+		struct ext_entry {
+			std::string_view type;
+			std::string_view path;
+			std::uint64_t uid;
+		};
+
+		struct int_entry {
+			std::string_view path;
+			std::uint64_t offset;
+		};
+
+		std::filesystem::path root_path_;
+		dott_file* file_;
+
+		file_data data_;
+		std::string_view buffer_;
+		std::size_t pos_;
+		bool ok_;
+		bool big_endian_;
+		bool real64_;
+		std::uint32_t format_;
+		std::uint32_t flags_;
+
+		std::string_view type_;
+		std::uint64_t uid_;
+		std::string_view script_class_;
+		std::vector<std::string_view> strings_;
+		std::vector<ext_entry> ext_resources_;
+		std::vector<int_entry> int_resources_;
+
+	public:
+		explicit rsrc_parser(dott_file& file);
+		rsrc_parser(dott_file& file, file_data data);
+
+		// file is the one the parser was constructed with, the overload picks the model to fill
+		bool parse_header(scene_file& file);
+		bool parse_header(resource_file& file);
+		bool parse_contents(scene_file& file, const project& project);
+		bool parse_contents(resource_file& file, const project& project);
+
+		void set_root_path(const std::filesystem::path& path) { root_path_ = path; }
+
+		[[nodiscard]] static std::wstring uid_to_text(std::uint64_t uid);
+		[[nodiscard]] static bool is_binary_resource(const std::filesystem::path& path);
+
+	private:
+		bool read_header();
+		void check_uid(const std::filesystem::path& path, const std::wstring& uid) const;
+		void push_ext_resources(const project& project);
+		bool read_internal_resource(std::size_t index, std::string_view& type,
+			std::vector<std::pair<std::string_view, value>>& props);
+		void fill_resource(resource_file& file, resource_file::resource& r,
+			const std::vector<std::pair<std::string_view, value>>& props) const;
+		bool fill_node_tree(scene_file& file, const value& bundled);
+
+		[[nodiscard]] std::wstring sub_resource_id(std::size_t index) const;
+		[[nodiscard]] std::string to_text(const value& v) const;
+
+		std::uint32_t read_u32();
+		std::uint64_t read_u64();
+		float read_float();
+		double read_double();
+		double read_real();
+		std::string_view read_string();
+		std::string_view read_table_string();
+		// depth counts the arrays and dictionaries v is nested in
+		bool read_value(value& v, std::size_t depth = 0);
+		void append_reals(value& v, const char* name, std::size_t count);
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_RSRC_PARSER_H
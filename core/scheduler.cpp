@@ -0,0 +1,166 @@
+#include "scheduler.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace docs_gen_core {
+
+	task_scheduler::task_scheduler(std::size_t workers)
+		: workers_(workers == 0 ? std::max(1u, std::thread::hardware_concurrency()) : workers) {
+	}
+
+	task_scheduler::task_scheduler(std::size_t workers, worker_pool* pool)
+		: task_scheduler(workers) {
+		pool_ = pool;
+	}
+
+	void task_scheduler::run(std::vector<task> tasks) const {
+		if (tasks.empty())
+			return;
+
+		if (pool_) {
+			pool_->run(std::move(tasks));
+			return;
+		}
+
+		std::stable_sort(tasks.begin(), tasks.end(), [](const task& a, const task& b) { return a.cost > b.cost; });
+
+		const auto count = std::min(workers_, tasks.size());
+		if (count == 1) {
+			for (auto& t : tasks) {
+				t.run();
+			}
+			return;
+		}
+
+		std::vector<std::unique_ptr<worker_queue>> queues;
+		for (std::size_t i = 0; i < count; ++i) {
+			queues.push_back(std::make_unique<worker_queue>());
+		}
+		for (std::size_t i = 0; i < tasks.size(); ++i) {
+			queues[i % count]->tasks.push_back(std::move(tasks[i]));
+		}
+
+		// tasks never spawn new ones, so once every queue is empty a worker can stop
+		const auto work = [&queues](std::size_t self) {
+			task t;
+			while (pop_own(*queues[self], t) || steal(queues, self, t)) {
+				t.run();
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for (std::size_t i = 1; i < count; ++i) {
+			threads.emplace_back(work, i);
+		}
+		work(0);
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+
+	bool task_scheduler::pop_own(worker_queue& q, task& t) {
+		std::lock_guard lock{ q.mutex };
+		if (q.tasks.empty())
+			return false;
+
+		t = std::move(q.tasks.front());
+		q.tasks.pop_front();
+		return true;
+	}
+
+	bool task_scheduler::steal(std::vector<std::unique_ptr<worker_queue>>& queues, std::size_t self, task& t) {
+		for (std::size_t i = 1; i < queues.size(); ++i) {
+			auto& victim = *queues[(self + i) % queues.size()];
+			std::lock_guard lock{ victim.mutex };
+			if (victim.tasks.empty())
+				continue;
+
+			t = std::move(victim.tasks.back());
+			victim.tasks.pop_back();
+			return true;
+		}
+		return false;
+	}
+
+	worker_pool::worker_pool(std::size_t threads) {
+		const auto count = threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+		for (std::size_t i = 0; i < count; ++i) {
+			threads_.emplace_back([this] { work(); });
+		}
+	}
+
+	worker_pool::~worker_pool() {
+		{
+			std::lock_guard lock{ mutex_ };
+			stop_ = true;
+		}
+		wake_.notify_all();
+		for (auto& thread : threads_) {
+			thread.join();
+		}
+	}
+
+	void worker_pool::run(std::vector<task_scheduler::task> tasks) {
+		if (tasks.empty())
+			return;
+
+		std::stable_sort(tasks.begin(), tasks.end(), [](const task_scheduler::task& a, const task_scheduler::task& b) { return a.cost > b.cost; });
+		batch b{ { std::make_move_iterator(tasks.begin()), std::make_move_iterator(tasks.end()) }, tasks.size() };
+		{
+			std::lock_guard lock{ mutex_ };
+			batches_.push_back(&b);
+		}
+		wake_.notify_all();
+
+		for (;;) {
+			task_scheduler::task t;
+			{
+				std::lock_guard lock{ mutex_ };
+				if (b.tasks.empty())
+					break;
+				t = take(b);
+			}
+			t.run();
+			finish(b);
+		}
+
+		// the last tasks may still be running on pool threads, b has to outlive them
+		std::unique_lock lock{ mutex_ };
+		done_.wait(lock, [&b] { return b.pending == 0; });
+	}
+
+	void worker_pool::work() {
+		for (;;) {
+			task_scheduler::task t;
+			batch* b;
+			{
+				std::unique_lock lock{ mutex_ };
+				wake_.wait(lock, [this] { return stop_ || !batches_.empty(); });
+				if (batches_.empty())
+					return;
+				b = batches_[next_++ % batches_.size()];
+				t = take(*b);
+			}
+			t.run();
+			finish(*b);
+		}
+	}
+
+	task_scheduler::task worker_pool::take(batch& b) {
+		auto t = std::move(b.tasks.front());
+		b.tasks.pop_front();
+		if (b.tasks.empty()) {
+			batches_.erase(std::find(batches_.begin(), batches_.end(), &b));
+		}
+		return t;
+	}
+
+	void worker_pool::finish(batch& b) {
+		std::lock_guard lock{ mutex_ };
+		if (--b.pending == 0) {
+			done_.notify_all();
+		}
+	}
+
+} // docs_gen_core
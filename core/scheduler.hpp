@@ -0,0 +1,102 @@
+#ifndef DOCS_GEN_SCHEDULER_H
+#define DOCS_GEN_SCHEDULER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace docs_gen_core {
+
+	class worker_pool;
+
+	// Runs a batch of independent tasks on a fixed number of threads. Tasks are started
+	// largest-first by cost (file size) and dealt round-robin into per-worker deques, a worker
+	// that runs dry steals from the back of the others, so one huge level does not leave
+	// the rest of the threads idle behind a static split
+	class task_scheduler {
+	public:
+		struct task {
+			std::uint64_t cost;
+			std::function<void()> run;
+		};
+
+	private:
+		struct worker_queue {
+			std::mutex mutex;
+			std::deque<task> tasks;
+		};
+
+		std::size_t workers_;
+		worker_pool* pool_ = nullptr;
+
+	public:
+		explicit task_scheduler(std::size_t workers = 0);
+		// Hands every run to pool instead of starting threads, workers is ignored then
+		task_scheduler(std::size_t workers, worker_pool* pool);
+		task_scheduler(const task_scheduler& other) = delete;
+		task_scheduler(task_scheduler&& other) = delete;
+		~task_scheduler() = default;
+
+		task_scheduler& operator=(const task_scheduler& other) = delete;
+		task_scheduler& operator=(task_scheduler&& other) = delete;
+
+		[[nodiscard]] std::size_t workers() const { return workers_; }
+
+		// Blocks until every task has run
+		void run(std::vector<task> tasks) const;
+
+	private:
+		static bool pop_own(worker_queue& q, task& t);
+		static bool steal(std::vector<std::unique_ptr<worker_queue>>& queues, std::size_t self, task& t);
+	};
+
+	// Threads shared by several task_schedulers running at the same time, e.g. every project of
+	// a batch, so they split one set of cores instead of each starting its own threads.
+	// Each run is queued as a batch, largest task first. Pool threads take turns between the
+	// batches and the thread calling run works on its own batch, so a run makes progress even
+	// while the pool is busy elsewhere
+	class worker_pool {
+		struct batch {
+			std::deque<task_scheduler::task> tasks;
+			std::size_t pending;
+		};
+
+		std::mutex mutex_;
+		std::condition_variable wake_;
+		std::condition_variable done_;
+		// batches with tasks nobody has started yet
+		std::vector<batch*> batches_;
+		std::size_t next_ = 0;
+		bool stop_ = false;
+		std::vector<std::thread> threads_;
+
+	public:
+		// 0 means one thread per core
+		explicit worker_pool(std::size_t threads = 0);
+		worker_pool(const worker_pool& other) = delete;
+		worker_pool(worker_pool&& other) = delete;
+		~worker_pool();
+
+		worker_pool& operator=(const worker_pool& other) = delete;
+		worker_pool& operator=(worker_pool&& other) = delete;
+
+		[[nodiscard]] std::size_t threads() const { return threads_.size(); }
+
+		// Blocks until every task has run
+		void run(std::vector<task_scheduler::task> tasks);
+
+	private:
+		void work();
+		// Takes the next task of b, mutex_ must be held
+		task_scheduler::task take(batch& b);
+		void finish(batch& b);
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_SCHEDULER_H
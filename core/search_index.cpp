@@ -0,0 +1,460 @@
+#include "search_index.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <iterator>
+
+#include "util/flat_map.hpp"
+
+namespace docs_gen_core {
+
+	namespace {
+
+		// In bit order of search_field
+		constexpr std::string_view field_table[] = { "name", "class", "function", "variable", "tag", "type", "node" };
+
+		bool is_upper(wchar_t c) { return c >= 'A' && c <= 'Z'; }
+		bool is_lower(wchar_t c) { return c >= 'a' && c <= 'z'; }
+		bool is_digit(wchar_t c) { return c >= '0' && c <= '9'; }
+		bool is_word(wchar_t c) { return is_upper(c) || is_lower(c) || is_digit(c) || c == '_'; }
+
+		char lower(wchar_t c) { return static_cast<char>(is_upper(c) ? c - 'A' + 'a' : c); }
+
+		void append_lower(std::string& out, std::wstring_view s) {
+			for (const auto c : s) {
+				out.push_back(lower(c));
+			}
+		}
+
+		void append_json_string(std::string& out, std::string_view s) {
+			out.push_back('"');
+			for (const auto c : s) {
+				switch (c) {
+				case '"': out.append("\\\""); break;
+				case '\\': out.append("\\\\"); break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20) {
+						static constexpr char hex[] = "0123456789abcdef";
+						out.append("\\u00");
+						out.push_back(hex[(c >> 4) & 0xF]);
+						out.push_back(hex[c & 0xF]);
+					}
+					else {
+						out.push_back(c);
+					}
+				}
+			}
+			out.push_back('"');
+		}
+
+		void append_number(std::string& out, std::uint32_t n) {
+			char digits[10];
+			const auto end = std::to_chars(digits, digits + sizeof(digits), n).ptr;
+			out.append(digits, static_cast<std::size_t>(end - digits));
+		}
+
+		// Collects a page's tokens, a token found in several fields is kept once
+		class page_terms {
+			util::flat_map<std::string, std::uint8_t> terms_;
+			std::vector<std::string> tokens_;
+
+		public:
+			void add(search_field field, std::wstring_view text) {
+				tokens_.clear();
+				search_index::tokenize(text, tokens_);
+				for (auto& token : tokens_) {
+					terms_[std::move(token)] |= static_cast<std::uint8_t>(field);
+				}
+			}
+
+			std::vector<std::pair<std::string, std::uint8_t>> take() {
+				std::vector<std::pair<std::string, std::uint8_t>> out;
+				out.reserve(terms_.size());
+				for (auto& [token, fields] : terms_) {
+					out.emplace_back(std::move(token), fields);
+				}
+				return out;
+			}
+		};
+
+		// Just enough JSON for reading back what search_index::to_json writes
+		class json_cursor {
+			std::string_view s_;
+			std::size_t pos_ = 0;
+
+		public:
+			explicit json_cursor(std::string_view s) : s_(s) {}
+
+			bool eat(char c) {
+				skip_space();
+				if (pos_ < s_.size() && s_[pos_] == c) {
+					++pos_;
+					return true;
+				}
+				return false;
+			}
+
+			bool string(std::string& out) {
+				out.clear();
+				if (!eat('"'))
+					return false;
+				while (pos_ < s_.size()) {
+					const char c = s_[pos_++];
+					if (c == '"')
+						return true;
+					if (c != '\\') {
+						out.push_back(c);
+						continue;
+					}
+					if (pos_ >= s_.size())
+						return false;
+					switch (const char e = s_[pos_++]) {
+					case 'n': out.push_back('\n'); break;
+					case 't': out.push_back('\t'); break;
+					case 'r': out.push_back('\r'); break;
+					case 'b': out.push_back('\b'); break;
+					case 'f': out.push_back('\f'); break;
+					case 'u': {
+						unsigned code = 0;
+						if (pos_ + 4 > s_.size() || std::from_chars(s_.data() + pos_, s_.data() + pos_ + 4, code, 16).ptr != s_.data() + pos_ + 4)
+							return false;
+						pos_ += 4;
+						// only control characters are escaped this way, anything else is UTF-8 already
+						if (code >= 0x80)
+							return false;
+						out.push_back(static_cast<char>(code));
+						break;
+					}
+					default: out.push_back(e); break;
+					}
+				}
+				return false;
+			}
+
+			bool number(std::uint32_t& out) {
+				skip_space();
+				const auto result = std::from_chars(s_.data() + pos_, s_.data() + s_.size(), out);
+				if (result.ec != std::errc{})
+					return false;
+				pos_ = static_cast<std::size_t>(result.ptr - s_.data());
+				return true;
+			}
+
+			// Calls element() for each element of an array or member of an object until close
+			template <typename Fn>
+			bool list(char open, char close, Fn&& element) {
+				if (!eat(open))
+					return false;
+				if (eat(close))
+					return true;
+				do {
+					if (!element())
+						return false;
+				} while (eat(','));
+				return eat(close);
+			}
+
+			[[nodiscard]] bool at_end() {
+				skip_space();
+				return pos_ == s_.size();
+			}
+
+		private:
+			void skip_space() {
+				while (pos_ < s_.size() && (s_[pos_] == ' ' || s_[pos_] == '\t' || s_[pos_] == '\n' || s_[pos_] == '\r')) ++pos_;
+			}
+		};
+
+	} // anonymous
+
+	search_index::search_index(std::size_t size)
+		: pages_(size) {
+	}
+
+	void search_index::add(std::uint32_t id, std::string path, const scene_file& file) {
+		page_terms terms;
+		terms.add(search_field::name, file.get_path().stem().wstring());
+		for (const auto& node : file.get_node_tree()) {
+			terms.add(search_field::node, node->name);
+			terms.add(search_field::type, node->type);
+		}
+		pages_[id] = { std::move(path), terms.take() };
+	}
+
+	void search_index::add(std::uint32_t id, std::string path, const resource_file& file) {
+		page_terms terms;
+		terms.add(search_field::name, file.get_path().stem().wstring());
+		terms.add(search_field::class_name, file.get_script_class());
+		terms.add(search_field::type, file.get_resource().type);
+		for (const auto& res : file.get_sub_resources()) {
+			terms.add(search_field::type, res.type);
+		}
+		pages_[id] = { std::move(path), terms.take() };
+	}
+
+	void search_index::add(std::uint32_t id, std::string path, const script_file& file) {
+		const auto& c = file.get_script_class();
+		page_terms terms;
+		terms.add(search_field::name, file.get_path().stem().wstring());
+		terms.add(search_field::class_name, c.name);
+		terms.add(search_field::class_name, c.parent);
+		for (const auto& tag : c.tags) {
+			terms.add(search_field::tag, tag);
+		}
+		for (const auto& category : c.categories) {
+			for (const auto& v : category.variables) {
+				terms.add(search_field::variable, v.name);
+			}
+		}
+		for (const auto& f : c.functions) {
+			terms.add(search_field::function, f.name);
+		}
+		pages_[id] = { std::move(path), terms.take() };
+	}
+
+	std::string search_index::to_json() const {
+		std::vector<const page*> pages;
+		pages.reserve(pages_.size());
+		for (const auto& p : pages_) {
+			if (!p.path.empty()) {
+				pages.push_back(&p);
+			}
+		}
+		std::sort(pages.begin(), pages.end(), [](const page* a, const page* b) { return a->path < b->path; });
+
+		struct posting {
+			std::string_view token;
+			std::uint32_t page;
+			std::uint8_t fields;
+		};
+		std::size_t count = 0;
+		for (const auto* p : pages) {
+			count += p->terms.size();
+		}
+		std::vector<posting> postings;
+		postings.reserve(count);
+		for (std::uint32_t i = 0; i < pages.size(); ++i) {
+			for (const auto& [token, fields] : pages[i]->terms) {
+				postings.push_back({ token, i, fields });
+			}
+		}
+		// a page has each token once, so token and page order every posting
+		std::sort(postings.begin(), postings.end(), [](const posting& a, const posting& b) {
+			return a.token != b.token ? a.token < b.token : a.page < b.page;
+		});
+
+		std::string out;
+		out.append(R"({"version":)");
+		append_number(out, format_version);
+		out.append(R"(,"fields":[)");
+		for (const auto& name : field_table) {
+			if (&name != field_table) out.push_back(',');
+			append_json_string(out, name);
+		}
+		out.append(R"(],"pages":[)");
+		for (const auto* p : pages) {
+			if (p != pages.front()) out.push_back(',');
+			append_json_string(out, p->path);
+		}
+		out.append(R"(],"tokens":{)");
+		for (std::size_t i = 0; i < postings.size(); ++i) {
+			if (i == 0 || postings[i].token != postings[i - 1].token) {
+				if (i != 0) out.append("],");
+				append_json_string(out, postings[i].token);
+				out.append(":[");
+			}
+			else {
+				out.push_back(',');
+			}
+			append_number(out, postings[i].page);
+			out.push_back(',');
+			append_number(out, postings[i].fields);
+		}
+		if (!postings.empty()) out.push_back(']');
+		out.append("}}\n");
+		return out;
+	}
+
+	void search_index::tokenize(std::wstring_view text, std::vector<std::string>& out) {
+		std::size_t i = 0;
+		while (i < text.size()) {
+			if (!is_word(text[i])) {
+				++i;
+				continue;
+			}
+			auto begin = i;
+			while (i < text.size() && is_word(text[i])) ++i;
+			auto end = i;
+			while (begin < end && text[begin] == '_') ++begin;
+			while (end > begin && text[end - 1] == '_') --end;
+			const auto word = text.substr(begin, end - begin);
+			if (word.size() < 2)
+				continue;
+
+			out.emplace_back();
+			append_lower(out.back(), word);
+
+			// a piece with digits is also split where they start (Enemy1 -> enemy, Body2D -> body, 2d)
+			const auto push_digit_parts = [&](std::wstring_view piece) {
+				std::size_t from = 0;
+				for (std::size_t k = 1; k <= piece.size(); ++k) {
+					if (k < piece.size() && (is_digit(piece[k - 1]) || !is_digit(piece[k])))
+						continue;
+					if (from == 0 && k == piece.size())
+						break;
+					if (k - from >= 2) {
+						out.emplace_back();
+						append_lower(out.back(), piece.substr(from, k - from));
+					}
+					from = k;
+				}
+			};
+
+			// parts split at '_', "aB" and "ABc" (HTTPRequest -> http, request)
+			std::size_t part = 0;
+			std::size_t parts = 0;
+			const auto push_part = [&](std::size_t to) {
+				if (to - part >= 2) {
+					std::string s;
+					append_lower(s, word.substr(part, to - part));
+					out.push_back(std::move(s));
+					push_digit_parts(word.substr(part, to - part));
+				}
+				++parts;
+			};
+			for (std::size_t k = 1; k < word.size(); ++k) {
+				if (word[k] == '_') {
+					push_part(k);
+					part = k + 1;
+				}
+				else if ((is_lower(word[k - 1]) && is_upper(word[k]))
+					|| (is_upper(word[k - 1]) && is_upper(word[k]) && k + 1 < word.size() && is_lower(word[k + 1]))) {
+					push_part(k);
+					part = k;
+				}
+			}
+			// a single part is the whole word again
+			if (parts == 0) {
+				push_digit_parts(word);
+				continue;
+			}
+			push_part(word.size());
+		}
+	}
+
+	search_index_reader::search_index_reader(const std::filesystem::path& path) {
+		std::ifstream in{ path, std::ios::binary };
+		if (!in)
+			return;
+		const std::string json{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+		valid_ = parse(json);
+		if (!valid_) {
+			pages_.clear();
+			tokens_.clear();
+		}
+	}
+
+	bool search_index_reader::parse(std::string_view json) {
+		json_cursor in{ json };
+		std::string key;
+		std::uint32_t version = 0;
+		const bool parsed = in.list('{', '}', [&] {
+			if (!in.string(key) || !in.eat(':'))
+				return false;
+			if (key == "version")
+				return in.number(version);
+			if (key == "fields") {
+				std::string name;
+				return in.list('[', ']', [&] { return in.string(name); });
+			}
+			if (key == "pages") {
+				return in.list('[', ']', [&] { return in.string(pages_.emplace_back()); });
+			}
+			if (key == "tokens") {
+				return in.list('{', '}', [&] {
+					auto& [token, postings] = tokens_.emplace_back();
+					return in.string(token) && in.eat(':') && in.list('[', ']', [&] { return in.number(postings.emplace_back()); });
+				});
+			}
+			return false;
+		});
+		if (!parsed || !in.at_end() || version != search_index::format_version)
+			return false;
+
+		for (const auto& [token, postings] : tokens_) {
+			if (postings.size() % 2 != 0)
+				return false;
+			for (std::size_t i = 0; i < postings.size(); i += 2) {
+				if (postings[i] >= pages_.size())
+					return false;
+			}
+		}
+		if (!std::is_sorted(tokens_.begin(), tokens_.end(), [](const auto& a, const auto& b) { return a.first < b.first; })) {
+			std::sort(tokens_.begin(), tokens_.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+		}
+		return true;
+	}
+
+	std::vector<search_index_reader::hit> search_index_reader::find(const std::vector<std::string>& terms) const {
+		if (terms.empty())
+			return {};
+
+		// fields each page matched every term so far with, 0 once a term missed it
+		std::vector<std::uint8_t> result;
+		std::vector<std::uint8_t> matched(pages_.size());
+		for (const auto& term : terms) {
+			std::string_view text = term;
+			std::uint8_t mask = 0xFF;
+			if (const auto colon = text.find(':'); colon != std::string_view::npos) {
+				const auto it = std::find(std::begin(field_table), std::end(field_table), text.substr(0, colon));
+				if (it == std::end(field_table))
+					return {};
+				mask = static_cast<std::uint8_t>(1u << (it - std::begin(field_table)));
+				text.remove_prefix(colon + 1);
+			}
+			const bool prefix = !text.empty() && text.back() == '*';
+			if (prefix) text.remove_suffix(1);
+			std::string token;
+			for (const auto c : text) {
+				token.push_back(lower(static_cast<unsigned char>(c)));
+			}
+
+			std::fill(matched.begin(), matched.end(), 0);
+			auto it = std::lower_bound(tokens_.begin(), tokens_.end(), token, [](const auto& a, const std::string& b) { return a.first < b; });
+			for (; it != tokens_.end() && (prefix ? it->first.compare(0, token.size(), token) == 0 : it->first == token); ++it) {
+				const auto& postings = it->second;
+				for (std::size_t i = 0; i < postings.size(); i += 2) {
+					matched[postings[i]] |= static_cast<std::uint8_t>(postings[i + 1] & mask);
+				}
+			}
+			if (result.empty()) {
+				result = matched;
+				continue;
+			}
+			for (std::size_t i = 0; i < result.size(); ++i) {
+				result[i] = result[i] != 0 && matched[i] != 0 ? static_cast<std::uint8_t>(result[i] | matched[i]) : 0;
+			}
+		}
+
+		std::vector<hit> hits;
+		for (std::size_t i = 0; i < result.size(); ++i) {
+			if (result[i] != 0) {
+				hits.push_back({ &pages_[i], result[i] });
+			}
+		}
+		return hits;
+	}
+
+	std::string search_index_reader::field_names(std::uint8_t fields) {
+		std::string out;
+		for (std::size_t i = 0; i < std::size(field_table); ++i) {
+			if (fields & (1u << i)) {
+				if (!out.empty()) out.push_back(',');
+				out.append(field_table[i]);
+			}
+		}
+		return out;
+	}
+
+} // docs_gen_core
@@ -0,0 +1,109 @@
+#ifndef DOCS_GEN_SEARCH_INDEX_H
+#define DOCS_GEN_SEARCH_INDEX_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "file.hpp"
+
+namespace docs_gen_core {
+
+	// Where a token was found on a page, a page's fields for one token are or'ed together
+	enum class search_field : std::uint8_t {
+		// file name without extension
+		name = 1,
+		// class_name and base class of a script, script class of a resource
+		class_name = 2,
+		function = 4,
+		// exported variables
+		variable = 8,
+		tag = 16,
+		// node and resource types
+		type = 32,
+		// node names
+		node = 64,
+	};
+
+	// Inverted index from tokens to the docs they appear in, written next to the docs as
+	// search_index.json for static-site search and --search:
+	//   {"version":1,"fields":["name","class","function","variable","tag","type","node"],
+	//    "pages":["scripts/player.gd.md",...],"tokens":{"jump":[page,fields,page,fields,...],...}}
+	// Pages are doc paths relative to the docs folder, sorted; tokens are sorted and map to flat
+	// (page number, field bits) pairs, bit i standing for fields[i].
+	//
+	// Identifiers are lowercased and indexed whole and by their parts, so "take_damage" and
+	// "TakeDamage" are found by "take" and "damage" too, and "Enemy1" by "enemy".
+	// Every doc gets its own slot, so emitting threads add their pages without locking
+	class search_index {
+		struct page {
+			std::string path;
+			std::vector<std::pair<std::string, std::uint8_t>> terms;
+		};
+
+		std::vector<page> pages_;
+
+	public:
+		static constexpr std::uint32_t format_version = 1;
+
+		// Slots for ids 0..size-1, dependency_graph ids
+		explicit search_index(std::size_t size);
+		search_index(const search_index& other) = delete;
+		search_index(search_index&& other) = delete;
+		~search_index() = default;
+
+		search_index& operator=(const search_index& other) = delete;
+		search_index& operator=(search_index&& other) = delete;
+
+		// path is the doc's path relative to the docs folder. Each id must be added once at most
+		void add(std::uint32_t id, std::string path, const scene_file& file);
+		void add(std::uint32_t id, std::string path, const resource_file& file);
+		void add(std::uint32_t id, std::string path, const script_file& file);
+
+		[[nodiscard]] std::string to_json() const;
+
+		// Lowercased tokens of text, whole identifiers first and then their parts
+		static void tokenize(std::wstring_view text, std::vector<std::string>& out);
+	};
+
+	// Loads a search_index.json and answers queries on it
+	class search_index_reader {
+		std::vector<std::string> pages_;
+		// sorted by token
+		std::vector<std::pair<std::string, std::vector<std::uint32_t>>> tokens_;
+		bool valid_ = false;
+
+	public:
+		struct hit {
+			const std::string* path;
+			std::uint8_t fields;
+		};
+
+		explicit search_index_reader(const std::filesystem::path& path);
+		search_index_reader(const search_index_reader& other) = delete;
+		search_index_reader(search_index_reader&& other) = delete;
+		~search_index_reader() = default;
+
+		search_index_reader& operator=(const search_index_reader& other) = delete;
+		search_index_reader& operator=(search_index_reader&& other) = delete;
+
+		[[nodiscard]] bool is_open() const { return valid_; }
+		[[nodiscard]] std::size_t size() const { return pages_.size(); }
+
+		// Pages matching every term, sorted by path. A term is a token, "prefix*" or
+		// "field:term" to only match that field, e.g. "function:jump"
+		[[nodiscard]] std::vector<hit> find(const std::vector<std::string>& terms) const;
+
+		// "function,tag" for the bits of fields
+		[[nodiscard]] static std::string field_names(std::uint8_t fields);
+
+	private:
+		bool parse(std::string_view json);
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_SEARCH_INDEX_H
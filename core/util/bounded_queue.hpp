@@ -0,0 +1,104 @@
+#ifndef DOCS_GEN_BOUNDED_QUEUE_H
+#define DOCS_GEN_BOUNDED_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace docs_gen_core::util {
+
+	// Fixed capacity lock-free FIFO for any number of producers and consumers (a ring of
+	// sequence-stamped cells, after Vyukov). It never blocks, callers decide how to wait
+	// when try_push / try_pop fail, which is where back-pressure comes from
+	template <typename T>
+	class bounded_queue {
+		struct cell {
+			std::atomic<std::size_t> sequence;
+			T data;
+		};
+
+		std::unique_ptr<cell[]> cells_;
+		std::size_t mask_;
+
+		alignas(64) std::atomic<std::size_t> enqueue_pos_;
+		alignas(64) std::atomic<std::size_t> dequeue_pos_;
+
+	public:
+		// capacity is rounded up to a power of two
+		explicit bounded_queue(std::size_t capacity)
+			: enqueue_pos_(0), dequeue_pos_(0) {
+			std::size_t size = 2;
+			while (size < capacity) size <<= 1;
+
+			cells_ = std::make_unique<cell[]>(size);
+			mask_ = size - 1;
+			for (std::size_t i = 0; i < size; ++i) {
+				cells_[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+		bounded_queue(const bounded_queue& other) = delete;
+		bounded_queue(bounded_queue&& other) = delete;
+		~bounded_queue() = default;
+
+		bounded_queue& operator=(const bounded_queue& other) = delete;
+		bounded_queue& operator=(bounded_queue&& other) = delete;
+
+		// Moves item in and returns true, or leaves it untouched if the queue is full
+		bool try_push(T& item) {
+			auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+			while (true) {
+				auto& c = cells_[pos & mask_];
+				const auto seq = c.sequence.load(std::memory_order_acquire);
+				const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+				if (diff == 0) {
+					if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						c.data = std::move(item);
+						c.sequence.store(pos + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0) {
+					return false;
+				}
+				else {
+					pos = enqueue_pos_.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		bool try_pop(T& item) {
+			auto pos = dequeue_pos_.load(std::memory_order_relaxed);
+			while (true) {
+				auto& c = cells_[pos & mask_];
+				const auto seq = c.sequence.load(std::memory_order_acquire);
+				const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+				if (diff == 0) {
+					if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						item = std::move(c.data);
+						c.data = T{};
+						c.sequence.store(pos + mask_ + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0) {
+					return false;
+				}
+				else {
+					pos = dequeue_pos_.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		// Only a snapshot, other threads may change it right after
+		[[nodiscard]] std::size_t size() const {
+			const auto enq = enqueue_pos_.load(std::memory_order_relaxed);
+			const auto deq = dequeue_pos_.load(std::memory_order_relaxed);
+			return enq > deq ? enq - deq : 0;
+		}
+
+		[[nodiscard]] std::size_t capacity() const { return mask_ + 1; }
+	};
+
+} // docs_gen_core::util
+
+#endif // DOCS_GEN_BOUNDED_QUEUE_H
@@ -0,0 +1,431 @@
+#ifndef DOCS_GEN_FLAT_MAP_H
+#define DOCS_GEN_FLAT_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DOCS_GEN_FLAT_MAP_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace docs_gen_core::util {
+
+	// Fast non-cryptographic hash over the bytes of a string, eight bytes per step with a
+	// multiply-rotate round and a murmur3 finalizer so both the low and the high bits mix well
+	struct string_hash {
+		static std::uint64_t hash_bytes(const void* data, std::size_t size) noexcept {
+			constexpr std::uint64_t k0 = 0x9E3779B97F4A7C15ull;
+			constexpr std::uint64_t k1 = 0xC2B2AE3D27D4EB4Full;
+			const auto rotl = [](std::uint64_t x, int r) { return (x << r) | (x >> (64 - r)); };
+
+			const auto* p = static_cast<const unsigned char*>(data);
+			std::uint64_t h = k1 ^ (size * k0);
+			while (size >= 8) {
+				std::uint64_t w;
+				std::memcpy(&w, p, 8);
+				h = rotl(h ^ (w * k1), 31) * k0;
+				p += 8;
+				size -= 8;
+			}
+			if (size > 0) {
+				std::uint64_t w = 0;
+				std::memcpy(&w, p, size);
+				h = rotl(h ^ (w * k1), 31) * k0;
+			}
+
+			h ^= h >> 33;
+			h *= 0xFF51AFD7ED558CCDull;
+			h ^= h >> 33;
+			h *= 0xC4CEB9FE1A85EC53ull;
+			h ^= h >> 33;
+			return h;
+		}
+
+		std::size_t operator()(std::string_view s) const noexcept {
+			return static_cast<std::size_t>(hash_bytes(s.data(), s.size()));
+		}
+		std::size_t operator()(std::wstring_view s) const noexcept {
+			return static_cast<std::size_t>(hash_bytes(s.data(), s.size() * sizeof(wchar_t)));
+		}
+	};
+
+	// Open addressing hash map in the style of SwissTable. Every slot has a control byte that is
+	// either empty, deleted or the low 7 bits of the key's hash. Lookups probe 16 control bytes
+	// at a time (one SSE2 compare where available) and only touch slots whose byte matches,
+	// keys and values live inline in one array, so there is no allocation per element.
+	// Unlike std::unordered_map, inserting may invalidate iterators and references, and the key
+	// is not const in the stored pair: never change it through an iterator.
+	// Lookups take anything Hash and Eq accept, e.g. a wstring_view or a literal for wstring keys
+	template <typename K, typename V, typename Hash = string_hash, typename Eq = std::equal_to<>>
+	class flat_map {
+	public:
+		using key_type = K;
+		using mapped_type = V;
+		using value_type = std::pair<K, V>;
+		using size_type = std::size_t;
+
+	private:
+		using ctrl_t = std::int8_t;
+		static constexpr ctrl_t empty_ctrl = -128;
+		static constexpr ctrl_t deleted_ctrl = -2;
+		static constexpr size_type group_width = 16;
+		static constexpr size_type npos = ~size_type{ 0 };
+
+		// bit i is set if control byte i of the group matched
+		class group {
+#ifdef DOCS_GEN_FLAT_MAP_SSE2
+			__m128i ctrl_;
+
+		public:
+			explicit group(const ctrl_t* ctrl)
+				: ctrl_(_mm_load_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+			[[nodiscard]] std::uint32_t match(ctrl_t h2) const {
+				return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)));
+			}
+			[[nodiscard]] std::uint32_t match_empty() const { return match(empty_ctrl); }
+			// empty and deleted are the only negative control bytes
+			[[nodiscard]] std::uint32_t match_free() const {
+				return static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl_));
+			}
+#else
+			const ctrl_t* ctrl_;
+
+		public:
+			explicit group(const ctrl_t* ctrl) : ctrl_(ctrl) {}
+
+			[[nodiscard]] std::uint32_t match(ctrl_t h2) const {
+				std::uint32_t mask = 0;
+				for (size_type i = 0; i < group_width; ++i) {
+					if (ctrl_[i] == h2) mask |= 1u << i;
+				}
+				return mask;
+			}
+			[[nodiscard]] std::uint32_t match_empty() const { return match(empty_ctrl); }
+			[[nodiscard]] std::uint32_t match_free() const {
+				std::uint32_t mask = 0;
+				for (size_type i = 0; i < group_width; ++i) {
+					if (ctrl_[i] < 0) mask |= 1u << i;
+				}
+				return mask;
+			}
+#endif
+		};
+
+		static size_type lowest_bit(std::uint32_t mask) {
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanForward(&index, mask);
+			return index;
+#else
+			return static_cast<size_type>(__builtin_ctz(mask));
+#endif
+		}
+
+		struct ctrl_deleter {
+			void operator()(ctrl_t* p) const { ::operator delete(p, std::align_val_t{ group_width }); }
+		};
+
+		std::unique_ptr<ctrl_t, ctrl_deleter> ctrl_;
+		value_type* slots_ = nullptr;
+		size_type capacity_ = 0;
+		size_type size_ = 0;
+		size_type growth_left_ = 0;
+		Hash hash_;
+		Eq eq_;
+
+		template <bool Const>
+		class basic_iterator {
+			friend class flat_map;
+			template <bool>
+			friend class basic_iterator;
+			using map_type = std::conditional_t<Const, const flat_map, flat_map>;
+
+			map_type* map_ = nullptr;
+			size_type index_ = 0;
+
+			basic_iterator(map_type* map, size_type index) : map_(map), index_(index) { skip_free(); }
+
+			void skip_free() {
+				while (index_ < map_->capacity_ && map_->ctrl_.get()[index_] < 0) ++index_;
+			}
+
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = std::conditional_t<Const, const flat_map::value_type, flat_map::value_type>;
+			using difference_type = std::ptrdiff_t;
+			using pointer = value_type*;
+			using reference = value_type&;
+
+			basic_iterator() = default;
+			// iterator -> const_iterator
+			template <bool C = Const, typename = std::enable_if_t<C>>
+			basic_iterator(const basic_iterator<false>& other) : map_(other.map_), index_(other.index_) {}
+
+			reference operator*() const { return map_->slots_[index_]; }
+			pointer operator->() const { return &map_->slots_[index_]; }
+
+			basic_iterator& operator++() {
+				++index_;
+				skip_free();
+				return *this;
+			}
+			basic_iterator operator++(int) {
+				auto tmp = *this;
+				++*this;
+				return tmp;
+			}
+
+			bool operator==(const basic_iterator& other) const { return index_ == other.index_; }
+			bool operator!=(const basic_iterator& other) const { return index_ != other.index_; }
+		};
+
+	public:
+		using iterator = basic_iterator<false>;
+		using const_iterator = basic_iterator<true>;
+
+		flat_map() = default;
+		flat_map(const flat_map& other) : hash_(other.hash_), eq_(other.eq_) {
+			reserve(other.size_);
+			for (const auto& [key, value] : other) {
+				try_emplace(key, value);
+			}
+		}
+		flat_map(flat_map&& other) noexcept { swap(other); }
+		~flat_map() { destroy(); }
+
+		flat_map& operator=(const flat_map& other) {
+			if (this != &other) {
+				flat_map copy{ other };
+				swap(copy);
+			}
+			return *this;
+		}
+		flat_map& operator=(flat_map&& other) noexcept {
+			if (this != &other) {
+				flat_map tmp{ std::move(other) };
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		void swap(flat_map& other) noexcept {
+			using std::swap;
+			swap(ctrl_, other.ctrl_);
+			swap(slots_, other.slots_);
+			swap(capacity_, other.capacity_);
+			swap(size_, other.size_);
+			swap(growth_left_, other.growth_left_);
+			swap(hash_, other.hash_);
+			swap(eq_, other.eq_);
+		}
+
+		[[nodiscard]] iterator begin() { return { this, 0 }; }
+		[[nodiscard]] iterator end() { return { this, capacity_ }; }
+		[[nodiscard]] const_iterator begin() const { return { this, 0 }; }
+		[[nodiscard]] const_iterator end() const { return { this, capacity_ }; }
+
+		[[nodiscard]] bool empty() const { return size_ == 0; }
+		[[nodiscard]] size_type size() const { return size_; }
+		[[nodiscard]] size_type capacity() const { return capacity_; }
+
+		// Makes room for count elements without rehashing
+		void reserve(size_type count) {
+			if (count <= size_ + growth_left_) return;
+
+			size_type cap = group_width;
+			while (cap - cap / 8 < count) cap <<= 1;
+			rehash(cap);
+		}
+
+		void clear() {
+			for (size_type i = 0; i < capacity_; ++i) {
+				if (ctrl_.get()[i] >= 0) slots_[i].~value_type();
+			}
+			if (capacity_ > 0) std::memset(ctrl_.get(), static_cast<unsigned char>(empty_ctrl), capacity_);
+			size_ = 0;
+			growth_left_ = capacity_ - capacity_ / 8;
+		}
+
+		template <typename Q>
+		[[nodiscard]] iterator find(const Q& key) {
+			const auto i = find_index(key, hash_(key));
+			return { this, i == npos ? capacity_ : i };
+		}
+		template <typename Q>
+		[[nodiscard]] const_iterator find(const Q& key) const {
+			const auto i = find_index(key, hash_(key));
+			return { this, i == npos ? capacity_ : i };
+		}
+		template <typename Q>
+		[[nodiscard]] size_type count(const Q& key) const { return find_index(key, hash_(key)) == npos ? 0 : 1; }
+
+		template <typename Q>
+		[[nodiscard]] V& at(const Q& key) {
+			const auto i = find_index(key, hash_(key));
+			if (i == npos) throw std::out_of_range("flat_map::at");
+			return slots_[i].second;
+		}
+		template <typename Q>
+		[[nodiscard]] const V& at(const Q& key) const {
+			const auto i = find_index(key, hash_(key));
+			if (i == npos) throw std::out_of_range("flat_map::at");
+			return slots_[i].second;
+		}
+
+		V& operator[](const K& key) { return try_emplace(key).first->second; }
+		V& operator[](K&& key) { return try_emplace(std::move(key)).first->second; }
+
+		template <typename... Args>
+		std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+			return emplace_key(key, std::forward<Args>(args)...);
+		}
+		template <typename... Args>
+		std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+			return emplace_key(std::move(key), std::forward<Args>(args)...);
+		}
+		std::pair<iterator, bool> insert(value_type value) {
+			return emplace_key(std::move(value.first), std::move(value.second));
+		}
+
+		template <typename Q>
+		size_type erase(const Q& key) {
+			const auto i = find_index(key, hash_(key));
+			if (i == npos) return 0;
+			erase_index(i);
+			return 1;
+		}
+		iterator erase(const_iterator pos) {
+			erase_index(pos.index_);
+			return { this, pos.index_ + 1 };
+		}
+
+	private:
+		static ctrl_t h2_of(size_type hash) { return static_cast<ctrl_t>(hash & 0x7F); }
+		static size_type h1_of(size_type hash) { return hash >> 7; }
+
+		// Triangular probing over groups visits every group once when the group count is a power of two
+		template <typename Q>
+		[[nodiscard]] size_type find_index(const Q& key, size_type hash) const {
+			if (capacity_ == 0) return npos;
+
+			const auto group_mask = capacity_ / group_width - 1;
+			const auto h2 = h2_of(hash);
+			auto g = h1_of(hash) & group_mask;
+			for (size_type step = 1;; ++step) {
+				const group grp{ ctrl_.get() + g * group_width };
+				for (auto mask = grp.match(h2); mask != 0; mask &= mask - 1) {
+					const auto i = g * group_width + lowest_bit(mask);
+					if (eq_(slots_[i].first, key)) return i;
+				}
+				if (grp.match_empty() != 0 || step > group_mask) return npos;
+				g = (g + step) & group_mask;
+			}
+		}
+
+		[[nodiscard]] size_type find_free(size_type hash) const {
+			const auto group_mask = capacity_ / group_width - 1;
+			auto g = h1_of(hash) & group_mask;
+			for (size_type step = 1;; ++step) {
+				if (const auto mask = group{ ctrl_.get() + g * group_width }.match_free(); mask != 0)
+					return g * group_width + lowest_bit(mask);
+				g = (g + step) & group_mask;
+			}
+		}
+
+		template <typename Key, typename... Args>
+		std::pair<iterator, bool> emplace_key(Key&& key, Args&&... args) {
+			const auto hash = hash_(key);
+			if (const auto i = find_index(key, hash); i != npos)
+				return { { this, i }, false };
+
+			if (growth_left_ == 0) {
+				rehash(capacity_ == 0 ? group_width : (size_ + 1 > capacity_ / 2 ? capacity_ * 2 : capacity_));
+			}
+
+			const auto i = find_free(hash);
+			::new (static_cast<void*>(slots_ + i)) value_type(std::piecewise_construct,
+				std::forward_as_tuple(std::forward<Key>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+			if (ctrl_.get()[i] == empty_ctrl) --growth_left_;
+			ctrl_.get()[i] = h2_of(hash);
+			++size_;
+			return { { this, i }, true };
+		}
+
+		void erase_index(size_type i) {
+			slots_[i].~value_type();
+			--size_;
+			// a probe stops at the first group with an empty byte, so when this group still has
+			// one nobody probes past it and the slot can become empty again
+			const auto g = i / group_width * group_width;
+			if (group{ ctrl_.get() + g }.match_empty() != 0) {
+				ctrl_.get()[i] = empty_ctrl;
+				++growth_left_;
+			}
+			else {
+				ctrl_.get()[i] = deleted_ctrl;
+			}
+		}
+
+		// new_capacity is a power of two and a multiple of the group width, large enough for size_
+		void rehash(size_type new_capacity) {
+			std::unique_ptr<ctrl_t, ctrl_deleter> ctrl{
+				static_cast<ctrl_t*>(::operator new(new_capacity, std::align_val_t{ group_width })) };
+			std::memset(ctrl.get(), static_cast<unsigned char>(empty_ctrl), new_capacity);
+			auto* slots = std::allocator<value_type>{}.allocate(new_capacity);
+
+			const auto group_mask = new_capacity / group_width - 1;
+			for (size_type i = 0; i < capacity_; ++i) {
+				if (ctrl_.get()[i] < 0) continue;
+
+				const auto hash = hash_(slots_[i].first);
+				auto g = h1_of(hash) & group_mask;
+				for (size_type step = 1;; ++step) {
+					if (const auto mask = group{ ctrl.get() + g * group_width }.match_empty(); mask != 0) {
+						const auto j = g * group_width + lowest_bit(mask);
+						::new (static_cast<void*>(slots + j)) value_type(std::move(slots_[i]));
+						ctrl.get()[j] = h2_of(hash);
+						break;
+					}
+					g = (g + step) & group_mask;
+				}
+				slots_[i].~value_type();
+			}
+
+			if (slots_) std::allocator<value_type>{}.deallocate(slots_, capacity_);
+			ctrl_ = std::move(ctrl);
+			slots_ = slots;
+			capacity_ = new_capacity;
+			growth_left_ = capacity_ - capacity_ / 8 - size_;
+		}
+
+		void destroy() {
+			if (!slots_) return;
+			for (size_type i = 0; i < capacity_; ++i) {
+				if (ctrl_.get()[i] >= 0) slots_[i].~value_type();
+			}
+			std::allocator<value_type>{}.deallocate(slots_, capacity_);
+			slots_ = nullptr;
+			ctrl_.reset();
+			capacity_ = size_ = growth_left_ = 0;
+		}
+	};
+
+} // docs_gen_core::util
+
+#endif // DOCS_GEN_FLAT_MAP_H
@@ -1,5 +1,6 @@
 #include "util.hpp"
 
+#include <algorithm>
 #include <locale>
 #include <vector>
 
@@ -14,7 +15,7 @@ namespace docs_gen_core::util {
 		return res;
 	}
 
-	std::wstring to_wstring(const std::string& s) {
+	std::wstring to_wstring(std::string_view s) {
 		std::vector<wchar_t> buf(s.size());
 		std::use_facet<std::ctype<wchar_t>>(std::locale()).widen(s.data(),
 		                                                         s.data() + s.size(),
@@ -22,6 +23,15 @@ namespace docs_gen_core::util {
 		return {buf.data(), buf.size()};
 	}
 
+	std::string to_string(std::wstring_view s) {
+		std::vector<char> buf(s.size());
+		std::use_facet<std::ctype<wchar_t>>(std::locale()).narrow(s.data(),
+		                                                         s.data() + s.size(),
+		                                                         '?',
+		                                                         buf.data());
+		return {buf.data(), buf.size()};
+	}
+
 	void split_by(const std::wstring& s, wchar_t delim, std::vector<std::wstring>& elems) {
 		elems.clear();
 		std::wstring temp{};
@@ -36,4 +46,82 @@ namespace docs_gen_core::util {
 		}
 		if (!temp.empty()) elems.push_back(temp);
 	}
-} // docs_gen_core::util
\ No newline at end of file
+
+	namespace {
+
+		constexpr std::uint32_t sha256_k[64] = {
+			0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+			0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+			0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+			0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+			0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+			0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+			0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+			0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+		};
+
+		constexpr std::uint32_t rotr(std::uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+		void sha256_block(std::uint32_t (&h)[8], const std::uint8_t* block) {
+			std::uint32_t w[64];
+			for (int i = 0; i < 16; ++i) {
+				w[i] = static_cast<std::uint32_t>(block[i * 4]) << 24 | static_cast<std::uint32_t>(block[i * 4 + 1]) << 16
+					| static_cast<std::uint32_t>(block[i * 4 + 2]) << 8 | block[i * 4 + 3];
+			}
+			for (int i = 16; i < 64; ++i) {
+				const auto s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+				const auto s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+				w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+			}
+
+			auto a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], k = h[7];
+			for (int i = 0; i < 64; ++i) {
+				const auto t1 = k + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+				const auto t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+				k = g;
+				g = f;
+				f = e;
+				e = d + t1;
+				d = c;
+				c = b;
+				b = a;
+				a = t1 + t2;
+			}
+			h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+			h[4] += e; h[5] += f; h[6] += g; h[7] += k;
+		}
+
+	} // anonymous
+
+	std::array<std::uint8_t, 32> sha256(std::string_view data) {
+		std::uint32_t h[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+		const auto* bytes = reinterpret_cast<const std::uint8_t*>(data.data());
+		std::size_t left = data.size();
+		for (; left >= 64; left -= 64, bytes += 64) {
+			sha256_block(h, bytes);
+		}
+
+		// the rest, a 1 bit, zeros and the length in bits fill one or two more blocks
+		std::uint8_t tail[128] = {};
+		std::copy(bytes, bytes + left, tail);
+		tail[left] = 0x80;
+		const std::size_t tail_size = left < 56 ? 64 : 128;
+		const auto bits = static_cast<std::uint64_t>(data.size()) * 8;
+		for (int i = 0; i < 8; ++i) {
+			tail[tail_size - 1 - i] = static_cast<std::uint8_t>(bits >> (i * 8));
+		}
+		sha256_block(h, tail);
+		if (tail_size == 128) {
+			sha256_block(h, tail + 64);
+		}
+
+		std::array<std::uint8_t, 32> digest{};
+		for (int i = 0; i < 8; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				digest[i * 4 + j] = static_cast<std::uint8_t>(h[i] >> (24 - j * 8));
+			}
+		}
+		return digest;
+	}
+
+} // docs_gen_core::util
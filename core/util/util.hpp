@@ -1,14 +1,21 @@
 #ifndef DOCS_GEN_UTIL_H
 #define DOCS_GEN_UTIL_H
 
+#include <array>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace docs_gen_core::util {
 
 	char* next_arg(int* argc, char*** argv);
-	std::wstring to_wstring(const std::string& s);
+	std::wstring to_wstring(std::string_view s);
+	// Inverse of to_wstring, characters the locale cannot narrow become '?'
+	std::string to_string(std::wstring_view s);
 	void split_by(const std::wstring& s, wchar_t delim, std::vector<std::wstring>& elems);
+	// SHA-256 digest of data
+	std::array<std::uint8_t, 32> sha256(std::string_view data);
 
 } // docs_gen_core::util
 
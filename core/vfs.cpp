@@ -0,0 +1,686 @@
+#include "vfs.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+#ifdef WIN
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "dir.hpp"
+#include "util/util.hpp"
+
+namespace docs_gen_core {
+
+	namespace {
+
+		std::uint16_t read_u16(std::string_view s, std::size_t pos) {
+			const auto* b = reinterpret_cast<const unsigned char*>(s.data() + pos);
+			return static_cast<std::uint16_t>(b[0] | b[1] << 8);
+		}
+
+		std::uint32_t read_u32(std::string_view s, std::size_t pos) {
+			const auto* b = reinterpret_cast<const unsigned char*>(s.data() + pos);
+			return std::uint32_t(b[0]) | std::uint32_t(b[1]) << 8 | std::uint32_t(b[2]) << 16 | std::uint32_t(b[3]) << 24;
+		}
+
+		std::uint64_t read_u64(std::string_view s, std::size_t pos) {
+			return std::uint64_t(read_u32(s, pos)) | std::uint64_t(read_u32(s, pos + 4)) << 32;
+		}
+
+		bool is_ignored_path(const std::wstring& rel_path, const std::vector<std::wstring>& ignored) {
+			std::size_t start = 0;
+			while (start < rel_path.size()) {
+				auto end = rel_path.find('/', start);
+				if (end == std::wstring::npos) break; // last component is the file itself
+				if (util::is_dir_blacklisted(rel_path.substr(start, end - start), ignored)) {
+					return true;
+				}
+				start = end + 1;
+			}
+			return false;
+		}
+
+	} // anonymous
+
+	mapped_file::mapped_file(const std::filesystem::path& path)
+		: data_(nullptr), size_(0), open_(false)
+#ifdef WIN
+		, file_(INVALID_HANDLE_VALUE), mapping_(nullptr) {
+		file_ = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		LARGE_INTEGER size;
+		if (file_ == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_, &size)) {
+			return;
+		}
+
+		size_ = static_cast<std::size_t>(size.QuadPart);
+		if (size_ == 0) {
+			open_ = true;
+			return;
+		}
+
+		mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping_) {
+			data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+			open_ = data_ != nullptr;
+		}
+	}
+#else
+		, fd_(-1) {
+		fd_ = ::open(path.c_str(), O_RDONLY);
+		struct stat st{};
+		if (fd_ < 0 || ::fstat(fd_, &st) != 0) {
+			return;
+		}
+
+		size_ = static_cast<std::size_t>(st.st_size);
+		if (size_ == 0) {
+			open_ = true;
+			return;
+		}
+
+		void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+		if (p != MAP_FAILED) {
+			data_ = static_cast<const char*>(p);
+			open_ = true;
+		}
+	}
+#endif
+
+	mapped_file::~mapped_file() {
+#ifdef WIN
+		if (data_) UnmapViewOfFile(data_);
+		if (mapping_) CloseHandle(mapping_);
+		if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+		if (data_) ::munmap(const_cast<char*>(data_), size_);
+		if (fd_ >= 0) ::close(fd_);
+#endif
+	}
+
+	file_data::file_data(std::shared_ptr<const void> owner, std::string_view view)
+		: owner_(std::move(owner)), view_(view) {
+	}
+
+	file_data file_data::load(const std::filesystem::path& path) {
+		std::ifstream in{ path, std::ios::in | std::ios::binary };
+		if (!in.is_open()) {
+#ifndef RELEASE
+			std::cerr << "[ERROR] could not open file: " << path << '\n';
+#endif
+			return {};
+		}
+
+		std::string buffer;
+		in.seekg(0, std::ios::end);
+		buffer.resize(static_cast<std::size_t>(in.tellg()));
+		in.seekg(0, std::ios::beg);
+		in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		return own(std::move(buffer));
+	}
+
+	file_data file_data::own(std::string&& buffer) {
+		auto owner = std::make_shared<std::string>(std::move(buffer));
+		const std::string_view view{ *owner };
+		return { std::move(owner), view };
+	}
+
+	dir_source::dir_source(const std::filesystem::path& root)
+		: file_source(root) {
+	}
+
+	void dir_source::list(const std::vector<std::wstring>& ignored, std::vector<entry>& entries) const {
+		for (auto dir_entry = std::filesystem::recursive_directory_iterator(root_); dir_entry != std::filesystem::recursive_directory_iterator(); ++dir_entry) {
+			if (util::is_dir(*dir_entry) && util::is_dir_blacklisted(dir_entry->path().filename().wstring(), ignored)) {
+				dir_entry.disable_recursion_pending();
+				continue;
+			}
+
+			if (util::is_file(*dir_entry)) {
+				entries.push_back({ dir_entry->path(), dir_entry->file_size(), dir_entry->last_write_time() });
+			}
+		}
+	}
+
+	bool dir_source::read(const std::filesystem::path& path, file_data& data) const {
+		data = file_data::load(path);
+		return !data.empty() || util::is_file(path);
+	}
+
+	archive_source::archive_source(const std::filesystem::path& root)
+		: file_source(root), mapping_(std::make_shared<mapped_file>(root)) {
+		if (!mapping_->is_open()) {
+#ifndef RELEASE
+			std::cerr << "[ERROR] could not map archive: " << root << '\n';
+#endif
+			mapping_.reset();
+		}
+	}
+
+	void archive_source::push_entry(std::wstring rel_path, const archive_entry& e) {
+		// names become paths below the docs folder, they must not point anywhere else
+		const auto path = std::filesystem::path{ rel_path }.lexically_normal();
+		bool escapes = path.empty() || path.is_absolute() || path.has_root_name() || path.has_root_directory();
+		for (auto it = path.begin(); !escapes && it != path.end(); ++it) {
+			escapes = *it == "..";
+		}
+		if (escapes) {
+#ifndef RELEASE
+			std::cerr << "[WARNING] skipping archive entry outside the project: " << util::to_string(rel_path) << '\n';
+#endif
+			return;
+		}
+
+		rel_path = key_of(path);
+		if (entries_.find(rel_path) == entries_.end()) {
+			order_.push_back(rel_path);
+		}
+		entries_[std::move(rel_path)] = e;
+	}
+
+	std::wstring archive_source::key_of(const std::filesystem::path& rel_path) {
+		return rel_path.generic_wstring();
+	}
+
+	void archive_source::list(const std::vector<std::wstring>& ignored, std::vector<entry>& entries) const {
+		std::error_code ec;
+		const auto time = std::filesystem::last_write_time(root_, ec);
+		for (const auto& key : order_) {
+			if (is_ignored_path(key, ignored)) continue;
+			entries.push_back({ root_ / std::filesystem::path{ key }, entries_.at(key).size, time });
+		}
+	}
+
+	bool archive_source::read(const std::filesystem::path& path, file_data& data) const {
+		const auto it = entries_.find(key_of(path.lexically_relative(root_)));
+		if (it == entries_.end() || !mapping_) {
+			return false;
+		}
+
+		const auto& e = it->second;
+		const auto archive = mapping_->view();
+		if (e.offset > archive.size() || e.stored_size > archive.size() - e.offset) {
+			return false;
+		}
+
+		const auto raw = archive.substr(static_cast<std::size_t>(e.offset), static_cast<std::size_t>(e.stored_size));
+		if (e.method == 0) {
+			data = file_data{ mapping_, raw };
+			return true;
+		}
+
+		if (e.method == 8) {
+			// the declared size is only trusted as a limit: deflate cannot expand more than about
+			// 1032:1, anything larger is forged, and the reserve is capped as well
+			constexpr std::uint64_t max_ratio = 1032;
+			constexpr std::uint64_t max_reserve = 16 << 20;
+			if (e.size > std::numeric_limits<std::size_t>::max() || e.size > e.stored_size * max_ratio + 64) {
+#ifndef RELEASE
+				std::cerr << "[ERROR] corrupted archive entry: " << path << '\n';
+#endif
+				return false;
+			}
+			std::string out;
+			out.reserve(static_cast<std::size_t>(std::min(e.size, max_reserve)));
+			if (!util::inflate(raw, out, static_cast<std::size_t>(e.size)) || out.size() != e.size) {
+#ifndef RELEASE
+				std::cerr << "[ERROR] corrupted archive entry: " << path << '\n';
+#endif
+				return false;
+			}
+			data = file_data::own(std::move(out));
+			return true;
+		}
+
+#ifndef RELEASE
+		std::cerr << "[WARNING] unsupported compression method " << e.method << ": " << path << '\n';
+#endif
+		return false;
+	}
+
+	pck_source::pck_source(const std::filesystem::path& root)
+		: archive_source(root) {
+		if (mapping_ && !read_directory()) {
+#ifndef RELEASE
+			std::cerr << "[ERROR] corrupted pck archive: " << root << '\n';
+#endif
+			mapping_.reset();
+		}
+	}
+
+	bool pck_source::read_directory() {
+		constexpr std::uint32_t pack_dir_encrypted = 1;
+		constexpr std::uint32_t pack_file_encrypted = 1;
+		constexpr std::uint32_t pack_file_removal = 2;
+
+		const auto s = mapping_->view();
+		if (s.size() < 8 || s.compare(0, 4, "GDPC") != 0) {
+			return false;
+		}
+
+		const auto version = read_u32(s, 4);
+		std::size_t pos = 20;
+		std::uint64_t file_base = 0;
+		if (version >= 2) {
+			if (pos + 12 > s.size()) return false;
+			const auto flags = read_u32(s, pos);
+			file_base = read_u64(s, pos + 4);
+			pos += 12;
+			if (flags & pack_dir_encrypted) {
+#ifndef RELEASE
+				std::cerr << "[WARNING] encrypted pck archives are not supported: " << root_ << '\n';
+#endif
+				return false;
+			}
+			if (version >= 3) {
+				if (pos + 8 > s.size()) return false;
+				pos = static_cast<std::size_t>(read_u64(s, pos));
+			}
+			else {
+				pos += 16 * 4;
+			}
+		}
+		else {
+			pos += 16 * 4;
+		}
+
+		if (pos + 4 > s.size()) return false;
+		const auto count = read_u32(s, pos);
+		pos += 4;
+		for (std::uint32_t i = 0; i < count; ++i) {
+			if (pos + 4 > s.size()) return false;
+			const auto len = read_u32(s, pos);
+			pos += 4;
+			if (pos + len + 32 > s.size()) return false;
+
+			auto name = s.substr(pos, len);
+			while (!name.empty() && name.back() == '\0') name.remove_suffix(1);
+			if (name.compare(0, 6, "res://") == 0) name.remove_prefix(6);
+			pos += len;
+
+			archive_entry e{};
+			e.offset = read_u64(s, pos) + file_base;
+			e.size = e.stored_size = read_u64(s, pos + 8);
+			e.method = 0;
+			pos += 16 + 16; // offset, size, md5
+
+			std::uint32_t file_flags = 0;
+			if (version >= 2) {
+				if (pos + 4 > s.size()) return false;
+				file_flags = read_u32(s, pos);
+				pos += 4;
+			}
+			if (file_flags & (pack_file_encrypted | pack_file_removal)) {
+				continue;
+			}
+
+			push_entry(util::to_wstring(name), e);
+		}
+
+		resolve_remaps();
+		return true;
+	}
+
+	void pck_source::resolve_remaps() {
+		const std::wstring remap = L".remap";
+		const auto keys = order_;
+		for (const auto& key : keys) {
+			if (key.size() <= remap.size() || key.compare(key.size() - remap.size(), remap.size(), remap) != 0) {
+				continue;
+			}
+
+			file_data data;
+			if (!read(root_ / std::filesystem::path{ key }, data)) continue;
+
+			const auto text = data.view();
+			const auto at = text.find("path=\"");
+			if (at == std::string_view::npos) continue;
+			auto target = text.substr(at + 6);
+			target = target.substr(0, target.find('"'));
+			if (target.compare(0, 6, "res://") == 0) target.remove_prefix(6);
+
+			const auto it = entries_.find(util::to_wstring(target));
+			if (it == entries_.end()) continue;
+
+			// scenes/main.tscn.remap -> scenes/main.scn, keeping the exported file's format
+			std::filesystem::path original{ key.substr(0, key.size() - remap.size()) };
+			original.replace_extension(std::filesystem::path{ util::to_wstring(target) }.extension());
+			push_entry(key_of(original), it->second);
+		}
+
+		// exported copies are reachable through their remapped names
+		std::vector<std::wstring> visible;
+		for (auto& key : order_) {
+			if (key.compare(0, 7, L".godot/") == 0) continue;
+			if (key.size() > remap.size() && key.compare(key.size() - remap.size(), remap.size(), remap) == 0) continue;
+			visible.push_back(std::move(key));
+		}
+		order_ = std::move(visible);
+	}
+
+	zip_source::zip_source(const std::filesystem::path& root)
+		: archive_source(root) {
+		if (mapping_ && !read_directory()) {
+#ifndef RELEASE
+			std::cerr << "[ERROR] corrupted zip archive: " << root << '\n';
+#endif
+			mapping_.reset();
+		}
+	}
+
+	bool zip_source::read_directory() {
+		const auto s = mapping_->view();
+		if (s.size() < 22) return false;
+
+		// end of central directory record, possibly followed by a comment
+		std::size_t eocd = std::string_view::npos;
+		const std::size_t lowest = s.size() > 22 + 0xFFFF ? s.size() - 22 - 0xFFFF : 0;
+		for (std::size_t i = s.size() - 22 + 1; i-- > lowest;) {
+			if (read_u32(s, i) == 0x06054b50) {
+				eocd = i;
+				break;
+			}
+		}
+		if (eocd == std::string_view::npos) return false;
+
+		std::uint64_t count = read_u16(s, eocd + 10);
+		std::uint64_t cd_offset = read_u32(s, eocd + 16);
+		if ((count == 0xFFFF || cd_offset == 0xFFFFFFFF) && eocd >= 20 && read_u32(s, eocd - 20) == 0x07064b50) {
+			const auto zip64 = static_cast<std::size_t>(read_u64(s, eocd - 20 + 8));
+			if (zip64 + 56 > s.size() || read_u32(s, zip64) != 0x06064b50) return false;
+			count = read_u64(s, zip64 + 32);
+			cd_offset = read_u64(s, zip64 + 48);
+		}
+
+		struct raw_entry {
+			std::string_view name;
+			archive_entry e;
+		};
+		std::vector<raw_entry> raw;
+		std::string_view project_dir;
+		bool has_project = false;
+
+		auto pos = static_cast<std::size_t>(cd_offset);
+		for (std::uint64_t i = 0; i < count; ++i) {
+			if (pos + 46 > s.size() || read_u32(s, pos) != 0x02014b50) return false;
+
+			archive_entry e{};
+			e.method = read_u16(s, pos + 10);
+			e.stored_size = read_u32(s, pos + 20);
+			e.size = read_u32(s, pos + 24);
+			const auto name_len = read_u16(s, pos + 28);
+			const auto extra_len = read_u16(s, pos + 30);
+			const auto comment_len = read_u16(s, pos + 32);
+			std::uint64_t local = read_u32(s, pos + 42);
+			if (pos + 46 + name_len + extra_len > s.size()) return false;
+			const auto name = s.substr(pos + 46, name_len);
+
+			// zip64 extended information replaces the saturated 32 bit fields in order
+			auto extra = s.substr(pos + 46 + name_len, extra_len);
+			while (extra.size() >= 4) {
+				const auto id = read_u16(extra, 0);
+				const auto size = read_u16(extra, 2);
+				if (4u + size > extra.size()) break;
+				if (id == 0x0001) {
+					std::size_t at = 4;
+					if (e.size == 0xFFFFFFFF && at + 8 <= 4u + size) { e.size = read_u64(extra, at); at += 8; }
+					if (e.stored_size == 0xFFFFFFFF && at + 8 <= 4u + size) { e.stored_size = read_u64(extra, at); at += 8; }
+					if (local == 0xFFFFFFFF && at + 8 <= 4u + size) { local = read_u64(extra, at); }
+				}
+				extra.remove_prefix(4u + size);
+			}
+			pos += 46 + name_len + extra_len + comment_len;
+
+			if (name.empty() || name.back() == '/') continue;
+
+			const auto lpos = static_cast<std::size_t>(local);
+			if (lpos + 30 > s.size() || read_u32(s, lpos) != 0x04034b50) return false;
+			e.offset = local + 30 + read_u16(s, lpos + 26) + read_u16(s, lpos + 28);
+
+			const auto slash = name.rfind('/');
+			const auto file_name = slash == std::string_view::npos ? name : name.substr(slash + 1);
+			if (file_name == "project.godot") {
+				const auto dir = slash == std::string_view::npos ? std::string_view{} : name.substr(0, slash + 1);
+				if (!has_project || dir.size() < project_dir.size()) {
+					project_dir = dir;
+					has_project = true;
+				}
+			}
+			raw.push_back({ name, e });
+		}
+
+		for (const auto& [name, e] : raw) {
+			if (name.compare(0, project_dir.size(), project_dir) != 0) continue;
+			push_entry(util::to_wstring(name.substr(project_dir.size())), e);
+		}
+		return true;
+	}
+
+	std::shared_ptr<file_source> open_file_source(const std::filesystem::path& path) {
+		if (util::is_dir(path)) {
+			return std::make_shared<dir_source>(path);
+		}
+
+		std::shared_ptr<archive_source> archive;
+		if (path.extension() == ".pck") {
+			archive = std::make_shared<pck_source>(path);
+		}
+		else if (path.extension() == ".zip") {
+			archive = std::make_shared<zip_source>(path);
+		}
+
+		if (!archive || !archive->is_open()) {
+			return nullptr;
+		}
+		return archive;
+	}
+
+	namespace util {
+
+		namespace {
+
+			struct bit_reader {
+				std::string_view in;
+				std::size_t pos = 0;
+				std::uint32_t bit_buf = 0;
+				int bit_count = 0;
+				bool error = false;
+
+				int bits(int need) {
+					std::uint32_t val = bit_buf;
+					while (bit_count < need) {
+						if (pos >= in.size()) {
+							error = true;
+							return 0;
+						}
+						val |= std::uint32_t(static_cast<unsigned char>(in[pos++])) << bit_count;
+						bit_count += 8;
+					}
+					bit_buf = val >> need;
+					bit_count -= need;
+					return static_cast<int>(val & ((1u << need) - 1));
+				}
+			};
+
+			struct huffman {
+				short count[16];
+				short symbol[288];
+			};
+
+			// canonical huffman tables as in zlib's puff.c
+			int construct(huffman& h, const short* lengths, int n) {
+				std::memset(h.count, 0, sizeof(h.count));
+				for (int s = 0; s < n; ++s) h.count[lengths[s]]++;
+				if (h.count[0] == n) return 0;
+
+				int left = 1;
+				for (int len = 1; len < 16; ++len) {
+					left <<= 1;
+					left -= h.count[len];
+					if (left < 0) return left;
+				}
+
+				short offs[16];
+				offs[1] = 0;
+				for (int len = 1; len < 15; ++len) offs[len + 1] = static_cast<short>(offs[len] + h.count[len]);
+				for (int s = 0; s < n; ++s) {
+					if (lengths[s] != 0) h.symbol[offs[lengths[s]]++] = static_cast<short>(s);
+				}
+				return left;
+			}
+
+			int decode(bit_reader& br, const huffman& h) {
+				int code = 0, first = 0, index = 0;
+				for (int len = 1; len < 16; ++len) {
+					code |= br.bits(1);
+					if (br.error) return -1;
+					const int count = h.count[len];
+					if (code - count < first) return h.symbol[index + (code - first)];
+					index += count;
+					first += count;
+					first <<= 1;
+					code <<= 1;
+				}
+				return -1;
+			}
+
+			bool codes(bit_reader& br, std::string& out, std::size_t limit, const huffman& lencode, const huffman& distcode) {
+				static constexpr short lbase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+				static constexpr short lext[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+				static constexpr short dbase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+				static constexpr short dext[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+				while (true) {
+					int symbol = decode(br, lencode);
+					if (symbol < 0) return false;
+					if (symbol < 256) {
+						if (out.size() >= limit) return false;
+						out.push_back(static_cast<char>(symbol));
+						continue;
+					}
+					if (symbol == 256) return true;
+
+					symbol -= 257;
+					if (symbol >= 29) return false;
+					const int len = lbase[symbol] + br.bits(lext[symbol]);
+
+					symbol = decode(br, distcode);
+					if (symbol < 0 || symbol >= 30) return false;
+					const std::size_t dist = static_cast<std::size_t>(dbase[symbol] + br.bits(dext[symbol]));
+					if (br.error || dist > out.size() || static_cast<std::size_t>(len) > limit - out.size()) return false;
+
+					const auto from = out.size() - dist;
+					for (int i = 0; i < len; ++i) {
+						out.push_back(out[from + i]);
+					}
+				}
+			}
+
+		} // anonymous
+
+		bool inflate(std::string_view in, std::string& out, std::size_t limit) {
+			bit_reader br{ in };
+			int last;
+			do {
+				last = br.bits(1);
+				const int type = br.bits(2);
+				if (br.error) return false;
+
+				if (type == 0) {
+					br.bit_buf = 0;
+					br.bit_count = 0;
+					if (br.pos + 4 > in.size()) return false;
+					const auto len = read_u16(in, br.pos);
+					if (static_cast<std::uint16_t>(~len) != read_u16(in, br.pos + 2)) return false;
+					br.pos += 4;
+					if (br.pos + len > in.size() || len > limit - out.size()) return false;
+					out.append(in.data() + br.pos, len);
+					br.pos += len;
+				}
+				else if (type == 1) {
+					static huffman lencode, distcode;
+					static const bool built = [] {
+						short lengths[288];
+						int s = 0;
+						for (; s < 144; ++s) lengths[s] = 8;
+						for (; s < 256; ++s) lengths[s] = 9;
+						for (; s < 280; ++s) lengths[s] = 7;
+						for (; s < 288; ++s) lengths[s] = 8;
+						construct(lencode, lengths, 288);
+						for (s = 0; s < 30; ++s) lengths[s] = 5;
+						construct(distcode, lengths, 30);
+						return true;
+					}();
+					(void)built;
+					if (!codes(br, out, limit, lencode, distcode)) return false;
+				}
+				else if (type == 2) {
+					static constexpr short order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+					short lengths[320];
+					const int nlen = br.bits(5) + 257;
+					const int ndist = br.bits(5) + 1;
+					const int ncode = br.bits(4) + 4;
+					if (br.error || nlen > 286 || ndist > 30) return false;
+
+					int index = 0;
+					for (; index < ncode; ++index) lengths[order[index]] = static_cast<short>(br.bits(3));
+					for (; index < 19; ++index) lengths[order[index]] = 0;
+
+					huffman lencode{}, distcode{};
+					if (construct(lencode, lengths, 19) != 0) return false;
+
+					index = 0;
+					while (index < nlen + ndist) {
+						int symbol = decode(br, lencode);
+						if (symbol < 0) return false;
+						if (symbol < 16) {
+							lengths[index++] = static_cast<short>(symbol);
+							continue;
+						}
+
+						short len = 0;
+						if (symbol == 16) {
+							if (index == 0) return false;
+							len = lengths[index - 1];
+							symbol = 3 + br.bits(2);
+						}
+						else if (symbol == 17) {
+							symbol = 3 + br.bits(3);
+						}
+						else {
+							symbol = 11 + br.bits(7);
+						}
+						if (br.error || index + symbol > nlen + ndist) return false;
+						while (symbol--) lengths[index++] = len;
+					}
+
+					if (lengths[256] == 0) return false;
+					const int lerr = construct(lencode, lengths, nlen);
+					if (lerr < 0 || (lerr > 0 && nlen - lencode.count[0] != 1)) return false;
+					const int derr = construct(distcode, lengths + nlen, ndist);
+					if (derr < 0 || (derr > 0 && ndist - distcode.count[0] != 1)) return false;
+
+					if (!codes(br, out, limit, lencode, distcode)) return false;
+				}
+				else {
+					return false;
+				}
+			} while (!last);
+
+			return true;
+		}
+
+	} // util
+
+} // docs_gen_core
@@ -0,0 +1,158 @@
+#ifndef DOCS_GEN_VFS_H
+#define DOCS_GEN_VFS_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "util/flat_map.hpp"
+
+namespace docs_gen_core {
+
+	// Read-only memory mapping of a whole file
+	class mapped_file {
+		const char* data_;
+		std::size_t size_;
+		bool open_;
+#ifdef WIN
+		void* file_;
+		void* mapping_;
+#else
+		int fd_;
+#endif
+
+	public:
+		explicit mapped_file(const std::filesystem::path& path);
+		mapped_file(const mapped_file& other) = delete;
+		mapped_file(mapped_file&& other) = delete;
+		~mapped_file();
+
+		mapped_file& operator=(const mapped_file& other) = delete;
+		mapped_file& operator=(mapped_file&& other) = delete;
+
+		[[nodiscard]] bool is_open() const { return open_; }
+		[[nodiscard]] std::string_view view() const { return { data_, size_ }; }
+	};
+
+	// Contents of one file. The view either points into a mapping shared with the
+	// archive it came from or into a buffer owned by this object
+	class file_data {
+		std::shared_ptr<const void> owner_;
+		std::string_view view_;
+
+	public:
+		file_data() = default;
+		file_data(std::shared_ptr<const void> owner, std::string_view view);
+
+		[[nodiscard]] static file_data load(const std::filesystem::path& path);
+		[[nodiscard]] static file_data own(std::string&& buffer);
+
+		[[nodiscard]] std::string_view view() const { return view_; }
+		[[nodiscard]] bool empty() const { return view_.empty(); }
+	};
+
+	// Where the project files come from: a directory on disk or a packed archive.
+	// Entry paths are always root() / <project relative path>
+	class file_source {
+	public:
+		struct entry {
+			std::filesystem::path path;
+			std::uint64_t size;
+			// last change on disk, archive entries carry the archive's own time
+			std::filesystem::file_time_type time;
+		};
+
+	protected:
+		std::filesystem::path root_;
+
+		explicit file_source(const std::filesystem::path& root) : root_(root) {}
+
+	public:
+		file_source(const file_source& other) = delete;
+		file_source(file_source&& other) = delete;
+		virtual ~file_source() = default;
+
+		file_source& operator=(const file_source& other) = delete;
+		file_source& operator=(file_source&& other) = delete;
+
+		[[nodiscard]] const std::filesystem::path& root() const { return root_; }
+		[[nodiscard]] virtual bool is_archive() const = 0;
+
+		virtual void list(const std::vector<std::wstring>& ignored, std::vector<entry>& entries) const = 0;
+		virtual bool read(const std::filesystem::path& path, file_data& data) const = 0;
+	};
+
+	class dir_source final : public file_source {
+	public:
+		explicit dir_source(const std::filesystem::path& root);
+
+		[[nodiscard]] bool is_archive() const override { return false; }
+
+		void list(const std::vector<std::wstring>& ignored, std::vector<entry>& entries) const override;
+		bool read(const std::filesystem::path& path, file_data& data) const override;
+	};
+
+	// Base for archives that are mapped once and hand out views into the mapping
+	class archive_source : public file_source {
+	protected:
+		struct archive_entry {
+			std::uint64_t offset;
+			std::uint64_t size;
+			std::uint64_t stored_size;
+			std::uint16_t method;
+		};
+
+		std::shared_ptr<mapped_file> mapping_;
+		util::flat_map<std::wstring, archive_entry> entries_;
+		std::vector<std::wstring> order_;
+
+		explicit archive_source(const std::filesystem::path& root);
+
+		// Names that are absolute or lead out of the archive with ".." are skipped with a warning
+		void push_entry(std::wstring rel_path, const archive_entry& e);
+		[[nodiscard]] static std::wstring key_of(const std::filesystem::path& rel_path);
+
+	public:
+		[[nodiscard]] bool is_archive() const override { return true; }
+		[[nodiscard]] bool is_open() const { return mapping_ != nullptr; }
+
+		void list(const std::vector<std::wstring>& ignored, std::vector<entry>& entries) const override;
+		bool read(const std::filesystem::path& path, file_data& data) const override;
+	};
+
+	// Godot .pck packs (format versions 1 to 3). "*.remap" entries are resolved so exported
+	// scenes show up under their original names
+	class pck_source final : public archive_source {
+	public:
+		explicit pck_source(const std::filesystem::path& root);
+
+	private:
+		bool read_directory();
+		void resolve_remaps();
+	};
+
+	// Zip archives, stored entries are served zero-copy, deflated ones are inflated on read.
+	// If the project lives in a subfolder (e.g. "repo-main/project.godot") that folder becomes the root
+	class zip_source final : public archive_source {
+	public:
+		explicit zip_source(const std::filesystem::path& root);
+
+	private:
+		bool read_directory();
+	};
+
+	[[nodiscard]] std::shared_ptr<file_source> open_file_source(const std::filesystem::path& path);
+
+	namespace util {
+
+		// Fails once out would grow past limit bytes
+		bool inflate(std::string_view in, std::string& out, std::size_t limit);
+
+	} // util
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_VFS_H
@@ -0,0 +1,7 @@
+#include "test.hpp"
+
+int main() {
+    docs_gen_test::test_lexer_sections();
+    docs_gen_test::test_lexer_multiline_values();
+    return 0;
+}
@@ -0,0 +1,34 @@
+project "LexerTest"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++17"
+    staticruntime "off"
+
+    files {
+        "**.hpp",
+        "**.cpp",
+    }
+
+    targetdir ("%{wks.location}/build/bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("%{wks.location}/build/obj/" .. outputdir .. "/%{prj.name}")
+
+    links { "Core" }
+
+    includedirs { "../../core" }
+
+    filter { "system:windows" }
+        defines { "WIN" }
+    filter {}
+
+    filter { "system:linux" }
+        links { "pthread" }
+    filter {}
+
+    filter { "configurations:Debug" }
+        defines { "DEBUG" }
+        symbols "On"
+    filter {}
+
+    filter { "configurations:Release" }
+        optimize "On"
+    filter {}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "test.hpp"
+
+#include <iostream>
+
+#include "../core/lexer.hpp"
+
+namespace docs_gen_test {
+
+    namespace {
+
+        constexpr std::string_view scene =
+            "[gd_scene load_steps=2 format=3 uid=\"uid://cmain000001\"]\n"
+            "\n"
+            "[ext_resource type=\"Script\" path=\"res://player.gd\" id=\"1_pl\"]\n"
+            "\n"
+            "[node name=\"Main\" type=\"Node2D\"]\n"
+            "script = ExtResource(\"1_pl\")\n"
+            "description = \"multi\n"
+            "line [with] brackets = and \\\"quotes\\\"\"\n"
+            "metadata/info = {\n"
+            "\"k\": \"v [x]\",\n"
+            "\"list\": [1,\n"
+            "2]\n"
+            "}\n"
+            "\n"
+            "[node name=\"Child\" parent=\".\" instance=ExtResource( \"2_en\" )]\n"
+            "position = Vector2(5, 5)\n";
+
+    } // anonymous
+    
+    void test_lexer_sections() {
+        docs_gen_core::dott_lexer lexer{ scene };
+        std::string_view heading;
+        while (lexer.next_section(heading)) {
+            std::cout << '[' << heading << "]\n";
+            docs_gen_core::dott_lexer::property attr;
+            while (docs_gen_core::dott_lexer::next_attribute(heading, attr)) {
+                std::cout << '\t' << attr.key << " -> " << attr.value << '\n';
+            }
+        }
+    }
+
+    void test_lexer_multiline_values() {
+        docs_gen_core::dott_lexer lexer{ scene };
+        std::string_view heading;
+        while (lexer.next_section(heading)) {
+            docs_gen_core::dott_lexer::property p;
+            while (lexer.next_property(p)) {
+                std::string_view id;
+                if (docs_gen_core::dott_lexer::call_argument(p.value, "ExtResource", id)) {
+                    std::cout << p.key << " => ExtResource " << id << '\n';
+                    continue;
+                }
+                std::cout << p.key << " => <" << p.value << ">\n";
+            }
+        }
+    }
+    
+} // docs_gen_test
@@ -0,0 +1,11 @@
+#ifndef DOCS_GEN_TEST_LEXER_H
+#define DOCS_GEN_TEST_LEXER_H
+
+namespace docs_gen_test {
+
+    void test_lexer_sections();
+    void test_lexer_multiline_values();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_LEXER_H
@@ -0,0 +1,36 @@
+#include "test.hpp"
+
+#include <cstdlib>
+#include <new>
+
+// The replacements live apart from the tests so the compiler does not inline them into
+// standard containers and pair a free with what it still takes for the builtin operator new
+
+std::atomic<std::size_t> docs_gen_test::allocations{ 0 };
+
+void* operator new(std::size_t size) {
+    ++docs_gen_test::allocations;
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    ::operator delete(p);
+}
+
+void operator delete[](void* p) noexcept {
+    ::operator delete(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    ::operator delete(p);
+}
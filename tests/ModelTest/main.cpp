@@ -0,0 +1,31 @@
+#include "test.hpp"
+
+int main() {
+    bool ok = docs_gen_test::test_move_keeps_members();
+    ok &= docs_gen_test::test_move_does_not_allocate();
+    ok &= docs_gen_test::test_sub_resource_is_not_copied();
+    ok &= docs_gen_test::test_project_growth();
+    ok &= docs_gen_test::test_flat_map_matches_unordered_map();
+    ok &= docs_gen_test::test_flat_map_allocations();
+    ok &= docs_gen_test::test_instance_expansion();
+    ok &= docs_gen_test::test_instanced_root();
+    ok &= docs_gen_test::test_dependency_graph();
+    ok &= docs_gen_test::test_reachability();
+    ok &= docs_gen_test::test_project_view();
+    ok &= docs_gen_test::test_shared_pool();
+    ok &= docs_gen_test::test_parse_cache_on_disk();
+    ok &= docs_gen_test::test_doc_output_skips_unchanged();
+    ok &= docs_gen_test::test_bundle_round_trip();
+    ok &= docs_gen_test::test_tar_streaming();
+    ok &= docs_gen_test::test_create_folders();
+    ok &= docs_gen_test::test_model_export();
+    ok &= docs_gen_test::test_search_index();
+    ok &= docs_gen_test::test_seeded_resource_header();
+    ok &= docs_gen_test::test_query_server();
+    ok &= docs_gen_test::test_binary_resources();
+    ok &= docs_gen_test::test_archive_sources();
+    ok &= docs_gen_test::test_stage_channel();
+    ok &= docs_gen_test::test_concurrent_registry();
+    ok &= docs_gen_test::test_entry_loading();
+    return ok ? 0 : 1;
+}
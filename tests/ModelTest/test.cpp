@@ -0,0 +1,1435 @@
+#include "test.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../core/archive_output.hpp"
+#include "../core/dependency_graph.hpp"
+#include "../core/dir.hpp"
+#include "../core/doc_output.hpp"
+#include "../core/file.hpp"
+#include "../core/instance_tree.hpp"
+#include "../core/lexer.hpp"
+#include "../core/model_export.hpp"
+#include "../core/project.hpp"
+#include "../core/project_settings.hpp"
+#include "../core/project_view.hpp"
+#include "../core/query_server.hpp"
+#include "../core/reachability.hpp"
+#include "../core/registry.hpp"
+#include "../core/rsrc_parser.hpp"
+#include "../core/scheduler.hpp"
+#include "../core/search_index.hpp"
+#include "../core/parse_cache.hpp"
+#include "../core/pipeline.hpp"
+#include "../core/util/flat_map.hpp"
+#include "../core/util/util.hpp"
+#include "../core/vfs.hpp"
+
+namespace docs_gen_test {
+
+    using namespace docs_gen_core;
+
+    namespace {
+
+        bool report(const char* name, bool ok) {
+            std::cout << name << ": " << (ok ? "OK" : "FAILED") << '\n';
+            return ok;
+        }
+
+        resource_file::resource make_resource(const std::wstring& type, std::size_t fields) {
+            resource_file::resource r;
+            r.type = type;
+            for (std::size_t i = 0; i < fields; ++i) {
+                r.fields.push_back({ L"field_with_a_long_name_" + std::to_wstring(i), L"value_that_does_not_fit_sso" });
+            }
+            return r;
+        }
+
+        scene_file make_scene(std::size_t nodes) {
+            scene_file f{ L"scenes/main.tscn" };
+            f.set_uid(L"cmain000001");
+            f.push_packed_scene(L"1_en", scene_handle{ 1 });
+            f.push_script(L"2_pl", script_handle{ 0 });
+            f.push_ext_resource_other(L"3_tx", { L"Texture2D", L"res://icon.svg" });
+
+            auto& tree = f.get_node_tree();
+            tree.insert(L"Main", L"Node2D");
+            for (std::size_t i = 0; i < nodes; ++i) {
+                tree.insert(L"Child" + std::to_wstring(i), L"Node", L".");
+            }
+            return f;
+        }
+
+        void write_file(const std::filesystem::path& path, std::string_view contents) {
+            std::filesystem::create_directories(path.parent_path());
+            std::ofstream{ path, std::ios::binary }.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        }
+
+        // Little endian fields for hand-built binary resources and archives
+        struct byte_writer {
+            std::string out;
+
+            void u8(std::uint8_t v) { out.push_back(static_cast<char>(v)); }
+            void u16(std::uint16_t v) { u8(static_cast<std::uint8_t>(v)); u8(static_cast<std::uint8_t>(v >> 8)); }
+            void u32(std::uint32_t v) { u16(static_cast<std::uint16_t>(v)); u16(static_cast<std::uint16_t>(v >> 16)); }
+            void u64(std::uint64_t v) { u32(static_cast<std::uint32_t>(v)); u32(static_cast<std::uint32_t>(v >> 32)); }
+            void bytes(std::string_view s) { out.append(s); }
+            // RSRC strings: length with the terminating zero, then the characters and the zero
+            void str(std::string_view s) {
+                u32(static_cast<std::uint32_t>(s.size() + 1));
+                out.append(s);
+                out.push_back('\0');
+            }
+            void patch_u64(std::size_t at, std::uint64_t v) {
+                for (int i = 0; i < 8; ++i) out[at + i] = static_cast<char>(v >> (i * 8));
+            }
+        };
+
+        // An RSRC file with uids and one internal resource, body writes the resource's properties
+        template <typename Body>
+        std::string rsrc_file(std::string_view type, std::uint64_t uid, std::string_view script_class,
+            const std::vector<std::string_view>& strings, const std::vector<std::pair<std::string_view, std::string_view>>& ext_resources,
+            Body&& body) {
+            byte_writer w;
+            w.bytes("RSRC");
+            w.u32(0); // little endian
+            w.u32(0); // 32 bit reals
+            w.u32(4);
+            w.u32(3);
+            w.u32(5); // format
+            w.str(type);
+            w.u64(0); // import metadata
+            w.u32(script_class.empty() ? 2 : 2 | 8); // uids, script class
+            w.u64(uid);
+            if (!script_class.empty()) w.str(script_class);
+            for (int i = 0; i < 11; ++i) w.u32(0);
+
+            w.u32(static_cast<std::uint32_t>(strings.size()));
+            for (const auto s : strings) w.str(s);
+            w.u32(static_cast<std::uint32_t>(ext_resources.size()));
+            std::uint64_t ext_uid = 7;
+            for (const auto& [ext_type, path] : ext_resources) {
+                w.str(ext_type);
+                w.str(path);
+                w.u64(ext_type == "Script" ? ~0ull : ext_uid++);
+            }
+            w.u32(1);
+            w.str("local://1");
+            const auto offset_at = w.out.size();
+            w.u64(0);
+
+            w.patch_u64(offset_at, w.out.size());
+            w.str(type);
+            body(w);
+            return w.out;
+        }
+
+        // .godot/uid_cache.bin: entry count, then uid, path length and "res://" path per entry
+        std::string uid_cache(const std::vector<std::pair<std::uint64_t, std::string>>& entries) {
+            std::string out;
+            const auto u32 = [&](std::uint32_t v) {
+                for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>(v >> (i * 8)));
+            };
+            u32(static_cast<std::uint32_t>(entries.size()));
+            for (const auto& [uid, path] : entries) {
+                u32(static_cast<std::uint32_t>(uid));
+                u32(static_cast<std::uint32_t>(uid >> 32));
+                u32(static_cast<std::uint32_t>(path.size()));
+                out += path;
+            }
+            return out;
+        }
+
+        // main.tscn uses player.gd and instances enemy.tscn, which uses enemy.gd and stats.tres.
+        // lonely.tscn, unused.gd and orphan.tres are not reachable from main
+        void write_sample_project(const std::filesystem::path& root) {
+            write_file(root / "project.godot", "config_version=5\n\n[application]\n\nrun/main_scene=\"res://scenes/main.tscn\"\n");
+            write_file(root / "scenes" / "main.tscn", "[gd_scene load_steps=3 format=3 uid=\"uid://cmain\"]\n\n"
+                "[ext_resource type=\"Script\" path=\"res://scripts/player.gd\" id=\"1_p\"]\n"
+                "[ext_resource type=\"PackedScene\" uid=\"uid://cenemy\" path=\"res://scenes/enemy.tscn\" id=\"2_e\"]\n\n"
+                "[node name=\"Main\" type=\"Node2D\"]\n\n"
+                "[node name=\"Player\" type=\"CharacterBody2D\" parent=\".\"]\nscript = ExtResource(\"1_p\")\n\n"
+                "[node name=\"Enemy\" parent=\".\" instance=ExtResource(\"2_e\")]\n");
+            write_file(root / "scenes" / "enemy.tscn", "[gd_scene load_steps=3 format=3 uid=\"uid://cenemy\"]\n\n"
+                "[ext_resource type=\"Script\" path=\"res://scripts/enemy.gd\" id=\"1_e\"]\n"
+                "[ext_resource type=\"Resource\" uid=\"uid://cstats\" path=\"res://res/stats.tres\" id=\"2_s\"]\n\n"
+                "[node name=\"Enemy\" type=\"Node2D\"]\nscript = ExtResource(\"1_e\")\nstats = ExtResource(\"2_s\")\n\n"
+                "[node name=\"Sprite\" type=\"Sprite2D\" parent=\".\"]\n");
+            write_file(root / "scenes" / "lonely.tscn", "[gd_scene format=3 uid=\"uid://clonely\"]\n\n[node name=\"Lonely\" type=\"Node\"]\n");
+            write_file(root / "res" / "stats.tres", "[gd_resource type=\"Resource\" script_class=\"Stats\" format=3 uid=\"uid://cstats\"]\n\n"
+                "[resource]\nhp = 100\n");
+            write_file(root / "res" / "orphan.tres", "[gd_resource type=\"Resource\" format=3 uid=\"uid://corphan\"]\n\n[resource]\n");
+            write_file(root / "scripts" / "player.gd", "class_name Player\nextends CharacterBody2D\n\nfunc jump() -> void:\n\tpass\n");
+            write_file(root / "scripts" / "enemy.gd", "class_name Enemy\nextends Node2D\n");
+            write_file(root / "scripts" / "unused.gd", "extends Node\n");
+        }
+
+        std::size_t count_nodes(const node_tree& tree) {
+            std::size_t count = 0;
+            for (auto it = tree.begin(); it != tree.end(); ++it) {
+                ++count;
+            }
+            return count;
+        }
+
+    } // anonymous
+
+    bool test_move_keeps_members() {
+        auto scene = make_scene(8);
+        const scene_file moved_scene{ std::move(scene) };
+
+        resource_file res{ L"res/stats.tres" };
+        res.set_uid(L"cstats00001");
+        res.push_ext_resource_other(L"1_tx", { L"Texture2D", L"res://icon.svg" });
+        res.push_sub_resource(L"sub_1", make_resource(L"Curve", 2));
+        res.set_resource(make_resource(L"Resource", 3));
+        const resource_file moved_res{ std::move(res) };
+
+        script_file script{ L"scripts/player.gd" };
+        script_class sc{};
+        sc.name = L"Player";
+        sc.parent = L"CharacterBody2D";
+        script.set_script_class(std::move(sc));
+        const script_file moved_script{ std::move(script) };
+
+        const bool ok = moved_scene.get_uid() == L"cmain000001"
+            && moved_scene.get_packed_scenes().size() == 1
+            && moved_scene.get_scripts().size() == 1
+            && moved_scene.get_ext_resource_other().size() == 1
+            && count_nodes(moved_scene.get_node_tree()) == 9
+            && moved_res.get_uid() == L"cstats00001"
+            && moved_res.get_ext_resource_other().size() == 1
+            && moved_res.get_sub_resources().size() == 1
+            && moved_res.find_sub_resource(L"sub_1") == 0
+            && moved_res.get_resource().type == L"Resource"
+            && moved_res.get_resource().fields.size() == 3
+            && moved_script.get_script_class().name == L"Player"
+            && moved_script.get_script_class().parent == L"CharacterBody2D";
+        return report("move keeps members", ok);
+    }
+
+    bool test_move_does_not_allocate() {
+        auto scene = make_scene(64);
+        resource_file res{ L"res/stats.tres" };
+        res.push_sub_resource(L"sub_1", make_resource(L"Curve", 16));
+        res.set_resource(make_resource(L"Resource", 16));
+
+        const auto before = allocations.load();
+        scene_file moved_scene{ std::move(scene) };
+        resource_file moved_res{ std::move(res) };
+        const auto count = allocations.load() - before;
+
+        std::cout << "moving a scene and a resource: " << count << " allocations\n";
+        return report("move does not allocate", count == 0);
+    }
+
+    bool test_sub_resource_is_not_copied() {
+        // a copied record allocates once per field, a moved one costs the same no matter its size
+        resource_file res{ L"res/stats.tres" };
+        res.push_sub_resource(L"warm_up", make_resource(L"Curve", 1));
+
+        auto small = make_resource(L"Curve", 1);
+        auto large = make_resource(L"Curve", 256);
+
+        auto before = allocations.load();
+        res.push_sub_resource(L"small", std::move(small));
+        const auto small_count = allocations.load() - before;
+
+        before = allocations.load();
+        res.push_sub_resource(L"large", std::move(large));
+        const auto large_count = allocations.load() - before;
+
+        auto root = make_resource(L"Resource", 256);
+        before = allocations.load();
+        res.set_resource(std::move(root));
+        const auto set_count = allocations.load() - before;
+
+        std::cout << "push_sub_resource: " << small_count << " allocations with 1 field, "
+            << large_count << " with 256 fields\n";
+        return report("sub resource is not copied", large_count == small_count && set_count == 0);
+    }
+
+    bool test_project_growth() {
+        // no reserve, so the arrays reallocate and every file is moved several times
+        project p;
+        constexpr std::uint32_t count = 100;
+        for (std::uint32_t i = 0; i < count; ++i) {
+            const auto h = p.add_script(L"scripts/s" + std::to_wstring(i) + L".gd");
+            script_class sc{};
+            sc.name = L"Script" + std::to_wstring(i);
+            p.get(h).set_script_class(std::move(sc));
+
+            const auto r = p.add_resource(L"res/r" + std::to_wstring(i) + L".tres");
+            p.get(r).set_resource(make_resource(L"Resource", 2));
+        }
+
+        bool ok = p.get_scripts().size() == count && p.get_resources().size() == count;
+        for (std::uint32_t i = 0; ok && i < count; ++i) {
+            ok = p.get(script_handle{ i }).get_script_class().name == L"Script" + std::to_wstring(i)
+                && p.get(resource_handle{ i }).get_resource().fields.size() == 2
+                && p.find_script(project::script_key(L"scripts/s" + std::to_wstring(i) + L".gd")) == script_handle{ i };
+        }
+        return report("project growth keeps files", ok);
+    }
+
+    bool test_flat_map_matches_unordered_map() {
+        // random inserts, overwrites and erases over a small key space so tombstones and rehashes happen
+        util::flat_map<std::wstring, int> map;
+        std::unordered_map<std::wstring, int> expected;
+        std::mt19937 rng{ 42 };
+        std::uniform_int_distribution<int> key_dist{ 0, 499 };
+        std::uniform_int_distribution<int> op_dist{ 0, 3 };
+
+        bool ok = true;
+        for (int i = 0; ok && i < 20000; ++i) {
+            const auto key = L"uid://c" + std::to_wstring(key_dist(rng));
+            switch (op_dist(rng)) {
+            case 0:
+                ok = map.erase(key) == expected.erase(key);
+                break;
+            case 1:
+                map[key] = i;
+                expected[key] = i;
+                break;
+            default: {
+                const auto it = map.find(std::wstring_view{ key });
+                const auto e = expected.find(key);
+                ok = (it == map.end()) == (e == expected.end()) && (it == map.end() || it->second == e->second);
+                map.try_emplace(key, i);
+                expected.try_emplace(key, i);
+                break;
+            }
+            }
+        }
+
+        std::size_t visited = 0;
+        for (const auto& [key, value] : map) {
+            const auto e = expected.find(key);
+            ok = ok && e != expected.end() && e->second == value;
+            ++visited;
+        }
+        ok = ok && visited == expected.size() && map.size() == expected.size();
+
+        // scenes hash by uid through the same string hash, every uid gets its own value
+        std::vector<std::size_t> hashes;
+        for (int i = 0; i < 64; ++i) {
+            scene_file f{ L"scenes/s" + std::to_wstring(i) + L".tscn" };
+            f.set_uid(L"c" + std::to_wstring(i));
+            hashes.push_back(scene_file_hash{}(f));
+        }
+        const bool first_ok = hashes[0] == util::string_hash{}(std::wstring{ L"c0" });
+        std::sort(hashes.begin(), hashes.end());
+        ok = ok && first_ok && std::adjacent_find(hashes.begin(), hashes.end()) == hashes.end();
+        return report("flat_map matches unordered_map", ok);
+    }
+
+    bool test_flat_map_allocations() {
+        constexpr std::size_t count = 1000;
+        std::vector<std::wstring> keys;
+        for (std::size_t i = 0; i < count; ++i) {
+            keys.push_back(L"res://scenes/level_" + std::to_wstring(i) + L".tscn");
+        }
+
+        util::flat_map<std::wstring, scene_handle> map;
+        map.reserve(count);
+        const auto before = allocations.load();
+        for (std::uint32_t i = 0; i < count; ++i) {
+            map.try_emplace(std::move(keys[i]), scene_handle{ i });
+        }
+        const auto insert_count = allocations.load() - before;
+
+        bool found = true;
+        for (std::uint32_t i = 0; found && i < count; ++i) {
+            const auto it = map.find(L"res://scenes/level_" + std::to_wstring(i) + L".tscn");
+            found = it != map.end() && it->second == scene_handle{ i };
+        }
+
+        std::cout << "flat_map: " << insert_count << " allocations for " << count << " reserved inserts\n";
+        return report("flat_map does not allocate per element", insert_count == 0 && found);
+    }
+
+    bool test_instance_expansion() {
+        // level i instances level i + 1 twice, so the flattened tree doubles per level while the
+        // expansion stays one entry per own node. The last level instances the first one again
+        constexpr std::uint32_t levels = 40;
+        project p;
+        p.reserve(levels, 0, 0);
+        for (std::uint32_t i = 0; i < levels; ++i) {
+            p.add_scene(L"scenes/level" + std::to_wstring(i) + L".tscn");
+        }
+        for (std::uint32_t i = 0; i < levels; ++i) {
+            auto& tree = p.get(scene_handle{ i }).get_node_tree();
+            tree.insert(L"Root", L"Node2D");
+            for (const auto* name : { L"A", L"B" }) {
+                auto it = tree.insert(name, L"PackedScene", L".");
+                (*it)->instance = scene_handle{ (i + 1) % levels };
+            }
+        }
+
+        instance_expander expander{ p };
+        const auto before = allocations.load();
+        const auto& root = expander.expand(scene_handle{ 0 });
+        const auto count = allocations.load() - before;
+
+        std::size_t visited = 0;
+        std::size_t max_depth = 0;
+        instance_expander::visit(*expander.find(scene_handle{ levels - 4 }), [&](const node_tree::tree_node&, std::size_t depth) {
+            ++visited;
+            max_depth = depth > max_depth ? depth : max_depth;
+        });
+
+        // the last level closes the cycle with both of its instances and keeps its 3 own nodes,
+        // every level above it is 1 + 2 * the level below: 2^(levels + 1 - i) - 1
+        const auto flattened = [&](std::uint32_t level) { return (std::uint64_t{ 1 } << (levels + 1 - level)) - 1; };
+        std::cout << "expanding " << levels << " levels: " << count << " allocations, "
+            << root.flattened_size << " flattened nodes, " << expander.get_cycle_count() << " cycles cut\n";
+        const bool ok = expander.get_cycle_count() == 2
+            && root.flattened_size == flattened(0)
+            && expander.find(scene_handle{ levels - 1 })->flattened_size == 3
+            && count < 16 * levels
+            && visited == flattened(levels - 4) && max_depth == 5;
+        return report("instance expansion is linear and cuts cycles", ok);
+    }
+
+    bool test_instanced_root() {
+        // main instances enemy twice, once overriding the script the enemy's root sets
+        project p;
+        p.reserve(2, 0, 2);
+        const auto main = p.add_scene(L"scenes/main.tscn");
+        const auto enemy = p.add_scene(L"scenes/enemy.tscn");
+        const auto enemy_script = p.add_script(L"scripts/enemy.gd");
+        const auto boss_script = p.add_script(L"scripts/boss.gd");
+
+        auto& enemy_tree = p.get(enemy).get_node_tree();
+        auto root = enemy_tree.insert(L"Enemy", L"CharacterBody2D");
+        (*root)->ext_resource_fields.emplace_back(L"script", enemy_script);
+        enemy_tree.insert(L"Sprite", L"Sprite2D", L".");
+
+        auto& main_tree = p.get(main).get_node_tree();
+        main_tree.insert(L"Main", L"Node2D");
+        auto grunt = main_tree.insert(L"Grunt", L"PackedScene", L".");
+        (*grunt)->instance = enemy;
+        auto boss = main_tree.insert(L"Boss", L"PackedScene", L".");
+        (*boss)->instance = enemy;
+        (*boss)->ext_resource_fields.emplace_back(L"script", boss_script);
+
+        instance_expander expander{ p };
+        expander.expand(main);
+
+        std::wstring walk;
+        instance_expander::visit(*expander.find(main), [&](const node_tree::tree_node& node, std::size_t depth) {
+            walk += std::to_wstring(depth) + L' ' + node.name + L':' + node.type;
+            for (const auto& [field, ref] : node.ext_resource_fields) {
+                walk += L' ' + field + L'=' + p.get(ref)->get_path().filename().wstring();
+            }
+            walk += L'\n';
+        });
+
+        std::wstring plain;
+        instance_expander::visit(*expander.find(main), [&](const node_tree::tree_node& node, std::size_t) {
+            plain += node.name + L':' + std::to_wstring(node.ext_resource_fields.size()) + L'\n';
+        }, false);
+
+        const bool ok = walk == L"1 Main:Node2D\n"
+            L"2 Grunt:CharacterBody2D script=enemy.gd\n3 Sprite:Sprite2D\n"
+            L"2 Boss:CharacterBody2D script=boss.gd\n3 Sprite:Sprite2D\n"
+            && plain == L"Main:0\nGrunt:0\nSprite:0\nBoss:1\nSprite:0\n";
+        return report("instanced roots are merged into their instance nodes", ok);
+    }
+
+    bool test_dependency_graph() {
+        // a scene using one script twice and a resource, plus a long chain of scripts where each
+        // one extends the one before it
+        constexpr std::uint32_t chain = 100000;
+        project p;
+        p.reserve(1, 1, chain);
+        const auto scene = p.add_scene(L"scenes/main.tscn");
+        const auto res = p.add_resource(L"res/stats.tres");
+        for (std::uint32_t i = 0; i < chain; ++i) {
+            const auto h = p.add_script(L"scripts/s" + std::to_wstring(i) + L".gd");
+            script_class sc{};
+            sc.name = L"S" + std::to_wstring(i);
+            if (i > 0) sc.parent = L"S" + std::to_wstring(i - 1);
+            p.get_script_classes()[sc.name] = h;
+            p.get(h).set_script_class(std::move(sc));
+        }
+
+        auto& main = p.get(scene);
+        main.push_script(L"1", script_handle{ 0 });
+        main.push_ext_resource(L"2", res);
+        auto it = main.get_node_tree().insert(L"Main", L"Node");
+        (*it)->ext_resource_fields.emplace_back(L"script", script_handle{ 0 });
+        resource_file::resource r;
+        r.res_file_fields.push_back({ L"script", script_handle{ 0 } });
+        p.get(res).set_resource(std::move(r));
+
+        dependency_graph g;
+        const auto before = allocations.load();
+        g.build(p);
+        const auto count = allocations.load() - before;
+
+        const auto users = g.users_of(script_handle{ 0 });
+        const std::vector<std::uint32_t> first(users.begin(), users.end());
+        const bool ok = first.size() == 3
+            && g.ref_of(first[0]) == file_ref{ scene }
+            && g.ref_of(first[1]) == file_ref{ res }
+            && g.ref_of(first[2]) == file_ref{ script_handle{ 1 } }
+            && g.users_of(res).size() == 1
+            && g.users_of(scene).empty()
+            && g.users_of(script_handle{ chain - 1 }).empty()
+            && g.edge_count() == 3 + chain - 1
+            // a fixed number of buffers, nothing per edge or per file
+            && count <= 16;
+
+        std::cout << "dependency graph over " << g.size() << " files, " << g.edge_count() << " edges: "
+            << count << " allocations\n";
+        return report("dependency graph", ok);
+    }
+
+    bool test_reachability() {
+        project_settings settings;
+        const bool parsed = project_settings::parse(
+            "config_version=5\n\n[application]\n\nconfig/name=\"Demo\"\nrun/main_scene=\"res://scenes/main.tscn\"\n\n"
+            "[autoload]\n\nGlobals=\"*res://scripts/globals.gd\"\nSave=\"res://scripts/save.gd\"\n", settings);
+        const bool settings_ok = parsed && settings.main_scene == L"scenes/main.tscn" && settings.autoloads.size() == 2
+            && settings.autoloads[0] == L"scripts/globals.gd" && settings.autoloads[1] == L"scripts/save.gd";
+
+        // scripts extend the one before them, so starting at the middle reaches the first half
+        constexpr std::uint32_t chain = 100000;
+        project p;
+        p.reserve(0, 0, chain);
+        for (std::uint32_t i = 0; i < chain; ++i) {
+            const auto h = p.add_script(L"scripts/s" + std::to_wstring(i) + L".gd");
+            script_class sc{};
+            sc.name = L"S" + std::to_wstring(i);
+            if (i > 0) sc.parent = L"S" + std::to_wstring(i - 1);
+            p.get_script_classes()[sc.name] = h;
+            p.get(h).set_script_class(std::move(sc));
+        }
+        dependency_graph g;
+        g.build(p);
+
+        reachability reach{ g };
+        reach.run({ chain / 2 - 1 });
+        std::uint32_t unreached = 0;
+        bool order_ok = true;
+        reach.for_each_unreached([&](std::uint32_t id) {
+            order_ok &= id == chain / 2 + unreached;
+            ++unreached;
+        });
+        const bool half_ok = reach.get_reached_count() == chain / 2 && unreached == chain / 2 && order_ok
+            && reach.is_reached(0) && !reach.is_reached(chain - 1);
+
+        // a second run only walks what is new
+        reach.run({ chain - 1, chain });
+        const bool all_ok = reach.get_reached_count() == chain && reach.is_reached(chain / 2);
+
+        std::cout << "reachability over " << chain << " scripts: " << reach.get_reached_count() << " reached\n";
+        return report("reachability", settings_ok && half_ok && all_ok);
+    }
+
+    bool test_project_view() {
+        project p;
+        const auto main = p.add_scene(L"scenes/main.tscn");
+        const auto enemy = p.add_scene(L"scenes/enemy.tscn");
+        const auto player = p.add_script(L"scripts/player.gd");
+        p.get(main).set_uid(L"cmain");
+        p.get_scene_uids()[L"cmain"] = main;
+        script_class sc{};
+        sc.name = L"Player";
+        p.get(player).set_script_class(std::move(sc));
+        p.get_script_classes()[L"Player"] = player;
+
+        auto& tree = p.get(main).get_node_tree();
+        tree.insert(L"Main", L"Node2D");
+        auto it = tree.insert(L"Player", L"CharacterBody2D", L".");
+        (*it)->ext_resource_fields.emplace_back(L"script", player);
+        tree.insert(L"Shape", L"CollisionShape2D", L"Player");
+        it = tree.insert(L"Enemy", L"PackedScene", L".");
+        (*it)->instance = enemy;
+        p.get(main).push_packed_scene(L"1", enemy);
+
+        dependency_graph g;
+        g.build(p);
+        const project_view view{ p, g, L"" };
+
+        std::size_t files = 0;
+        view.for_each_file([&](file_ref, const file&) { ++files; });
+        const bool lookup_ok = files == 3 && view.size() == 3
+            && view.find(L"res://scenes/main.tscn") == file_ref{ main }
+            && view.find(L"scenes/enemy.tscn") == file_ref{ enemy }
+            && view.find(L"uid://cmain") == file_ref{ main }
+            && !view.find(L"res://scenes/none.tscn").valid()
+            && view.as_scene(player) == nullptr && view.as_script(player) == &view.scripts()[0]
+            && view.find_class(L"Player") == view.as_script(player) && view.find_class(L"Enemy") == nullptr
+            && view.res_path_of(enemy) == L"res://scenes/enemy.tscn";
+
+        // every node below Main, lookups with and without the root's name
+        const auto* root = project_view::find_node(*view.as_scene(main), L".");
+        const auto* shape = project_view::find_node(*view.as_scene(main), L"Player/Shape");
+        std::wstring walked;
+        if (root) {
+            project_view::visit_nodes(*root, [&](const node_tree::tree_node& n, std::size_t depth) {
+                walked += std::to_wstring(depth) + n.name;
+            });
+        }
+        const bool nodes_ok = root && shape && shape->name == L"Shape"
+            && project_view::find_node(*view.as_scene(main), L"Main/Player/Shape") == shape
+            && project_view::find_node(*view.as_scene(main), L"Player/None") == nullptr
+            && project_view::find_node(*view.as_scene(enemy), L".") == nullptr
+            && walked == L"0Main1Player2Shape1Enemy";
+
+        const auto users = view.users_of(player);
+        const bool links_ok = users.size() == 1 && view.ref_of(*users.begin()) == file_ref{ main }
+            && view.dependencies_of(main).size() == 2 && view.dependencies_of(file_ref{}).empty();
+
+        return report("project view", lookup_ok && nodes_ok && links_ok);
+    }
+
+    bool test_shared_pool() {
+        // several schedulers running at once on one pool, each must see all of its own tasks done
+        worker_pool pool{ 4 };
+        constexpr std::size_t runs = 8;
+        constexpr std::size_t tasks = 500;
+        std::vector<std::size_t> done(runs, 0);
+        std::vector<std::thread> threads;
+        for (std::size_t r = 0; r < runs; ++r) {
+            threads.emplace_back([&, r] {
+                std::vector<std::atomic<std::size_t>> counts(tasks);
+                std::vector<task_scheduler::task> batch;
+                for (std::size_t i = 0; i < tasks; ++i) {
+                    batch.push_back({ i % 7, [&counts, i] { ++counts[i]; } });
+                }
+                task_scheduler{ 0, &pool }.run(std::move(batch));
+                for (const auto& count : counts) {
+                    done[r] += count == 1 ? 1 : 0;
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        bool pool_ok = true;
+        for (const auto d : done) {
+            pool_ok = pool_ok && d == tasks;
+        }
+
+        // byte-identical scripts share one parsed class, a single changed byte does not
+        parse_cache cache;
+        script_class c{};
+        c.name = L"Vendored";
+        const auto k = parse_cache::key_of("class_name Vendored\nextends Node\n");
+        const bool miss_first = cache.find(k) == nullptr;
+        cache.insert(k, c);
+        const auto hit = cache.find(parse_cache::key_of("class_name Vendored\nextends Node\n"));
+        const bool cache_ok = miss_first && hit && hit->name == L"Vendored"
+            && cache.find(parse_cache::key_of("class_name Vendored\nextends Node2D\n")) == nullptr
+            && cache.get_hits() == 1 && cache.get_misses() == 2;
+
+        std::cout << runs << " concurrent runs of " << tasks << " tasks on " << pool.threads() << " threads\n";
+        return report("shared worker pool and script cache", pool_ok && cache_ok);
+    }
+
+    bool test_parse_cache_on_disk() {
+        const auto directory = std::filesystem::temp_directory_path() / "docs_gen_parse_cache_test";
+        std::filesystem::remove_all(directory);
+
+        // files are keyed by their SHA-256, checked for a tail of one and of two blocks
+        const auto hex = [](std::string_view data) {
+            std::string out;
+            for (const auto b : util::sha256(data)) {
+                char digits[3];
+                std::snprintf(digits, sizeof(digits), "%02x", b);
+                out += digits;
+            }
+            return out;
+        };
+        const bool digest_ok = hex("abc") == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"
+            && hex("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"
+            && hex(std::string(1000, 'x')) == "44f8354494a5ba03ba1792a8d3e9c534c47a9181980fde7a3f44b06ef2ae7c7f"
+            && parse_cache::key_of("abc").size == 3;
+
+        script_class c{};
+        c.name = L"Vendored";
+        c.parent = L"Node";
+        c.tags = { L"addon", L"n\u00e4me" };
+        c.categories.push_back({ L"Stats", { { L"health", L"int", L"hit points" } } });
+        c.functions.push_back({ L"hit", L"takes damage", { { L"amount", L"int", {} } }, L"void" });
+        const std::string_view script = "class_name Vendored\nextends Node\n";
+
+        const std::string_view scene = "[gd_scene format=3 uid=\"uid://c1\"]\n\n; comment\n[node name=\"Root\" type=\"Node\"]\nvalue = [ 1,\n 2 ]\nname = \"x\"\n";
+        dott_entries entries;
+        dott_lexer{ scene }.record(entries);
+
+        // a second cache on the same directory stands in for another process or a later run
+        bool written = false;
+        {
+            parse_cache writer;
+            written = writer.set_directory(directory);
+            writer.insert(parse_cache::key_of(script), c);
+            writer.insert(parse_cache::key_of(scene), entries);
+        }
+        parse_cache reader;
+        reader.set_directory(directory);
+        const auto cached = reader.find(parse_cache::key_of(script));
+        const bool script_ok = written && cached && cached->name == L"Vendored" && cached->parent == L"Node"
+            && cached->tags == c.tags && cached->categories.size() == 1
+            && cached->categories[0].variables[0].short_desc == L"hit points"
+            && cached->functions.size() == 1 && cached->functions[0].arguments[0].name == L"amount";
+
+        dott_entries loaded;
+        const bool found = reader.find(parse_cache::key_of(scene), loaded);
+        const bool entries_ok = found && entries.sections.size() == 2 && loaded.sections.size() == 2
+            && loaded.properties.size() == 2 && loaded.view(loaded.sections[1].heading) == "node name=\"Root\" type=\"Node\""
+            && loaded.view(loaded.properties[0].value) == "[ 1,\n 2 ]" && loaded.text == entries.text;
+
+        // a truncated file is a miss, not a crash, and is replaced on the next insert
+        for (const auto& f : std::filesystem::recursive_directory_iterator(directory)) {
+            if (f.path().extension() == ".d") {
+                std::filesystem::resize_file(f.path(), 30);
+            }
+        }
+        dott_entries truncated;
+        const bool corrupt_ok = !reader.find(parse_cache::key_of(scene), truncated) && truncated.sections.empty()
+            && !reader.find(parse_cache::key_of("other"), truncated)
+            && reader.get_hits() == 2 && reader.get_misses() == 2;
+
+        std::filesystem::remove_all(directory);
+        return report("parse cache on disk", digest_ok && script_ok && entries_ok && corrupt_ok);
+    }
+
+    bool test_doc_output_skips_unchanged() {
+        const auto root = std::filesystem::temp_directory_path() / "docs_gen_doc_output_test";
+        std::filesystem::remove_all(root);
+        const auto read = [](const std::filesystem::path& path) {
+            std::ifstream in{ path, std::ios::binary };
+            return std::string{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+        };
+
+        // first run, a file that is not ours is cleared as there is no manifest yet
+        std::filesystem::create_directories(root / "old");
+        std::ofstream{ root / "old" / "stale.md" } << "stale";
+        {
+            folder_output out{ root };
+            out.begin();
+            out.write(root / "a.md", "body a\n", "# Used by\n");
+            out.write(root / "sub" / "b.md", "body b\n", "# Used by\n");
+            out.write_body(root / "sub" / "c.md", "body c\n");
+            out.append_tail(root / "sub" / "c.md", "# Used by\n");
+            out.finish();
+        }
+        const bool first_ok = !std::filesystem::exists(root / "old") && read(root / "sub" / "c.md") == "body c\n# Used by\n";
+
+        // second run: a unchanged, b gone, c only gets a new tail, d is new
+        folder_output out{ root };
+        out.begin();
+        out.write(root / "a.md", "body a\n", "# Used by\n");
+        out.write_body(root / "sub" / "c.md", "body c\n");
+        out.append_tail(root / "sub" / "c.md", "# Used by\n- [a](a.md)\n");
+        out.write(root / "d.md", "body d\n");
+        out.finish();
+
+        const bool files_ok = read(root / "a.md") == "body a\n# Used by\n" && !std::filesystem::exists(root / "sub" / "b.md")
+            && read(root / "sub" / "c.md") == "body c\n# Used by\n- [a](a.md)\n" && read(root / "d.md") == "body d\n";
+        const bool changes_ok = out.get_changed() == std::vector<std::string>{ "d.md", "sub/c.md" }
+            && out.get_deleted() == std::vector<std::string>{ "sub/b.md" } && out.get_unchanged() == 1
+            && read(root / ".docs_gen" / "changes") == "changed\td.md\nchanged\tsub/c.md\ndeleted\tsub/b.md\n";
+
+        std::filesystem::remove_all(root);
+        return report("doc output skips unchanged docs", first_ok && files_ok && changes_ok);
+    }
+
+    bool test_bundle_round_trip() {
+        const auto root = std::filesystem::temp_directory_path() / "docs_gen_bundle_test" / "docs";
+        std::filesystem::remove_all(root.parent_path());
+        std::filesystem::create_directories(root.parent_path());
+        {
+            bundle_output out{ root };
+            out.begin();
+            out.write(root / "a.md", "body a\n", "# Used by\n");
+            out.write_body(root / "sub" / "b.md", "body b\n");
+            out.write(root / "c.md", "body c\n");
+            out.append_tail(root / "sub" / "b.md", "# Used by\n- [a](../a.md)\n");
+            // stored as "../escaped.md", like a forged bundle would
+            out.write(root.parent_path() / "escaped.md", "escaped\n");
+            out.finish();
+        }
+
+        const bundle_reader reader{ root.parent_path() / "docs.bundle" };
+        std::string a, b, missing;
+        const bool read_ok = reader.is_open() && reader.size() == 4 && reader.read("a.md", a) && a == "body a\n# Used by\n"
+            && reader.read("sub/b.md", b) && b == "body b\n# Used by\n- [a](../a.md)\n" && !reader.read("d.md", missing);
+
+        const auto extracted = root.parent_path() / "extracted";
+        bool extract_ok = reader.extract(extracted) == 3 && !std::filesystem::exists(root.parent_path() / "escaped.md");
+        if (extract_ok) {
+            std::ifstream file{ extracted / "sub" / "b.md", std::ios::binary };
+            extract_ok = std::string{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} } == b;
+        }
+
+        // a cut off bundle is refused
+        std::filesystem::resize_file(root.parent_path() / "docs.bundle", std::filesystem::file_size(root.parent_path() / "docs.bundle") - 4);
+        const bool truncated_ok = !bundle_reader{ root.parent_path() / "docs.bundle" }.is_open();
+
+        std::filesystem::remove_all(root.parent_path());
+        return report("bundle round trip", read_ok && extract_ok && truncated_ok);
+    }
+
+    bool test_tar_streaming() {
+        const auto root = std::filesystem::temp_directory_path() / "docs_gen_tar_test" / "docs";
+        std::filesystem::remove_all(root.parent_path());
+        std::filesystem::create_directories(root.parent_path());
+        bool spilled_ok = false;
+        {
+            tar_output out{ root };
+            out.begin();
+            out.write_body(root / "a.md", "body a\n");
+            out.write_body(root / "sub" / "b.md", "body b\n");
+            out.write(root / "c.md", "body c\n");
+            out.write_body(root / "d.md", "body d\n");
+            // bodies wait on disk, not in memory
+            spilled_ok = std::filesystem::exists(root.parent_path() / "docs.tar.bodies");
+            out.append_tail(root / "sub" / "b.md", "# Used by\n- [a](../a.md)\n");
+            out.append_tail(root / "a.md", "# Used by\n");
+            out.finish();
+        }
+
+        std::ifstream file{ root.parent_path() / "docs.tar", std::ios::binary };
+        const std::string tar{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+        std::vector<std::pair<std::string, std::string>> entries;
+        for (std::size_t pos = 0; pos + 512 <= tar.size() && tar[pos] != '\0';) {
+            const std::string name = tar.c_str() + pos;
+            const auto size = std::stoull(tar.substr(pos + 124, 11), nullptr, 8);
+            entries.emplace_back(name, tar.substr(pos + 512, size));
+            pos += 512 + (size + 511) / 512 * 512;
+        }
+        std::sort(entries.begin(), entries.end());
+        const bool entries_ok = entries == std::vector<std::pair<std::string, std::string>>{ { "a.md", "body a\n# Used by\n" },
+            { "c.md", "body c\n" }, { "d.md", "body d\n" }, { "sub/b.md", "body b\n# Used by\n- [a](../a.md)\n" } };
+        const bool cleaned_ok = !std::filesystem::exists(root.parent_path() / "docs.tar.bodies");
+
+        std::filesystem::remove_all(root.parent_path());
+        return report("tar streaming", spilled_ok && entries_ok && cleaned_ok);
+    }
+
+    bool test_create_folders() {
+        const auto root = std::filesystem::temp_directory_path() / "docs_gen_folders_test";
+        std::filesystem::remove_all(root);
+        std::filesystem::create_directories(root);
+
+        // siblings, a folder only reached through a deeper one, and a file directly below root
+        const std::vector<std::filesystem::path> paths{ root / "a" / "x.md", root / "a" / "y.md", root / "b" / "c" / "d" / "z.md",
+            root / "a" / "e" / "w.md", root / "top.md" };
+        const bool created_ok = create_folders(root, paths) == 0 && std::filesystem::is_directory(root / "a" / "e")
+            && std::filesystem::is_directory(root / "b" / "c" / "d");
+        // existing folders are fine
+        const bool again_ok = create_folders(root, paths) == 0;
+
+        std::filesystem::remove_all(root);
+        return report("create folders", created_ok && again_ok);
+    }
+
+    bool test_model_export() {
+        project p;
+        const auto main = p.add_scene(L"scenes/main.tscn");
+        const auto player = p.add_script(L"scripts/player.gd");
+        p.get(main).set_uid(L"cmain");
+        script_class sc{};
+        sc.name = L"Player";
+        sc.short_desc = L"Says \"hi\"\n\u00e9";
+        sc.functions.push_back({ L"jump", L"", {}, L"void" });
+        p.get(player).set_script_class(std::move(sc));
+
+        auto& tree = p.get(main).get_node_tree();
+        tree.insert(L"Main", L"Node2D");
+        auto it = tree.insert(L"Player", L"CharacterBody2D", L".");
+        (*it)->ext_resource_fields.emplace_back(L"script", player);
+        p.get(main).push_script(L"1", player);
+
+        dependency_graph g;
+        g.build(p);
+        const project_view view{ p, g, L"" };
+        const auto directory = std::filesystem::temp_directory_path() / "docs_gen_export_test";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        const auto read = [](const std::filesystem::path& path) {
+            std::ifstream in{ path, std::ios::binary };
+            return std::string{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+        };
+
+        const model_exporter exporter{ view };
+        const bool written_ok = exporter.write(directory / "model.jsonl", export_format::jsonl)
+            && exporter.write(directory / "model.bin", export_format::binary);
+        const auto jsonl = read(directory / "model.jsonl");
+        const bool json_ok = jsonl == R"({"kind":"project","format":1,"root":"","files":2,"scenes":1,"resources":0,"scripts":1})" "\n"
+            R"({"kind":"scene","id":0,"path":"res://scenes/main.tscn","uid":"cmain","ext_resources":[{"id":"1","file":1,"type":"","path":"res://scripts/player.gd"}],)"
+            R"("dependencies":[1],"nodes":[{"name":"Main","type":"Node2D","parent":null,"instance":null,"ext_fields":[],"sub_fields":[]},)"
+            R"({"name":"Player","type":"CharacterBody2D","parent":0,"instance":null,"ext_fields":[{"name":"script","file":1}],"sub_fields":[]}]})" "\n"
+            R"({"kind":"script","id":1,"path":"res://scripts/player.gd","dependencies":[],"class":{"name":"Player","parent":"","public":false,"tags":[],)"
+            R"("description":"Says \"hi\"\n)" "\xc3\xa9" R"(","exports":[],"functions":[{"name":"jump","description":"","arguments":[],"return_type":"void"}]}})" "\n";
+
+        // header, then the project record: kind, format, root, files, scenes, resources, scripts
+        const auto bin = read(directory / "model.bin");
+        const bool binary_ok = bin.compare(0, 8, std::string{ "GDPM\x01\0\0\0", 8 }) == 0
+            && bin.compare(8, 7, std::string{ "\0\x01\0\x02\x01\0\x01", 7 }) == 0 && bin.size() < jsonl.size();
+
+        std::filesystem::remove_all(directory);
+        return report("model export", written_ok && json_ok && binary_ok);
+    }
+
+    bool test_search_index() {
+        std::vector<std::string> tokens;
+        search_index::tokenize(L"take_damage HTTPRequest CharacterBody2D Enemy1 x", tokens);
+        const bool tokenize_ok = tokens == std::vector<std::string>{ "take_damage", "take", "damage", "httprequest", "http", "request",
+            "characterbody2d", "character", "body2d", "body", "2d", "enemy1", "enemy" };
+
+        project p;
+        const auto main = p.add_scene(L"scenes/main.tscn");
+        const auto player = p.add_script(L"scripts/player.gd");
+        script_class sc{};
+        sc.name = L"Player";
+        sc.parent = L"CharacterBody2D";
+        sc.tags = { L"controllable" };
+        sc.functions.push_back({ L"take_damage", L"", {}, L"void" });
+        sc.categories.push_back({ L"Stats", { { L"max_health", L"int", L"" } } });
+        p.get(player).set_script_class(std::move(sc));
+        auto& tree = p.get(main).get_node_tree();
+        tree.insert(L"Main", L"Node2D");
+        tree.insert(L"Player", L"CharacterBody2D", L".");
+
+        // filled in reverse as threads may finish in any order, pages come out sorted by path
+        search_index index{ 2 };
+        index.add(dependency_graph::id_of(p, player), "scripts/player.gd.md", p.get(player));
+        index.add(dependency_graph::id_of(p, main), "scenes/main.tscn.md", p.get(main));
+        const auto path = std::filesystem::temp_directory_path() / "docs_gen_search_index.json";
+        std::ofstream{ path, std::ios::binary } << index.to_json();
+
+        const search_index_reader reader{ path };
+        const auto names = [](const std::vector<search_index_reader::hit>& hits) {
+            std::string out;
+            for (const auto& hit : hits) {
+                out += *hit.path + ' ' + search_index_reader::field_names(hit.fields) + ';';
+            }
+            return out;
+        };
+        const bool lookup_ok = reader.is_open() && reader.size() == 2
+            && names(reader.find({ "player" })) == "scenes/main.tscn.md node;scripts/player.gd.md name,class;"
+            && names(reader.find({ "Damage" })) == "scripts/player.gd.md function;"
+            && names(reader.find({ "function:take*" })) == "scripts/player.gd.md function;"
+            && names(reader.find({ "variable:health", "tag:controllable" })) == "scripts/player.gd.md variable,tag;"
+            && names(reader.find({ "type:body2d" })) == "scenes/main.tscn.md type;"
+            && reader.find({ "player", "jump" }).empty() && reader.find({ "nofield:player" }).empty();
+
+        // a cut off index is refused
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+        const bool truncated_ok = !search_index_reader{ path }.is_open();
+
+        std::filesystem::remove(path);
+        return report("search index", tokenize_ok && lookup_ok && truncated_ok);
+    }
+
+    bool test_seeded_resource_header() {
+        // stats.tres gets its uid from the Godot cache, so its header is not parsed up front
+        const auto root = std::filesystem::temp_directory_path() / "docs_gen_seeded_test";
+        std::filesystem::remove_all(root);
+        const std::uint64_t uid = 0x1234567890abcdefULL;
+        const auto uid_text = util::to_string(rsrc_parser::uid_to_text(uid));
+        write_file(root / "project.godot", "config_version=5\n");
+        write_file(root / ".godot" / "uid_cache.bin", uid_cache({ { uid, "res://res/stats.tres" } }));
+        write_file(root / ".godot" / "global_script_class_cache.cfg", "list=[]\n");
+        write_file(root / "res" / "stats.tres", "[gd_resource type=\"Resource\" script_class=\"Stats\" format=3 uid=\"uid://"
+            + uid_text + "\"]\n\n[resource]\nhp = 100\n");
+
+        bool ok = false;
+        {
+            dir d;
+            if (d.set_path(root.wstring())) {
+                d.set_use_godot_cache(true);
+                d.construct_file_tree();
+                const auto& resources = d.get_project().get_resources();
+                ok = resources.size() == 1 && resources[0].get_uid() == util::to_wstring(uid_text)
+                    && resources[0].get_script_class() == L"Stats"
+                    && d.view().find(L"uid://" + util::to_wstring(uid_text)) == file_ref{ resource_handle{ 0 } };
+            }
+        }
+
+        std::filesystem::remove_all(root);
+        return report("seeded resources keep their header", ok);
+    }
+
+    bool test_query_server() {
+        const auto root = std::filesystem::temp_directory_path() / "docs_gen_query_test";
+        std::filesystem::remove_all(root);
+        write_sample_project(root);
+
+        bool answers_ok = false;
+        bool lines_ok = false;
+        {
+            dir d;
+            if (d.set_path(root.wstring())) {
+                d.construct_file_tree();
+                d.build_index();
+                query_server server{ d, root / "query.sock" };
+
+                answers_ok = server.answer("file res://scripts/player.gd")
+                        == "ok 4\nkind script\npath res://scripts/player.gd\nclass Player\nextends CharacterBody2D\n"
+                    && server.answer("file uid://cstats\r") == "ok 4\nkind resource\npath res://res/stats.tres\nuid uid://cstats\nclass Stats\n"
+                    && server.answer("users res://scenes/enemy.tscn") == "ok 1\nres://scenes/main.tscn\n"
+                    && server.answer("dependencies res://scenes/enemy.tscn") == "ok 2\nres://res/stats.tres\nres://scripts/enemy.gd\n"
+                    && server.answer("nodes res://scenes/main.tscn") == "ok 3\n0\tMain\tNode2D\n1\tPlayer\tCharacterBody2D\n"
+                        "1\tEnemy\tPackedScene\tres://scenes/enemy.tscn\n"
+                    && server.answer("nodes res://scenes/main.tscn Player") == "ok 1\n0\tPlayer\tCharacterBody2D\n"
+                    && server.answer("class Player") == "ok 3\npath res://scripts/player.gd\nextends CharacterBody2D\nfunc jump() -> void\n"
+                    && server.answer("class Nobody") == "error unknown class\n"
+                    && server.answer("file res://none.gd") == "error unknown file\n"
+                    && server.answer("nodes res://scripts/player.gd") == "error not a scene\n"
+                    && server.answer("nodes res://scenes/main.tscn Nobody") == "error unknown node\n"
+                    && server.answer("jump") == "error unknown command\n";
+
+                // pipelined lines are answered in order and a partial line waits for the rest
+                std::string pending = "class Nobody\njump\nclass Pla";
+                std::string out;
+                const bool partial_ok = server.answer_lines(pending, out) && pending == "class Pla"
+                    && out == "error unknown class\nerror unknown command\n";
+                pending += std::string(query_server::max_request_size, 'y');
+                out.clear();
+                lines_ok = partial_ok && !server.answer_lines(pending, out) && pending.empty() && out == "error request too long\n";
+            }
+        }
+
+        std::filesystem::remove_all(root);
+        return report("query server answers", answers_ok && lines_ok);
+    }
+
+    bool test_binary_resources() {
+        project p;
+        const auto enemy = p.add_scene(L"scenes/enemy.tscn");
+        const auto player = p.add_script(L"scripts/player.gd");
+        p.get(enemy).set_uid(rsrc_parser::uid_to_text(7));
+        p.get_scene_uids()[rsrc_parser::uid_to_text(7)] = enemy;
+
+        // Level (Node2D) with Player (CharacterBody2D, script = ext 0) and an instance of ext 1
+        const auto scene_file_with = [](const std::vector<std::int32_t>& nodes) {
+            return rsrc_file("PackedScene", 42, "", { "_bundled" },
+                { { "Script", "res://scripts/player.gd" }, { "PackedScene", "res://scenes/enemy.tscn" } },
+                [&](byte_writer& w) {
+                    w.u32(1);
+                    w.u32(0); // _bundled
+                    w.u32(26); // dictionary of 4 pairs
+                    w.u32(4);
+                    w.u32(5); w.str("names");
+                    w.u32(34);
+                    w.u32(6);
+                    for (const auto* name : { "Level", "Node2D", "Player", "CharacterBody2D", "script", "Enemy" }) w.str(name);
+                    w.u32(5); w.str("variants");
+                    w.u32(30);
+                    w.u32(2);
+                    for (std::uint32_t ext = 0; ext < 2; ++ext) {
+                        w.u32(24); // object, external resource by index
+                        w.u32(3);
+                        w.u32(ext);
+                    }
+                    w.u32(5); w.str("nodes");
+                    w.u32(32);
+                    w.u32(static_cast<std::uint32_t>(nodes.size()));
+                    for (const auto n : nodes) w.u32(static_cast<std::uint32_t>(n));
+                    w.u32(5); w.str("node_count");
+                    w.u32(3);
+                    w.u32(3);
+                });
+        };
+        // parent, owner, type, name, instance, properties (name, variant), groups
+        const std::vector<std::int32_t> nodes = {
+            -1, -1, 1, 0, -1, 0, 0,
+            0, 0, 3, 2, -1, 1, 4, 0, 0,
+            0, 0, 0x7FFFFFFF, 5, 1, 0, 0,
+        };
+
+        scene_file level{ L"scenes/level.scn" };
+        bool scene_ok = false;
+        {
+            rsrc_parser parser{ level, file_data::own(scene_file_with(nodes)) };
+            scene_ok = parser.parse_header(level) && parser.parse_contents(level, p) && level.get_uid() == rsrc_parser::uid_to_text(42);
+        }
+        std::wstring walked;
+        for (const auto& node : level.get_node_tree()) {
+            walked += std::to_wstring(node->depth) + node->name + L':' + node->type;
+            for (const auto& [field, ref] : node->ext_resource_fields) {
+                walked += L' ' + field + (ref == file_ref{ player } ? L"=player" : L"=?");
+            }
+            if (node->instance == enemy) walked += L" instance";
+            walked += L'\n';
+        }
+        scene_ok = scene_ok && walked == L"1Level:Node2D\n2Player:CharacterBody2D script=player\n2Enemy:PackedScene instance\n"
+            && level.get_packed_scenes().size() == 1;
+
+        resource_file stats{ L"res/stats.res" };
+        bool resource_ok = false;
+        {
+            rsrc_parser parser{ stats, file_data::own(rsrc_file("Resource", 43, "Stats", { "hp", "tags" }, {}, [](byte_writer& w) {
+                w.u32(2);
+                w.u32(0); // hp = 100
+                w.u32(3);
+                w.u32(100);
+                w.u32(1); // tags = ["a"]
+                w.u32(30);
+                w.u32(1);
+                w.u32(5);
+                w.str("a");
+            })) };
+            resource_ok = parser.parse_header(stats) && parser.parse_contents(stats, p);
+        }
+        const auto& fields = stats.get_resource().fields;
+        resource_ok = resource_ok && stats.get_uid() == rsrc_parser::uid_to_text(43) && stats.get_script_class() == L"Stats"
+            && fields.size() == 2 && fields[0].name == L"hp" && fields[0].value == L"100"
+            && fields[1].name == L"tags" && fields[1].value == L"[\"a\"]";
+
+        // cut off, compressed, nested without end and a child before its root are all refused
+        const auto full = scene_file_with(nodes);
+        const auto refused = [&](std::string buffer, bool header) {
+            scene_file f{ L"scenes/bad.scn" };
+            rsrc_parser parser{ f, file_data::own(std::move(buffer)) };
+            return header ? !parser.parse_header(f) : parser.parse_header(f) && !parser.parse_contents(f, p);
+        };
+        std::string compressed = full;
+        compressed.replace(0, 4, "RSCC");
+        std::vector<std::int32_t> orphan_first = nodes;
+        orphan_first[0] = 1 << 30; // parent given by path before any root exists
+        const bool corrupt_ok = refused(full.substr(0, 40), true) && refused(compressed, true)
+            && refused(full.substr(0, full.size() - 12), false)
+            && refused(scene_file_with(orphan_first), false)
+            && refused(rsrc_file("PackedScene", 42, "", { "_bundled" }, {}, [](byte_writer& w) {
+                w.u32(1);
+                w.u32(0);
+                for (int i = 0; i < 200000; ++i) {
+                    w.u32(30);
+                    w.u32(1);
+                }
+                w.u32(1);
+            }), false);
+
+        return report("binary resources", scene_ok && resource_ok && corrupt_ok);
+    }
+
+    bool test_archive_sources() {
+        const auto root = std::filesystem::temp_directory_path() / "docs_gen_archive_test";
+        std::filesystem::remove_all(root);
+        std::filesystem::create_directories(root);
+        const auto listed = [](const file_source& source) {
+            std::vector<file_source::entry> entries;
+            source.list({}, entries);
+            std::vector<std::string> names;
+            for (const auto& e : entries) {
+                names.push_back(e.path.lexically_relative(source.root()).generic_string());
+            }
+            std::sort(names.begin(), names.end());
+            return names;
+        };
+        const auto read = [](const file_source& source, const char* path, std::string& out) {
+            file_data data;
+            if (!source.read(source.root() / path, data)) return false;
+            out = std::string{ data.view() };
+            return true;
+        };
+
+        // raw deflate streams: the script below, and 1000 'x' that claim to be 100 bytes
+        const std::string script = "class_name A\nextends Node\n\nfunc a() -> void:\n\tpass\n";
+        const std::string deflated_script{ "\x4b\xce\x49\x2c\x2e\x8e\xcf\x4b\xcc\x4d\x55\x70\xe4\x4a\xad\x28\x49\xcd\x4b\x29\x56"
+            "\xf0\xcb\x4f\x49\xe5\xe2\x4a\x2b\xcd\x4b\x56\x48\xd4\xd0\x54\xd0\xb5\x53\x28\xcb\xcf\x4c\xb1\xe2\xe2\x2c\x00\x2a"
+            "\xe6\x02\x00", 52 };
+        const std::string deflated_xs{ "\xab\xa8\x18\x05\xa3\x60\x14\x0c\x77\x00\x00", 11 };
+        const std::string scene = "[gd_scene format=3 uid=\"uid://cmain\"]\n";
+
+        // the project sits in a subfolder, next to a file outside of it and names that try to leave it
+        struct zip_entry {
+            std::string name;
+            std::uint16_t method;
+            std::string data;
+            std::uint32_t size;
+        };
+        const std::vector<zip_entry> zip_entries = {
+            { "README.md", 0, "outside", 7 },
+            { "repo-main/project.godot", 0, "config_version=5\n", 16 },
+            { "repo-main/scenes/main.tscn", 0, scene, static_cast<std::uint32_t>(scene.size()) },
+            { "repo-main/scripts/a.gd", 8, deflated_script, static_cast<std::uint32_t>(script.size()) },
+            { "repo-main/scripts/bomb.gd", 8, deflated_xs, 100 },
+            { "repo-main/../evil.gd", 0, "evil", 4 },
+            { "repo-main//etc/evil.gd", 0, "evil", 4 },
+        };
+        byte_writer zip;
+        std::vector<std::uint32_t> local_offsets;
+        for (const auto& e : zip_entries) {
+            local_offsets.push_back(static_cast<std::uint32_t>(zip.out.size()));
+            zip.u32(0x04034b50);
+            zip.u16(20);
+            zip.u16(0);
+            zip.u16(e.method);
+            zip.u32(0); // time, date
+            zip.u32(0); // crc
+            zip.u32(static_cast<std::uint32_t>(e.data.size()));
+            zip.u32(e.size);
+            zip.u16(static_cast<std::uint16_t>(e.name.size()));
+            zip.u16(0);
+            zip.bytes(e.name);
+            zip.bytes(e.data);
+        }
+        const auto directory = static_cast<std::uint32_t>(zip.out.size());
+        for (std::size_t i = 0; i < zip_entries.size(); ++i) {
+            const auto& e = zip_entries[i];
+            zip.u32(0x02014b50);
+            zip.u16(20);
+            zip.u16(20);
+            zip.u16(0);
+            zip.u16(e.method);
+            zip.u32(0);
+            zip.u32(0);
+            zip.u32(static_cast<std::uint32_t>(e.data.size()));
+            zip.u32(e.size);
+            zip.u16(static_cast<std::uint16_t>(e.name.size()));
+            zip.u16(0); // extra
+            zip.u16(0); // comment
+            zip.u16(0); // disk
+            zip.u16(0); // internal attributes
+            zip.u32(0); // external attributes
+            zip.u32(local_offsets[i]);
+            zip.bytes(e.name);
+        }
+        const auto directory_size = static_cast<std::uint32_t>(zip.out.size()) - directory;
+        zip.u32(0x06054b50);
+        zip.u32(0);
+        zip.u16(static_cast<std::uint16_t>(zip_entries.size()));
+        zip.u16(static_cast<std::uint16_t>(zip_entries.size()));
+        zip.u32(directory_size);
+        zip.u32(directory);
+        zip.u16(0);
+        write_file(root / "project.zip", zip.out);
+
+        bool zip_ok = false;
+        {
+            const zip_source source{ root / "project.zip" };
+            std::string a, main, bomb;
+            zip_ok = source.is_open()
+                && listed(source) == std::vector<std::string>{ "project.godot", "scenes/main.tscn", "scripts/a.gd", "scripts/bomb.gd" }
+                && read(source, "scenes/main.tscn", main) && main == scene
+                && read(source, "scripts/a.gd", a) && a == script
+                && !read(source, "scripts/bomb.gd", bomb)
+                && !read(source, "../evil.gd", bomb);
+        }
+
+        // a version 2 pck with an exported scene behind its .remap and names that try to leave the project
+        const std::string remap = "[remap]\n\npath=\"res://.godot/exported/133200997/export-main.scn\"\n";
+        const std::vector<std::pair<std::string, std::string>> pck_entries = {
+            { "res://project.godot", "config_version=5\n" },
+            { "res://scenes/main.tscn.remap", remap },
+            { "res://.godot/exported/133200997/export-main.scn", "RSRC exported" },
+            { "res://../evil.gd", "evil" },
+            { "res:///etc/evil.gd", "evil" },
+        };
+        byte_writer pck;
+        pck.bytes("GDPC");
+        pck.u32(2); // version
+        pck.u32(4);
+        pck.u32(3);
+        pck.u32(0);
+        pck.u32(0); // flags
+        const auto base_at = pck.out.size();
+        pck.u64(0); // file base
+        for (int i = 0; i < 16; ++i) pck.u32(0);
+        pck.u32(static_cast<std::uint32_t>(pck_entries.size()));
+        std::uint64_t offset = 0;
+        for (const auto& [name, data] : pck_entries) {
+            pck.u32(static_cast<std::uint32_t>(name.size()));
+            pck.bytes(name);
+            pck.u64(offset);
+            pck.u64(data.size());
+            pck.bytes(std::string(16, '\0')); // md5
+            pck.u32(0);
+            offset += data.size();
+        }
+        pck.patch_u64(base_at, pck.out.size());
+        for (const auto& [name, data] : pck_entries) {
+            pck.bytes(data);
+        }
+        write_file(root / "export.pck", pck.out);
+
+        bool pck_ok = false;
+        {
+            const pck_source source{ root / "export.pck" };
+            std::string main;
+            pck_ok = source.is_open() && listed(source) == std::vector<std::string>{ "project.godot", "scenes/main.scn" }
+                && read(source, "scenes/main.scn", main) && main == "RSRC exported";
+        }
+
+        std::filesystem::remove_all(root);
+        return report("zip and pck sources", zip_ok && pck_ok);
+    }
+
+    bool test_stage_channel() {
+        constexpr std::size_t producers = 4;
+        constexpr std::size_t consumers = 3;
+        constexpr std::size_t per_producer = 5000;
+        constexpr std::size_t depth = 8;
+
+        // consumers start first and park on the empty queue, producers then overrun the depth
+        stage_channel<std::size_t> channel{ depth, producers };
+        std::vector<std::vector<std::size_t>> received(consumers);
+        std::vector<std::thread> threads;
+        for (std::size_t c = 0; c < consumers; ++c) {
+            threads.emplace_back([&channel, &received, c] {
+                std::chrono::nanoseconds starved{ 0 };
+                std::size_t item;
+                while (channel.pop(item, starved)) {
+                    received[c].push_back(item);
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        for (std::size_t p = 0; p < producers; ++p) {
+            threads.emplace_back([&channel, p] {
+                std::chrono::nanoseconds blocked{ 0 };
+                for (std::size_t i = 0; i < per_producer; ++i) {
+                    channel.push(p * per_producer + i, blocked);
+                }
+                channel.producer_done();
+            });
+        }
+        // every consumer returns once the last producer is done, or this never joins
+        for (auto& t : threads) t.join();
+
+        // each consumer sees every producer's items in the order they were pushed
+        bool fifo_ok = true;
+        std::vector<std::size_t> all;
+        for (const auto& items : received) {
+            std::vector<std::size_t> last(producers, 0);
+            std::vector<bool> seen(producers, false);
+            for (const auto item : items) {
+                const auto p = item / per_producer;
+                fifo_ok &= !seen[p] || item > last[p];
+                seen[p] = true;
+                last[p] = item;
+            }
+            all.insert(all.end(), items.begin(), items.end());
+        }
+        std::sort(all.begin(), all.end());
+        bool complete_ok = all.size() == producers * per_producer;
+        for (std::size_t i = 0; complete_ok && i < all.size(); ++i) {
+            complete_ok = all[i] == i;
+        }
+        const bool peak_ok = channel.peak() > 0 && channel.peak() <= depth;
+
+        // a channel whose producers finish without pushing ends its consumers right away
+        stage_channel<std::size_t> empty{ depth, 1 };
+        std::thread idle{ [&empty] {
+            std::chrono::nanoseconds starved{ 0 };
+            std::size_t item;
+            while (empty.pop(item, starved)) {}
+        } };
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        empty.producer_done();
+        idle.join();
+
+        return report("stage channel", fifo_ok && complete_ok && peak_ok);
+    }
+
+    bool test_concurrent_registry() {
+        using registry = concurrent_registry<int>;
+        std::vector<std::vector<int>> orders{ { 1, 2, 3 } };
+        while (true) {
+            auto next = orders.back();
+            if (!std::next_permutation(next.begin(), next.end())) break;
+            orders.push_back(next);
+        }
+
+        // three files claiming one uid, each parsed by its own thread, started in every order
+        // and with keys of their own so the shards fill up around it
+        bool kept_ok = true;
+        std::vector<std::vector<registry::duplicate>> runs;
+        for (int round = 0; round < 60; ++round) {
+            const auto& order = orders[round % orders.size()];
+            registry r{ 4 };
+            std::vector<std::thread> threads;
+            for (const int handle : order) {
+                threads.emplace_back([&r, handle] {
+                    for (int i = 0; i < 20; ++i) {
+                        r.insert(L"uid://" + std::to_wstring(handle) + L"_" + std::to_wstring(i), handle);
+                    }
+                    r.insert(L"uid://shared", handle);
+                });
+            }
+            for (auto& t : threads) t.join();
+
+            registry::table_type table;
+            std::vector<registry::duplicate> duplicates;
+            r.freeze(table, duplicates);
+            kept_ok &= table.size() == order.size() * 20 + 1 && table[L"uid://shared"] == 1;
+            runs.push_back(std::move(duplicates));
+        }
+
+        const auto same = [](const registry::duplicate& a, const registry::duplicate& b) {
+            return a.key == b.key && a.kept == b.kept && a.dropped == b.dropped;
+        };
+        const auto& first = runs.front();
+        bool duplicates_ok = first.size() == 2 && first[0].key == L"uid://shared" && first[0].kept == 1 && first[0].dropped == 2
+            && first[1].key == L"uid://shared" && first[1].kept == 1 && first[1].dropped == 3;
+        for (const auto& run : runs) {
+            duplicates_ok &= std::equal(run.begin(), run.end(), first.begin(), first.end(), same);
+        }
+
+        return report("concurrent registry", kept_ok && duplicates_ok);
+    }
+
+    bool test_entry_loading() {
+        const auto root = std::filesystem::temp_directory_path() / "docs_gen_entry_test";
+        std::filesystem::remove_all(root);
+        write_sample_project(root);
+
+        // docs written when starting from entry, and whether the unreachable scene stayed unparsed
+        const auto load = [&root](const wchar_t* entry, bool& lonely_parsed) {
+            std::filesystem::remove_all(root / "docs");
+            std::vector<std::string> docs;
+            dir d;
+            if (!d.set_path(root.wstring()))
+                return docs;
+            d.set_docs_path((root / "docs").wstring());
+            d.set_search_index(false);
+            d.push_entry(entry);
+            d.construct_file_tree();
+            d.gen_docs();
+
+            const auto lonely = d.view().find(L"res://scenes/lonely.tscn");
+            lonely_parsed = lonely.kind != file_kind::scene || d.get_project().get(scene_handle{ lonely.index }).get_node_tree().get_root();
+            for (const auto& e : std::filesystem::recursive_directory_iterator(root / "docs")) {
+                if (e.path().extension() == ".md") {
+                    docs.push_back(e.path().lexically_relative(root / "docs").generic_string());
+                }
+            }
+            std::sort(docs.begin(), docs.end());
+            return docs;
+        };
+
+        bool main_lonely = true;
+        const auto from_main = load(L"res://scenes/main.tscn", main_lonely);
+        const bool main_ok = !main_lonely && from_main == std::vector<std::string>{ "res/stats.tres.md", "scenes/enemy.tscn.md",
+            "scenes/main.tscn.md", "scripts/enemy.gd.md", "scripts/player.gd.md" };
+
+        // a uid entry resolves like its path, and only leads down from there
+        bool enemy_lonely = true;
+        const auto from_enemy = load(L"uid://cenemy", enemy_lonely);
+        const bool uid_ok = !enemy_lonely && from_enemy == std::vector<std::string>{ "res/stats.tres.md", "scenes/enemy.tscn.md",
+            "scripts/enemy.gd.md" };
+
+        std::filesystem::remove_all(root);
+        return report("entry loading", main_ok && uid_ok);
+    }
+
+} // docs_gen_test
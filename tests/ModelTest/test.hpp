@@ -0,0 +1,42 @@
+#ifndef DOCS_GEN_TEST_MODEL_H
+#define DOCS_GEN_TEST_MODEL_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace docs_gen_test {
+
+    // Calls to the global operator new so far, replaced in allocations.cpp
+    extern std::atomic<std::size_t> allocations;
+
+    // Each test prints what it measured and returns false if the model copied something
+    bool test_move_keeps_members();
+    bool test_move_does_not_allocate();
+    bool test_sub_resource_is_not_copied();
+    bool test_project_growth();
+    bool test_flat_map_matches_unordered_map();
+    bool test_flat_map_allocations();
+    bool test_instance_expansion();
+    bool test_instanced_root();
+    bool test_dependency_graph();
+    bool test_reachability();
+    bool test_project_view();
+    bool test_shared_pool();
+    bool test_parse_cache_on_disk();
+    bool test_doc_output_skips_unchanged();
+    bool test_bundle_round_trip();
+    bool test_tar_streaming();
+    bool test_create_folders();
+    bool test_model_export();
+    bool test_search_index();
+    bool test_seeded_resource_header();
+    bool test_query_server();
+    bool test_binary_resources();
+    bool test_archive_sources();
+    bool test_stage_channel();
+    bool test_concurrent_registry();
+    bool test_entry_loading();
+
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_MODEL_H
@@ -20,6 +20,10 @@ project "NodeTreeTest"
         defines { "WIN" }
     filter {}
 
+    filter { "system:linux" }
+        links { "pthread" }
+    filter {}
+
     filter { "configurations:Debug" }
         defines { "DEBUG" }
         symbols "On"
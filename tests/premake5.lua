@@ -1 +1,3 @@
-include "NodeTreeTest"
\ No newline at end of file
+include "NodeTreeTest"
+include "LexerTest"
+include "ModelTest"
\ No newline at end of file